@@ -0,0 +1,45 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Custom assertion that works in both Debug and Release builds
+#define TEST_ASSERT(condition) \
+	do { \
+		if (!(condition)) { \
+			std::ostringstream oss; \
+			oss << "Test assertion failed: " << #condition \
+			    << " at " << __FILE__ << ":" << __LINE__; \
+			throw std::runtime_error(oss.str()); \
+		} \
+	} while (0)
+
+namespace baseLib
+{
+	// Runs all tests in order, a test fails by throwing. Returns the exit code for the main() of a test executable
+	template<typename... Tests> int runUnitTests(const char* _name, Tests... _tests)
+	{
+		try
+		{
+			std::cout << "Running " << _name << " Unit Tests..." << std::endl;
+			std::cout << std::endl;
+
+			(_tests(), ...);
+
+			std::cout << std::endl;
+			std::cout << "All tests passed successfully!" << std::endl;
+			return 0;
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Test failed with exception: " << e.what() << std::endl;
+			return 1;
+		}
+		catch (...)
+		{
+			std::cerr << "Test failed with unknown exception" << std::endl;
+			return 1;
+		}
+	}
+}
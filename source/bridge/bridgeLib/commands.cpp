@@ -78,7 +78,9 @@ namespace bridgeLib
 		_s.read(params.preferredSamplerate);
 		_s.read(params.hostSamplerate);
 		params.romName = _s.readString();
-		_s.read(params.romData);
+		std::vector<uint8_t> romData;
+		_s.read(romData);
+		params.romData = synthLib::RomCache::get(std::move(romData));
 		_s.read(params.romHash);
 		_s.read(params.customData);
 		return _s;
@@ -89,7 +91,7 @@ namespace bridgeLib
 		_s.write(params.preferredSamplerate);
 		_s.write(params.hostSamplerate);
 		_s.write(params.romName);
-		_s.write(params.romData);
+		_s.write(params.romData.get());
 		_s.write(params.romHash);
 		_s.write(params.customData);
 		return _s;
@@ -27,7 +27,7 @@ namespace bridgeClient
 
 	RemoteDevice::RemoteDevice(const synthLib::DeviceCreateParams& _params, bridgeLib::PluginDesc&& _desc, const std::string& _host/* = {}*/, uint32_t _port/* = 0*/) : Device(_params), m_pluginDesc(std::move(_desc))
 	{
-		getDeviceCreateParams().romHash = baseLib::MD5(getDeviceCreateParams().romData);
+		getDeviceCreateParams().romHash = getDeviceCreateParams().romData.getHash();
 		getDeviceCreateParams().romName = baseLib::filesystem::getFilenameWithoutPath(getDeviceCreateParams().romName);
 
 		m_pluginDesc.protocolVersion = bridgeLib::g_protocolVersion;
@@ -59,7 +59,7 @@ namespace bridgeServer
 		if(p.romData.empty())
 		{
 			// if no rom data has been transmitted, try to load from cache
-			const auto& romData = m_server.getRomPool().getRom(p.romHash);
+			const auto romData = m_server.getRomPool().getRom(p.romHash);
 
 			if(!romData.empty())
 			{
@@ -89,7 +89,7 @@ namespace bridgeServer
 		else
 		{
 			// client sent the rom. Validate transmission by comparing hashes
-			const baseLib::MD5 calculatedHash(p.romData);
+			const auto& calculatedHash = p.romData.getHash();
 			if(calculatedHash != p.romHash)
 			{
 				LOGNET(networkLib::LogLevel::Error, "Calculated hash " << calculatedHash.toString() << " of ROM " << p.romName << " does not match sent hash " <<  p.romHash.toString() << ", transfer error");
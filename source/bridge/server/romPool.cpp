@@ -14,7 +14,7 @@ namespace bridgeServer
 		findRoms();
 	}
 
-	const RomData& RomPool::getRom(const baseLib::MD5& _hash)
+	RomData RomPool::getRom(const baseLib::MD5& _hash)
 	{
 		std::scoped_lock lock(m_mutex);
 
@@ -24,19 +24,18 @@ namespace bridgeServer
 		it = m_roms.find(_hash);
 		if(it != m_roms.end())
 			return it->second;
-		static RomData empty;
-		return empty;
+		return {};
 	}
 
 	void RomPool::addRom(const std::string& _name, const RomData& _data)
 	{
 		std::scoped_lock lock(m_mutex);
 
-		const auto hash = baseLib::MD5(_data);
+		const auto& hash = _data.getHash();
 		if(m_roms.find(hash) != m_roms.end())
 			return;
 
-		if(baseLib::filesystem::writeFile(getRootPath() + _name + '_' + hash.toString() + ".bin", _data))
+		if(baseLib::filesystem::writeFile(getRootPath() + _name + '_' + hash.toString() + ".bin", _data.get()))
 			m_roms.insert({hash, _data});
 	}
 
@@ -52,20 +51,21 @@ namespace bridgeServer
 
 		for (const auto& file : files)
 		{
-			std::vector<uint8_t> romData;
+			// shared with devices created by this process that use the same ROM
+			auto romData = synthLib::RomCache::loadFile(file);
 
-			if(!baseLib::filesystem::readFile(romData, file))
+			if(romData.empty())
 			{
 				LOGNET(networkLib::LogLevel::Error, "Failed to load file " << file);
 				continue;
 			}
 
-			const auto hash = baseLib::MD5(romData);
+			const auto& hash = romData.getHash();
 
 			if(m_roms.find(hash) != m_roms.end())
 				continue;
 
-			m_roms.insert({hash, std::move(romData)});
+			m_roms.insert({hash, romData});
 			LOGNET(networkLib::LogLevel::Info, "Loaded ROM " << baseLib::filesystem::getFilenameWithoutPath(file));
 		}
 	}
@@ -3,9 +3,10 @@
 #include <cstdint>
 #include <map>
 #include <mutex>
-#include <vector>
 #include <string>
 
+#include "synthLib/romCache.h"
+
 namespace baseLib
 {
 	class MD5;
@@ -14,14 +15,14 @@ namespace baseLib
 namespace bridgeServer
 {
 	struct Config;
-	using RomData = std::vector<uint8_t>;
+	using RomData = synthLib::RomImage;
 
 	class RomPool
 	{
 	public:
 		RomPool(Config& _config);
 
-		const RomData& getRom(const baseLib::MD5& _hash);
+		RomData getRom(const baseLib::MD5& _hash);
 		void addRom(const std::string& _name, const RomData& _data);
 
 	private:
@@ -0,0 +1,46 @@
+#include "lockstep.h"
+
+#include <algorithm>
+
+namespace hwLib
+{
+	void Lockstep::addUnit(ExecFunc _exec, CanExecFunc _canExec)
+	{
+		m_units.push_back({std::move(_exec), std::move(_canExec)});
+	}
+
+	void Lockstep::setSliceLength(const uint32_t _steps)
+	{
+		m_sliceLength = std::max(1u, _steps);
+	}
+
+	bool Lockstep::canExec() const
+	{
+		for (const auto& unit : m_units)
+		{
+			if(unit.canExec())
+				return true;
+		}
+		return false;
+	}
+
+	bool Lockstep::execSlice()
+	{
+		uint64_t steps = 0;
+
+		for (const auto& unit : m_units)
+		{
+			// the condition is checked before each step as a single step may consume the last input frame or
+			// may fill the last free output slot
+			for(uint32_t i=0; i<m_sliceLength && unit.canExec(); ++i)
+			{
+				unit.exec();
+				++steps;
+			}
+		}
+
+		m_stepCount += steps;
+
+		return steps > 0;
+	}
+}
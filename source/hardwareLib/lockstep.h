@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace hwLib
+{
+	// Executes multiple DSPs cooperatively on the calling thread instead of running each of them on a thread of its own
+	//
+	// A unit is a DSP that is executed in small steps, usually one call of DSP::exec() per step. A unit is only
+	// stepped if it is able to run without blocking, i.e. its audio interface has input data available and space to
+	// write output data. Units are processed in the order in which they have been added, which makes the execution
+	// order reproducible. Not thread-safe, all functions are called from the worker thread
+	class Lockstep
+	{
+	public:
+		using ExecFunc = std::function<void()>;
+		using CanExecFunc = std::function<bool()>;
+
+		static constexpr uint32_t DefaultSliceLength = 64;
+
+		void addUnit(ExecFunc _exec, CanExecFunc _canExec);
+
+		// number of steps that each unit executes at most per slice
+		void setSliceLength(uint32_t _steps);
+		uint32_t getSliceLength() const { return m_sliceLength; }
+
+		// returns true if at least one unit is able to execute a step
+		bool canExec() const;
+
+		// executes one slice for each unit, returns false if no unit was able to execute anything
+		bool execSlice();
+
+		uint64_t getStepCount() const { return m_stepCount; }
+
+	private:
+		struct Unit
+		{
+			ExecFunc exec;
+			CanExecFunc canExec;
+		};
+
+		std::vector<Unit> m_units;
+		uint32_t m_sliceLength = DefaultSliceLength;
+		uint64_t m_stepCount = 0;
+	};
+}
@@ -1,126 +1,233 @@
 #include "sciMidi.h"
 
+#include <algorithm>
 #include <deque>
 
 #include "mc68k/qsm.h"
 
 #include "synthLib/midiBufferParser.h"
 
+#include "dsp56kBase/logging.h"
+
 namespace hwLib
 {
 	// pause 0.1 seconds for a sysex size of 500, delay is calculated for other sysex sizes accordingly
 	static constexpr float g_sysexSendDelaySeconds = 0.1f;
 	static constexpr uint32_t g_sysexSendDelaySize = 500;
 
-	SciMidi::SciMidi(mc68k::Qsm& _qsm, const float _samplerate) : m_qsm(_qsm), m_samplerate(_samplerate), m_sysexDelaySeconds(g_sysexSendDelaySeconds), m_sysexDelaySize(g_sysexSendDelaySize)
+	SciMidi::SciMidi(mc68k::Qsm& _qsm, const float _samplerate)
+		: m_qsm(_qsm)
+		, m_samplerate(_samplerate)
+		, m_ring(RingSize)
+		, m_chunks(ChunkRingSize)
+		, m_shortRing(ShortRingSize)
+		, m_sysexDelaySeconds(g_sysexSendDelaySeconds)
+		, m_sysexDelaySize(g_sysexSendDelaySize)
 	{
 	}
 
 	void SciMidi::process(const uint32_t _numSamples)
 	{
-		std::unique_lock lock(m_mutex);
+		// sysex input is paused while the device sends sysex itself
+		if(!m_readingSysex)
+			releaseSysexChunks(_numSamples);
+
+		const auto shortWritePos = m_shortWritePosShared.load(std::memory_order_acquire);
 
-		if(m_readingSysex)
+		if(m_readPos == m_releasedEnd && m_shortReadPos == shortWritePos)
 			return;
 
-		// Move ready sysex messages into the byte buffer
+		// Drain bytes to QSM with baud rate pacing. Regular MIDI data is sent first, unless it would be inserted into a
+		// sysex message that has been sent partially
+		const auto byteDelaySeconds = m_byteDelaySeconds.load(std::memory_order_relaxed);
+
+		auto remainingSamples = _numSamples;
+
+		while(true)
 		{
-			auto remainingSamples = _numSamples;
+			const bool sysex = m_sendingSysex || m_shortReadPos == shortWritePos;
+
+			if(sysex && m_readPos == m_releasedEnd)
+				break;
 
-			while(!m_pendingSysexBuffers.empty())
+			if(byteDelaySeconds > 0.0f)
 			{
-				if(m_remainingSysexDelay > 0)
+				if(m_remainingByteDelay > 0)
 				{
-					const auto sub = std::min(m_remainingSysexDelay, remainingSamples);
+					const auto sub = std::min(m_remainingByteDelay, remainingSamples);
 					remainingSamples -= sub;
-					m_remainingSysexDelay -= sub;
+					m_remainingByteDelay -= sub;
 				}
 
-				if(m_remainingSysexDelay)
+				if(m_remainingByteDelay)
 					break;
 
-				const auto& msg = m_pendingSysexBuffers.front();
+				m_remainingByteDelay = static_cast<uint32_t>(m_samplerate * byteDelaySeconds);
+			}
 
-				for (const auto b : msg)
-					m_pendingBytes.push_back(b);
+			if(sysex)
+			{
+				const auto b = m_ring[m_readPos & (RingSize - 1)];
+				++m_readPos;
 
-				m_remainingSysexDelay = static_cast<uint32_t>(static_cast<float>(msg.size()) * m_samplerate * m_sysexDelaySeconds / static_cast<float>(m_sysexDelaySize));
+				if(b == 0xf0)
+					m_sendingSysex = true;
+				else if(b == 0xf7)
+					m_sendingSysex = false;
 
-				m_pendingSysexBuffers.pop_front();
+				m_qsm.writeSciRX(b);
+			}
+			else
+			{
+				m_qsm.writeSciRX(m_shortRing[m_shortReadPos & (ShortRingSize - 1)]);
+				++m_shortReadPos;
 			}
 		}
 
-		// Drain all pending bytes to QSM with baud rate pacing
-		{
-			auto remainingSamples = _numSamples;
+		m_ringReadPosShared.store(m_readPos, std::memory_order_release);
+		m_shortReadPosShared.store(m_shortReadPos, std::memory_order_release);
+	}
 
-			while(!m_pendingBytes.empty())
-			{
-				if(m_remainingByteDelay > 0)
-				{
-					const auto sub = std::min(m_remainingByteDelay, remainingSamples);
-					remainingSamples -= sub;
-					m_remainingByteDelay -= sub;
-				}
+	void SciMidi::releaseSysexChunks(const uint32_t _numSamples)
+	{
+		// Release chunks for sending, a chunk delays the sysex chunks that follow it
+		auto remainingSamples = _numSamples;
 
-				if(m_remainingByteDelay)
-					break;
+		const auto chunkWritePos = m_chunkWritePosShared.load(std::memory_order_acquire);
 
-				m_qsm.writeSciRX(m_pendingBytes.front());
-				m_pendingBytes.pop_front();
-				m_remainingByteDelay = static_cast<uint32_t>(m_samplerate * m_byteDelaySeconds);
+		while(m_chunkReadPos != chunkWritePos)
+		{
+			if(m_remainingSysexDelay > 0)
+			{
+				const auto sub = std::min(m_remainingSysexDelay, remainingSamples);
+				remainingSamples -= sub;
+				m_remainingSysexDelay -= sub;
 			}
+
+			if(m_remainingSysexDelay)
+				break;
+
+			const auto chunkSize = m_chunks[m_chunkReadPos & (ChunkRingSize - 1)];
+			++m_chunkReadPos;
+
+			m_releasedEnd += chunkSize;
+
+			// chunks may be small, keep the fractional part to not lose any delay
+			const auto delay = static_cast<float>(chunkSize) * m_samplerate * m_sysexDelaySeconds.load(std::memory_order_relaxed) / static_cast<float>(m_sysexDelaySize.load(std::memory_order_relaxed)) + m_sysexDelayFraction;
+			m_remainingSysexDelay = static_cast<uint32_t>(delay);
+			m_sysexDelayFraction = delay - static_cast<float>(m_remainingSysexDelay);
 		}
+
+		m_chunkReadPosShared.store(m_chunkReadPos, std::memory_order_release);
 	}
 
-	void SciMidi::write(const uint8_t _byte)
+	bool SciMidi::write(const uint8_t* _data, const size_t _size)
 	{
-		std::unique_lock lock(m_mutex);
+		if(!_size)
+			return true;
 
-		if(_byte == 0xf0)
+		if(_size > RingSize)
 		{
-			m_writingSysex = true;
+			LOG("MIDI data of size " << _size << " exceeds the maximum size of " << RingSize << ", dropped");
+			return true;
 		}
 
-		if(m_writingSysex)
-		{
-			m_pendingSysexMessage.push_back(_byte);
-		}
-		else if(m_byteDelaySeconds > 0.0f)
+		std::lock_guard lock(m_writeMutex);
+
+		// split the data into sysex and regular data upfront, the write is accepted only if both rings have enough space
+		size_t sysexSize = 0;
 		{
-			m_pendingBytes.push_back(_byte);
+			auto writingSysex = m_writingSysex;
+
+			for(size_t i=0; i<_size; ++i)
+			{
+				if(_data[i] == 0xf0)
+					writingSysex = true;
+				if(writingSysex)
+					++sysexSize;
+				if(_data[i] == 0xf7)
+					writingSysex = false;
+			}
 		}
-		else
+
+		const auto shortSize = _size - sysexSize;
+
+		if(shortSize > ShortRingSize)
 		{
-			m_qsm.writeSciRX(_byte);
+			LOG("MIDI data of size " << shortSize << " exceeds the maximum size of " << ShortRingSize << ", dropped");
+			return true;
 		}
 
-		if (_byte == 0xf7)
+		if(m_writePos - m_ringReadPosShared.load(std::memory_order_acquire) + sysexSize > RingSize)
+			return false;
+
+		if(m_shortWritePos - m_shortReadPosShared.load(std::memory_order_acquire) + shortSize > ShortRingSize)
+			return false;
+
+		// a chunk is finished at each start and end of a sysex message and at the end of the write
+		const auto bufferedChunks = m_chunkWritePos - m_chunkReadPosShared.load(std::memory_order_acquire);
+		const auto newChunks = static_cast<uint64_t>(std::count_if(_data, _data + _size, [](const uint8_t _b) { return _b == 0xf0 || _b == 0xf7; })) + 1;
+
+		if(bufferedChunks + newChunks > ChunkRingSize)
+			return false;
+
+		for(size_t i=0; i<_size; ++i)
 		{
-			m_writingSysex = false;
+			const auto b = _data[i];
+
+			if(b == 0xf0)
+			{
+				// an unterminated sysex message is finished by the start of the next one
+				publishChunk();
+				m_writingSysex = true;
+			}
 
-			if (!m_pendingSysexMessage.empty())
-				m_pendingSysexBuffers.push_back(std::move(m_pendingSysexMessage));
+			if(m_writingSysex)
+			{
+				m_ring[m_writePos & (RingSize - 1)] = b;
+				++m_writePos;
+			}
+			else
+			{
+				m_shortRing[m_shortWritePos & (ShortRingSize - 1)] = b;
+				++m_shortWritePos;
+			}
 
-			m_pendingSysexMessage.clear();
+			if(b == 0xf7 && m_writingSysex)
+			{
+				publishChunk();
+				m_writingSysex = false;
+			}
 		}
+
+		// a sysex message that is continued by the next write is sent in multiple chunks
+		publishChunk();
+
+		m_chunkWritePosShared.store(m_chunkWritePos, std::memory_order_release);
+		m_shortWritePosShared.store(m_shortWritePos, std::memory_order_release);
+
+		return true;
+	}
+
+	void SciMidi::publishChunk()
+	{
+		if(m_writePos == m_chunkStart)
+			return;
+
+		m_chunks[m_chunkWritePos & (ChunkRingSize - 1)] = static_cast<uint32_t>(m_writePos - m_chunkStart);
+
+		++m_chunkWritePos;
+		m_chunkStart = m_writePos;
 	}
 
-	void SciMidi::write(const synthLib::SMidiEvent& _e)
+	bool SciMidi::write(const synthLib::SMidiEvent& _e)
 	{
 		if(!_e.sysex.empty())
-		{
-			write(_e.sysex);
-		}
-		else
-		{
-			write(_e.a);
-			const auto len = synthLib::MidiBufferParser::lengthFromStatusByte(_e.a);
-			if (len > 1)
-				write(_e.b);
-			if (len > 2)
-				write(_e.c);
-		}
+			return write(_e.sysex);
+
+		const uint8_t bytes[] = {_e.a, _e.b, _e.c};
+		const auto len = synthLib::MidiBufferParser::lengthFromStatusByte(_e.a);
+		return write(bytes, std::clamp<size_t>(len, 1, 3));
 	}
 
 	void SciMidi::read(std::vector<uint8_t>& _result)
@@ -149,7 +256,7 @@ namespace hwLib
 	void SciMidi::setSysexDelay(const float _seconds, const uint32_t _size)
 	{
 		m_sysexDelaySeconds = _seconds;
-		m_sysexDelaySize = _size;
+		m_sysexDelaySize = std::max(1u, _size);
 	}
 
 	void SciMidi::setByteDelay(const float _seconds)
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <deque>
-#include <vector>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <mutex>
+#include <vector>
 
 namespace synthLib
 {
@@ -17,55 +19,92 @@ namespace mc68k
 
 namespace hwLib
 {
+	// Feeds MIDI data into the SCI receiver of the 68k QSM
+	//
+	// Written bytes are stored in preallocated single-producer single-consumer byte rings and forwarded to the QSM in
+	// process() with optional pacing. Sysex messages and regular MIDI data use separate rings. The sysex ring is split
+	// into chunks, a chunk is the part of a write call that belongs to one sysex message. The sysex delay is applied
+	// per chunk, proportional to its size, it only delays subsequent sysex data. Regular MIDI data is forwarded with
+	// the next call to process(), it is only held back while a sysex message is being sent to not corrupt it.
+	//
+	// process() is expected to be called once per audio frame so that regular MIDI data reaches the QSM at its sample
+	// offset. It is lock-free and the only function that writes to the QSM.
+	//
+	// A write is either accepted completely or not at all, the write functions return false if a ring is full. In
+	// this case, the caller is expected to retry later. Writes are serialized
 	class SciMidi
 	{
 	public:
+		static constexpr uint32_t RingSize = 1 << 18;
+		static constexpr uint32_t ChunkRingSize = 1 << 12;
+		static constexpr uint32_t ShortRingSize = 1 << 12;
+
 		explicit SciMidi(mc68k::Qsm& _qsm, float _samplerate);
+		virtual ~SciMidi() = default;
 
 		void process(uint32_t _numSamples);
 
-		void write(uint8_t _byte);
-		void write(const std::initializer_list<uint8_t>& _bytes)
+		bool write(const uint8_t* _data, size_t _size);
+		bool write(const uint8_t _byte)
 		{
-			for (const uint8_t byte : _bytes)
-				write(byte);
+			return write(&_byte, 1);
 		}
-		void write(const std::vector<uint8_t>& _bytes)
+		bool write(const std::initializer_list<uint8_t>& _bytes)
 		{
-			for (const uint8_t byte : _bytes)
-				write(byte);
+			return write(_bytes.begin(), _bytes.size());
 		}
-		virtual void write(const synthLib::SMidiEvent& _e);
-
 		template<typename Alloc>
-		void write(const std::vector<uint8_t, Alloc>& _bytes)
+		bool write(const std::vector<uint8_t, Alloc>& _bytes)
 		{
-			for (const uint8_t byte : _bytes)
-				write(byte);
+			return write(_bytes.data(), _bytes.size());
 		}
+		virtual bool write(const synthLib::SMidiEvent& _e);
 
 		virtual void read(std::vector<uint8_t>& _result);
 
-		void setSysexDelay(const float _seconds, const uint32_t _size);
+		void setSysexDelay(float _seconds, uint32_t _size);
 		void setByteDelay(float _seconds);
 
 	private:
+		void releaseSysexChunks(uint32_t _numSamples);
+		void publishChunk();
+
 		mc68k::Qsm& m_qsm;
 
 		const float m_samplerate;
 
-		bool m_readingSysex = false;
+		std::vector<uint8_t> m_ring;		// sysex data
+		std::vector<uint32_t> m_chunks;		// sizes of the sysex chunks
+		std::vector<uint8_t> m_shortRing;	// regular MIDI data
+
+		// producer
+		std::mutex m_writeMutex;
 		bool m_writingSysex = false;
-		uint32_t m_remainingSysexDelay = 0;
+		uint64_t m_writePos = 0;
+		uint64_t m_chunkStart = 0;
+		uint64_t m_chunkWritePos = 0;
+		uint64_t m_shortWritePos = 0;
 
-		std::deque< std::vector<uint8_t> > m_pendingSysexBuffers;
-		std::vector<uint8_t> m_pendingSysexMessage;
-		std::mutex m_mutex;
-		float m_sysexDelaySeconds;
-		uint32_t m_sysexDelaySize;
+		// shared
+		std::atomic<uint64_t> m_ringReadPosShared{0};
+		std::atomic<uint64_t> m_chunkWritePosShared{0};
+		std::atomic<uint64_t> m_chunkReadPosShared{0};
+		std::atomic<uint64_t> m_shortWritePosShared{0};
+		std::atomic<uint64_t> m_shortReadPosShared{0};
 
-		std::deque<uint8_t> m_pendingBytes;
+		// consumer
+		std::atomic<bool> m_readingSysex{false};
+		bool m_sendingSysex = false;
+		uint64_t m_readPos = 0;
+		uint64_t m_releasedEnd = 0;
+		uint64_t m_chunkReadPos = 0;
+		uint64_t m_shortReadPos = 0;
+		uint32_t m_remainingSysexDelay = 0;
+		float m_sysexDelayFraction = 0.0f;
 		uint32_t m_remainingByteDelay = 0;
-		float m_byteDelaySeconds = 0.0f;
+
+		std::atomic<float> m_sysexDelaySeconds;
+		std::atomic<uint32_t> m_sysexDelaySize;
+		std::atomic<float> m_byteDelaySeconds{0.0f};
 	};
 }
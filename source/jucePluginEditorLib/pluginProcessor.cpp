@@ -6,6 +6,7 @@
 #include "baseLib/binarystream.h"
 
 #include "synthLib/os.h"
+#include "synthLib/prebootCache.h"
 
 #include "mcpServerLib/mcpPluginServer.h"
 #include "mcpDomTools.h"
@@ -72,6 +73,9 @@ namespace jucePluginEditorLib
 #endif
 		savePluginLoadPath();
 
+		// a spare device costs the memory and threads of an additional device, it is opt-in and build time helpers never need one
+		synthLib::PrebootCache::setEnabled(m_config.getBoolValue("prebootDevices", false) && !isJuceHelperProcess());
+
 		if (m_config.getBoolValue("enableMcpServer", false) && !isJuceHelperProcess())
 			startMcpServer();
 	}
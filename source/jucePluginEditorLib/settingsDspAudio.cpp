@@ -11,6 +11,7 @@
 #include "RmlUi/Core/Element.h"
 
 #include <cmath>
+#include <iomanip>
 #include <sstream>
 
 namespace jucePluginEditorLib
@@ -33,6 +34,10 @@ namespace jucePluginEditorLib
 
 	static_assert(g_resamplerModes.size() == static_cast<size_t>(synthLib::Resampler::Mode::Count));
 
+	static constexpr std::initializer_list<const char*> g_timingLabels = {"labelTimingTotal", "labelTimingMidi", "labelTimingResampler", "labelTimingDevice"};
+
+	static_assert(g_timingLabels.size() == static_cast<size_t>(synthLib::ProcessTimings::Stage::Count));
+
 	namespace
 	{
 		float dbToGain(const float _db)
@@ -54,6 +59,20 @@ namespace jucePluginEditorLib
 				return std::to_string(dbInt) + " dB";
 			return "0 dB";
 		}
+
+		std::string formatPercent(const float _us, const float _budgetUs)
+		{
+			if (_budgetUs <= 0.0f)
+				return "-";
+			std::stringstream ss;
+			ss << std::fixed << std::setprecision(1) << (_us * 100.0f / _budgetUs) << '%';
+			return ss.str();
+		}
+	}
+
+	SettingsDspAudio::SettingsDspAudio(Processor& _processor) : SettingsPlugin(_processor)
+	{
+		startTimer(500);
 	}
 
 	void SettingsDspAudio::createUi(Rml::Element* _root)
@@ -213,6 +232,26 @@ namespace jucePluginEditorLib
 				updateResamplerButtons();
 			});
 		}
+
+		// Audio thread timings
+		m_labelTimingSummary = juceRmlUi::helper::findChild(_root, "labelTimingSummary", false);
+
+		size_t labelIndex = 0;
+		for (const auto* labelId : g_timingLabels)
+			m_labelTimings[labelIndex++] = juceRmlUi::helper::findChild(_root, labelId, false);
+
+		addClickHandler(_root, "btTimingReset", [this](Rml::Event&)
+		{
+			m_processor.getPlugin().resetProcessTimings();
+			updateTimings();
+		});
+
+		updateTimings();
+	}
+
+	void SettingsDspAudio::timerCallback()
+	{
+		updateTimings();
 	}
 
 	uint32_t SettingsDspAudio::getCurrentLatency() const
@@ -249,4 +288,49 @@ namespace jucePluginEditorLib
 			button->setChecked(currentMode == mode);
 		}
 	}
+
+	void SettingsDspAudio::updateTimings() const
+	{
+		if (!m_labelTimingSummary)
+			return;
+
+		using Stage = synthLib::ProcessTimings::Stage;
+
+		const auto stats = m_processor.getPlugin().getProcessTimings();
+
+		if (!stats.blockCount)
+		{
+			m_labelTimingSummary->SetInnerRML("No audio processed yet");
+			for (auto* label : m_labelTimings)
+			{
+				if (label)
+					label->SetInnerRML("-");
+			}
+			return;
+		}
+
+		const auto& total = stats[Stage::Total];
+
+		std::stringstream ss;
+		ss << "Buffer " << std::fixed << std::setprecision(0) << stats.avgBudgetUs << " us, load avg " << formatPercent(total.avgUs, stats.avgBudgetUs)
+			<< ", p99 " << formatPercent(total.p99Us, stats.avgBudgetUs)
+			<< ", max " << formatPercent(total.maxUs, stats.avgBudgetUs)
+			<< ", overruns " << stats.overrunCount << " of " << stats.blockCount << " blocks";
+		m_labelTimingSummary->SetInnerRML(Rml::StringUtilities::EncodeRml(ss.str()));
+
+		for (size_t i = 0; i < m_labelTimings.size(); ++i)
+		{
+			auto* label = m_labelTimings[i];
+			if (!label)
+				continue;
+
+			const auto stage = static_cast<Stage>(i);
+			const auto& s = stats[stage];
+
+			std::stringstream ls;
+			ls << synthLib::ProcessTimings::getStageName(stage) << ": " << std::fixed << std::setprecision(0)
+				<< "min " << s.minUs << " / avg " << s.avgUs << " / p99 " << s.p99Us << " / max " << s.maxUs << " us";
+			label->SetInnerRML(Rml::StringUtilities::EncodeRml(ls.str()));
+		}
+	}
 }
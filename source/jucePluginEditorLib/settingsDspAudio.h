@@ -2,35 +2,50 @@
 
 #include "settingsPlugin.h"
 
+#include "synthLib/processTimings.h"
 #include "synthLib/resampler.h"
 
+#include <juce_events/juce_events.h>
+
+#include <array>
+
 namespace juceRmlUi
 {
 	class ElemButton;
 }
 
+namespace Rml
+{
+	class Element;
+}
+
 namespace jucePluginEditorLib
 {
 	class Processor;
 
-	class SettingsDspAudio : public SettingsPlugin
+	class SettingsDspAudio : public SettingsPlugin, juce::Timer
 	{
 	public:
-		SettingsDspAudio(Processor& _processor) : SettingsPlugin(_processor) {}
+		explicit SettingsDspAudio(Processor& _processor);
 
 		std::string getCategoryName() const override {return "DSP & Audio";}
 		std::string getTemplateName() const override { return "tus_settings_dspaudio"; }
 
 		void createUi(Rml::Element* _root) override;
+		void timerCallback() override;
 
 	private:
 		uint32_t getCurrentLatency() const;
 		void updateButtons() const;
 		void updateClockButtons() const;
 		void updateResamplerButtons() const;
+		void updateTimings() const;
 
 		std::vector<std::pair<uint32_t, juceRmlUi::ElemButton*>> m_latencyButtons;
 		std::vector<std::pair<int, juceRmlUi::ElemButton*>> m_clockButtons;
 		std::vector<std::pair<synthLib::Resampler::Mode, juceRmlUi::ElemButton*>> m_resamplerButtons;
+
+		Rml::Element* m_labelTimingSummary = nullptr;
+		std::array<Rml::Element*, static_cast<size_t>(synthLib::ProcessTimings::Stage::Count)> m_labelTimings{};
 	};
 }
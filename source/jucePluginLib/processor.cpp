@@ -18,6 +18,7 @@
 #include "synthLib/deviceException.h"
 #include "synthLib/os.h"
 #include "synthLib/midiBufferParser.h"
+#include "synthLib/prebootCache.h"
 #include "synthLib/romLoader.h"
 #include "synthLib/wavWriter.h"
 
@@ -37,6 +38,13 @@ namespace pluginLib
 	constexpr uint32_t g_saveVersion = 2;
 	constexpr const char* const g_defaultProgramName = "default";
 
+	namespace
+	{
+		// the boot threads are shut down when the last instance is destroyed and not during static destruction, which
+		// may happen while the plugin library is unloaded
+		std::atomic<uint32_t> g_processorCount{0};
+	}
+
 	bridgeLib::SessionId generateRemoteSessionId()
 	{
 		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -54,14 +62,27 @@ namespace pluginLib
 		synthLib::RomLoader::addSearchPath(getPublicRomFolder());
 		synthLib::RomLoader::addSearchPath(synthLib::getModulePath(true));
 		synthLib::RomLoader::addSearchPath(synthLib::getModulePath(false));
+
+		++g_processorCount;
 	}
 
 	Processor::~Processor()
 	{
 		m_midiPorts.close();
 		destroyController();
+
+		// a boot that has never been picked up does not access this instance, discarding the future destroys the device
+		// once it has booted
+		m_pendingDevice = {};
+
 		m_plugin.reset();
 		m_device.reset();
+
+		if(--g_processorCount == 0)
+		{
+			synthLib::PrebootCache::clear();
+			synthLib::BootScheduler::shutdown();
+		}
 	}
 
 	void Processor::addMidiEvent(const synthLib::SMidiEvent& _ev)
@@ -90,7 +111,7 @@ namespace pluginLib
 		if (m_midiRoutingMatrix.enabled(_ev, synthLib::MidiEventSource::Editor))
 			getController().enqueueMidiMessages({_ev});
 		if (m_midiRoutingMatrix.enabled(_ev, synthLib::MidiEventSource::Device))
-			getPlugin().addMidiEvent(_ev);
+			addMidiEventToPlugin(_ev);
 		if (m_midiRoutingMatrix.enabled(_ev, synthLib::MidiEventSource::Physical))
 			m_midiPorts.send(_ev);
 	}
@@ -176,9 +197,57 @@ namespace pluginLib
 		if(m_plugin)
 			return *m_plugin;
 
+		// the boot is executed via the scheduler even if it has not been started in advance, this way the number of
+		// instances that boot concurrently stays limited
+		if(!m_pendingDevice.valid())
+			startDeviceBoot();
+
+		return createPlugin();
+	}
+
+	synthLib::Plugin* Processor::getPluginIfReady()
+	{
+		// never wait for another thread that holds the lock while it waits for the boot
+		std::unique_lock<std::mutex> lock(m_deviceCreateMutex, std::try_to_lock);
+
+		if(!lock.owns_lock())
+			return nullptr;
+
+		if(m_plugin)
+			return m_plugin.get();
+
+		if(!m_pendingDevice.valid() || !synthLib::BootScheduler::isReady(m_pendingDevice))
+			return nullptr;
+
+		return &createPlugin();
+	}
+
+	void Processor::startDeviceBoot()
+	{
+		// the device parameters are captured here, the boot thread does not access this instance
+		synthLib::BootScheduler::CreateFunc create;
+
 		try
 		{
-			m_device.reset(createDevice());
+			create = getDeviceFactory();
+		}
+		catch(const synthLib::DeviceException&)
+		{
+			// reported when the device is picked up, like an error during the boot
+			create = [e = std::current_exception()]() -> synthLib::Device*
+			{
+				std::rethrow_exception(e);
+			};
+		}
+
+		m_pendingDevice = synthLib::BootScheduler::boot(std::move(create));
+	}
+
+	synthLib::Plugin& Processor::createPlugin()
+	{
+		try
+		{
+			m_device = m_pendingDevice.get();
 			if(!m_device->isValid())
 				throw synthLib::DeviceException(synthLib::DeviceError::Unknown, "Device initialization failed");
 		}
@@ -232,9 +301,59 @@ namespace pluginLib
 			return onDeviceInvalid(_device);
 		}));
 
+		if(m_pendingLatencyBlocks)
+		{
+			m_plugin->setLatencyBlocks(*m_pendingLatencyBlocks);
+			m_pendingLatencyBlocks.reset();
+		}
+
+		for (const auto& ev : m_pendingMidiEvents)
+			m_plugin->addMidiEvent(ev);
+		m_pendingMidiEvents.clear();
+
+		// prepareToPlay did not wait for the device, apply the host configuration now
+		if(m_hostBlockSize)
+		{
+			m_plugin->setHostSamplerate(m_hostSamplerate, m_preferredDeviceSamplerate);
+			m_plugin->setBlockSize(m_hostBlockSize);
+			setLatencySamples(static_cast<int>(getProperties().isSynth ? m_plugin->getLatencyMidiToOutput() : m_plugin->getLatencyInputToOutput()));
+		}
+
 		return *m_plugin;
 	}
 
+	void Processor::addMidiEventToPlugin(const synthLib::SMidiEvent& _ev)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_deviceCreateMutex);
+
+			// do not wait for a booting device, i.e. for the requests that a controller sends while it is constructed
+			if(!m_plugin && m_pendingDevice.valid())
+			{
+				m_pendingMidiEvents.push_back(_ev);
+				return;
+			}
+		}
+
+		getPlugin().addMidiEvent(_ev);
+	}
+
+	void Processor::beginDeviceBoot()
+	{
+		std::lock_guard<std::mutex> lock(m_deviceCreateMutex);
+
+		if(m_plugin || m_pendingDevice.valid())
+			return;
+
+		startDeviceBoot();
+	}
+
+	bool Processor::isDeviceBootPending() const
+	{
+		std::lock_guard<std::mutex> lock(m_deviceCreateMutex);
+		return m_pendingDevice.valid() && !synthLib::BootScheduler::isReady(m_pendingDevice);
+	}
+
 	bridgeClient::RemoteDevice* Processor::createRemoteDevice(const synthLib::DeviceCreateParams& _params)
 	{
 		bridgeLib::PluginDesc desc;
@@ -268,6 +387,17 @@ namespace pluginLib
 
 	bool Processor::setLatencyBlocks(uint32_t _blocks)
 	{
+		{
+			std::lock_guard<std::mutex> lock(m_deviceCreateMutex);
+
+			// applied once the plugin is created, the latency is reported in prepareToPlay
+			if(!m_plugin)
+			{
+				m_pendingLatencyBlocks = _blocks;
+				return true;
+			}
+		}
+
 		if (!getPlugin().setLatencyBlocks(_blocks))
 			return false;
 		updateLatencySamples();
@@ -635,12 +765,24 @@ namespace pluginLib
 	{
 		// Use this method as the place to do any pre-playback
 		// initialisation that you need
-		m_hostSamplerate = static_cast<float>(sampleRate);
+		{
+			std::lock_guard<std::mutex> lock(m_deviceCreateMutex);
+			m_hostSamplerate = static_cast<float>(sampleRate);
+			m_hostBlockSize = static_cast<uint32_t>(std::max(samplesPerBlock, 1));
+		}
 
-		getPlugin().setHostSamplerate(static_cast<float>(sampleRate), m_preferredDeviceSamplerate);
-		getPlugin().setBlockSize(samplesPerBlock);
+		// do not wait for a device that is still booting, the configuration is applied once it has booted
+		if(auto* plugin = getPluginIfReady())
+		{
+			plugin->setHostSamplerate(static_cast<float>(sampleRate), m_preferredDeviceSamplerate);
+			plugin->setBlockSize(samplesPerBlock);
 
-		updateLatencySamples();
+			updateLatencySamples();
+		}
+		else
+		{
+			beginDeviceBoot();
+		}
 
 		// (Re)allocate the audio-capture buffer for this sample rate, hard-capped so a capture that is never
 		// stopped cannot grow unbounded. Done here (no audio running) so the audio thread never allocates.
@@ -779,12 +921,15 @@ namespace pluginLib
 		{
 			const auto message = metadata.getMessage();
 
-			synthLib::SMidiEvent ev(synthLib::MidiEventSource::Host);
+			auto& ev = m_hostMidiEvent;
+
+			ev.a = ev.b = ev.c = 0;
+			ev.sysex.clear();
 
 			if(message.isSysEx() || message.getRawDataSize() > 3)
 			{
-				ev.sysex.resize(message.getRawDataSize());
-				memcpy(ev.sysex.data(), message.getRawData(), ev.sysex.size());
+				const auto* raw = message.getRawData();
+				ev.sysex.assign(raw, raw + message.getRawDataSize());
 
 				// Juce bug? Or VSTHost bug? Juce inserts f0/f7 when converting VST3 midi packet to Juce packet, but it's already there
 				if(ev.sysex.size() > 1)
@@ -835,14 +980,24 @@ namespace pluginLib
 			}
 		}
 
-		getPlugin().process(inputs, outputs, numSamples, bpm, ppqPos, isPlaying);
+		m_midiOut.clear();
 
-		applyOutputGain(outputs, numSamples);
+		// output silence while the device is booting, MIDI events are kept until it is ready
+		if(auto* plugin = getPluginIfReady())
+		{
+			plugin->process(inputs, outputs, numSamples, bpm, ppqPos, isPlaying);
 
-		captureAudioBlock(buffer, numSamples);
+			applyOutputGain(outputs, numSamples);
 
-		m_midiOut.clear();
-		getPlugin().getMidiOut(m_midiOut);
+			captureAudioBlock(buffer, numSamples);
+
+			plugin->getMidiOut(m_midiOut);
+		}
+		else
+		{
+			for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+				buffer.clear(channel, 0, numSamples);
+		}
 
 	    for (auto& e : m_midiOut)
 	    {
@@ -4,6 +4,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <optional>
 
 #include "bypassBuffer.h"
 #include "controller.h"
@@ -13,6 +14,7 @@
 
 #include "bridgeLib/types.h"
 
+#include "synthLib/bootScheduler.h"
 #include "synthLib/midiRoutingMatrix.h"
 #include "synthLib/plugin.h"
 
@@ -77,9 +79,27 @@ namespace pluginLib
 
 		synthLib::Plugin& getPlugin();
 
+		// Returns nullptr instead of waiting if the device is still booting, used by the audio thread
+		synthLib::Plugin* getPluginIfReady();
+
+		// Starts the device boot in the background via the synthLib::BootScheduler, the boot then runs concurrently
+		// with the remaining initialization of this instance and with the boot of other instances. getPlugin() picks up
+		// the device, waiting for the boot to finish if needed. The factory returned by getDeviceFactory() runs on a
+		// boot thread in this case.
+		// Until then, MIDI events for the device and latency changes are kept and applied once the plugin is created
+		void beginDeviceBoot();
+		bool isDeviceBootPending() const;
+
 		ProgramChangeRouter& getProgramChangeRouter() { return m_programChangeRouter; }
 
-		virtual synthLib::Device* createDevice() = 0;
+		using DeviceFactory = synthLib::BootScheduler::CreateFunc;
+
+		// Reads everything that is needed to create the local device, i.e. ROM and create parameters, on the calling
+		// thread and returns a function that creates the device from that copy. The function may be executed on a
+		// boot thread and must not access the processor
+		virtual DeviceFactory getDeviceFactory() = 0;
+
+		synthLib::Device* createDevice() { return getDeviceFactory()(); }
 		virtual bridgeClient::RemoteDevice* createRemoteDevice(const synthLib::DeviceCreateParams& _params);
 		virtual void getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const;
 		virtual bridgeClient::RemoteDevice* createRemoteDevice();
@@ -248,13 +268,24 @@ namespace pluginLib
 		// first-callers (e.g. the audio thread and an MCP request thread) both see m_plugin == null during
 		// the seconds-long device boot and both run m_device.reset(createDevice()), so the second reset
 		// destroys the device the first is still booting - a use-after-free that corrupts the heap.
-		std::mutex m_deviceCreateMutex;
+		mutable std::mutex m_deviceCreateMutex;
+		synthLib::BootScheduler::DeviceFuture m_pendingDevice;
+		std::vector<synthLib::SMidiEvent> m_pendingMidiEvents;
+		std::optional<uint32_t> m_pendingLatencyBlocks;
 		std::unique_ptr<synthLib::Device> m_device;
 		std::unique_ptr<synthLib::Plugin> m_plugin;
 		std::vector<synthLib::SMidiEvent> m_midiOut;
 
 	private:
+		// reused for every host MIDI event to keep the sysex capacity, prevents allocations on the audio thread
+		synthLib::SMidiEvent m_hostMidiEvent{synthLib::MidiEventSource::Host};
+
 		void addHostMidiFeedback(const synthLib::SMidiEvent& _event);
+		void addMidiEventToPlugin(const synthLib::SMidiEvent& _ev);
+
+		// both are called with m_deviceCreateMutex locked
+		void startDeviceBoot();
+		synthLib::Plugin& createPlugin();
 
 		const Properties m_properties;
 		float m_outputGain = 1.0f;
@@ -263,6 +294,7 @@ namespace pluginLib
 		float m_preferredDeviceSamplerate = 0.0f;
 		synthLib::Resampler::Mode m_resamplerMode = synthLib::Resampler::Mode::Legacy;
 		float m_hostSamplerate = 0.0f;
+		uint32_t m_hostBlockSize = 0;	// 0 until prepareToPlay has been called
 		MidiPorts m_midiPorts;
 		BypassBuffer m_bypassBuffer;
 		DeviceType m_deviceType = DeviceType::Local;
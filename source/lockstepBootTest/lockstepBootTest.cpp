@@ -0,0 +1,117 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "baseLib/unitTest.h"
+
+#include "renderLib/deviceFactory.h"
+
+#include "synthLib/device.h"
+#include "synthLib/offlineRenderer.h"
+
+namespace
+{
+	constexpr uint32_t LockstepFlag = 2;	// DeviceCreateParams::customData bit that enables lockstep mode for mq, XT and N2x
+	constexpr double RenderSeconds = 1.0;
+	constexpr auto Timeout = std::chrono::minutes(2);
+
+	// A stalled lockstep scheduler never returns, the test process is terminated if a device does not finish in time
+	class Watchdog
+	{
+	public:
+		explicit Watchdog(std::string _name) : m_name(std::move(_name))
+		{
+			m_thread = std::thread([this]
+			{
+				std::unique_lock lock(m_mutex);
+				if(m_cv.wait_for(lock, Timeout, [this] { return m_done; }))
+					return;
+				std::cerr << "Test failed: " << m_name << " did not boot, render and shut down in lockstep mode within the timeout" << std::endl;
+				std::_Exit(1);
+			});
+		}
+
+		Watchdog(const Watchdog&) = delete;
+		Watchdog& operator = (const Watchdog&) = delete;
+
+		~Watchdog()
+		{
+			{
+				std::lock_guard lock(m_mutex);
+				m_done = true;
+			}
+			m_cv.notify_one();
+			m_thread.join();
+		}
+
+	private:
+		const std::string m_name;
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		bool m_done = false;
+		std::thread m_thread;
+	};
+
+	void testBoot(const renderLib::SynthType _type)
+	{
+		const auto name = renderLib::DeviceFactory::getSynthName(_type);
+
+		synthLib::DeviceCreateParams params;
+
+		if(!renderLib::DeviceFactory::loadRom(params, _type, {}))
+		{
+			std::cout << "  " << name << ": no ROM found, skipped" << std::endl;
+			return;
+		}
+
+		params.customData |= LockstepFlag;
+
+		std::cout << "  Booting " << name << " in lockstep mode..." << std::endl;
+
+		const Watchdog watchdog(name);
+
+		// the device constructor boots the device, it does not return if the lockstep scheduler stalls
+		const std::unique_ptr<synthLib::Device> device(renderLib::DeviceFactory::createDevice(_type, params));
+
+		TEST_ASSERT(device && device->isValid());
+
+		synthLib::OfflineRenderer::Config config;
+		config.tailSeconds = 0.0;
+
+		synthLib::OfflineRenderer renderer(*device, config);
+
+		const auto length = static_cast<uint64_t>(static_cast<double>(renderer.getSamplerate()) * RenderSeconds);
+
+		std::vector<std::vector<float>> output;
+		TEST_ASSERT(renderer.render(output, length));
+		TEST_ASSERT(!output.empty() && output.front().size() >= length);
+
+		std::cout << "  " << name << " booted and rendered " << RenderSeconds << " seconds" << std::endl;
+	}
+}
+
+// Boots every synth with lockstep support that is part of the build and whose ROM can be found
+void testLockstepBoot()
+{
+	std::cout << "Testing device boot in lockstep mode..." << std::endl;
+
+	for (const auto type : {renderLib::SynthType::MicroQ, renderLib::SynthType::Xt, renderLib::SynthType::N2x})
+	{
+		// synths that are not part of the build are unknown to the factory
+		if(renderLib::DeviceFactory::getSynthType(renderLib::DeviceFactory::getSynthName(type)) == renderLib::SynthType::Invalid)
+			continue;
+
+		testBoot(type);
+	}
+
+	std::cout << "Lockstep boot tests passed" << std::endl;
+}
+
+int main()
+{
+	return baseLib::runUnitTests("Lockstep Boot", testLockstepBoot);
+}
@@ -17,21 +17,12 @@
 
 #include "synthLib/midiTypes.h"
 
+#include "baseLib/unitTest.h"
+
 #include <juce_core/juce_core.h>
 
 using namespace pluginLib;
 
-// Custom assertion that works in both Debug and Release builds
-#define TEST_ASSERT(condition) \
-	do { \
-		if (!(condition)) { \
-			std::ostringstream oss; \
-			oss << "Test assertion failed: " << #condition \
-			    << " at " << __FILE__ << ":" << __LINE__; \
-			throw std::runtime_error(oss.str()); \
-		} \
-	} while (0)
-
 void testMidiLearnMapping()
 {
 	std::cout << "Testing MidiLearnMapping..." << std::endl;
@@ -890,37 +881,18 @@ void testMidiLearnMixedTypes()
 
 int main()
 {
-	try
-	{
-		std::cout << "Running MIDI Learn Unit Tests..." << std::endl;
-		std::cout << std::endl;
-
-		testMidiLearnMapping();
-		testMidiLearnMappingSMidiEvent();
-		testMidiLearnPreset();
-		testMidiLearnManager();
-		testMidiLearnTranslatorBasics();
-		testMidiLearnFeedback();
-		testMidiLearnRelativeModes();
-		testMidiLearnModeDetection();
-		testMidiLearnPitchBend();
-		testMidiLearnChannelPressure();
-		testMidiLearnPolyPressure();
-		testMidiLearnInvert();
-		testMidiLearnMixedTypes();
-
-		std::cout << std::endl;
-		std::cout << "All tests passed successfully!" << std::endl;
-		return 0;
-	}
-	catch (const std::exception& e)
-	{
-		std::cerr << "Test failed with exception: " << e.what() << std::endl;
-		return 1;
-	}
-	catch (...)
-	{
-		std::cerr << "Test failed with unknown exception" << std::endl;
-		return 1;
-	}
+	return baseLib::runUnitTests("MIDI Learn",
+		testMidiLearnMapping,
+		testMidiLearnMappingSMidiEvent,
+		testMidiLearnPreset,
+		testMidiLearnManager,
+		testMidiLearnTranslatorBasics,
+		testMidiLearnFeedback,
+		testMidiLearnRelativeModes,
+		testMidiLearnModeDetection,
+		testMidiLearnPitchBend,
+		testMidiLearnChannelPressure,
+		testMidiLearnPolyPressure,
+		testMidiLearnInvert,
+		testMidiLearnMixedTypes);
 }
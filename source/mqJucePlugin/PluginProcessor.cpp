@@ -39,8 +39,9 @@ namespace mqJucePlugin
 #endif
 		, getOptions(), pluginLib::initProcessorProperties())
 	{
+		beginDeviceBoot();
 		getController();
-		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(getPlugin().getLatencyBlocks()));
+		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(synthLib::Plugin::DefaultLatencyBlocks));
 		Processor::setLatencyBlocks(latencyBlocks);
 	}
 
@@ -54,11 +55,14 @@ namespace mqJucePlugin
 		return new PluginEditorState(*this);
 	}
 
-	synthLib::Device* AudioPluginAudioProcessor::createDevice()
+	pluginLib::Processor::DeviceFactory AudioPluginAudioProcessor::getDeviceFactory()
 	{
 		synthLib::DeviceCreateParams p;
 		getRemoteDeviceParams(p);
-		return new mqLib::Device(p);
+		return [p]() -> synthLib::Device*
+		{
+			return wLib::Device::createPrebooted<mqLib::Device>(p);
+		};
 	}
 
 	void AudioPluginAudioProcessor::getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const
@@ -14,7 +14,7 @@ namespace mqJucePlugin
 
 	    jucePluginEditorLib::PluginEditorState* createEditorState() override;
 
-	    synthLib::Device* createDevice() override;
+	    DeviceFactory getDeviceFactory() override;
 		void getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const override;
 
 	    pluginLib::Controller* createController() override;
@@ -12,7 +12,7 @@
 
 namespace mqLib
 {
-	ROM initRom(const std::vector<uint8_t>& _romData, const std::string& _romName)
+	ROM initRom(const synthLib::RomImage& _romData, const std::string& _romName)
 	{
 		if(_romData.empty())
 			return RomLoader::findROM();
@@ -22,7 +22,7 @@ namespace mqLib
 		return RomLoader::findROM();
 	}
 
-	MicroQ::MicroQ(BootMode _bootMode/* = BootMode::Default*/, const std::vector<uint8_t>& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/)
+	MicroQ::MicroQ(BootMode _bootMode/* = BootMode::Default*/, const synthLib::RomImage& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/, const bool _lockstep/* = false*/)
 	{
 		const ROM romFile = initRom(_romData, _romName);
 
@@ -41,6 +41,8 @@ namespace mqLib
 
 		m_midiOutBuffer.reserve(1024);
 
+		m_hw->setLockstep(_lockstep);
+
 		m_ucThread.reset(new std::thread([&]()
 		{
 			dsp56k::ThreadTools::setCurrentThreadPriority(dsp56k::ThreadPriority::Highest);
@@ -124,10 +126,7 @@ namespace mqLib
 		const auto& dspOuts = m_hw->getAudioOutputs();
 
 		for(size_t c=0; c<dspOuts.size(); ++c)
-		{
-			for(uint32_t i=0; i<_frames; ++i)
-				_outputs[c][i] = dsp56k::dsp2sample<float>(dspOuts[c][i]);
-		}
+			m_dac.processBlock(_outputs[c], dspOuts[c].data(), _frames);
 	}
 
 	void MicroQ::process(uint32_t _frames, uint32_t _latency)
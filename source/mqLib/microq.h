@@ -11,6 +11,9 @@
 #include "leds.h"
 #include "mqtypes.h"
 
+#include "synthLib/dac.h"
+#include "synthLib/romCache.h"
+
 namespace synthLib
 {
 	struct SMidiEvent;
@@ -23,7 +26,8 @@ namespace mqLib
 	class MicroQ
 	{
 	public:
-		MicroQ(BootMode _bootMode = BootMode::Default, const std::vector<uint8_t>& _romData = {}, const std::string& _romName = {}, bool _voiceExpansion = false);
+		// _lockstep: the DSPs are executed by the microcontroller thread instead of running on threads of their own
+		MicroQ(BootMode _bootMode = BootMode::Default, const synthLib::RomImage& _romData = {}, const std::string& _romName = {}, bool _voiceExpansion = false, bool _lockstep = false);
 		~MicroQ();
 
 		// returns true if the instance is valid, false if the initialization failed
@@ -126,5 +130,7 @@ namespace mqLib
 		std::unique_ptr<std::thread> m_ucThread;
 		bool m_destroy = false;
 		std::atomic<uint32_t> m_dirtyFlags = 0;
+
+		synthLib::Dac m_dac;
 	};
 }
@@ -156,6 +156,13 @@ namespace mqLib
 		// is about to return and future calls will use the new callback.
 		setRuntimeCallbacks();
 
+		// in lockstep mode, the UC thread executes the DSP
+		if (m_hardware.isLockstep())
+		{
+			m_lockstepRunning = true;
+			return;
+		}
+
 #if DSP56300_DEBUGGER
 		m_thread.reset(new dsp56k::DSPThread(dsp(), m_name.c_str(), std::make_shared<dsp56kDebugger::Debugger>(m_dsp)));
 #else
@@ -167,6 +174,8 @@ namespace mqLib
 
 	void MqDsp::terminateThread()
 	{
+		m_lockstepRunning = false;
+
 		if (m_thread)
 		{
 			m_thread->terminate();
@@ -175,6 +184,20 @@ namespace mqLib
 		}
 	}
 
+	bool MqDsp::canExecLockstep()
+	{
+		if (!m_lockstepRunning)
+			return false;
+
+		// until the first ESAI frame has been produced, the firmware is still initializing and the audio interface
+		// does not consume any input yet. There is nothing to block on, waiting for host audio would stall the boot
+		if (m_hardware.getEsaiFrameIndex() == 0)
+			return true;
+
+		auto& esai = m_periphX.getEsai();
+		return !esai.getAudioInputs().empty() && !esai.getAudioOutputs().full();
+	}
+
 	void MqDsp::resetState()
 	{
 		// Reset DSP core and peripherals
@@ -236,7 +259,7 @@ namespace mqLib
 
 	void MqDsp::onUCRxEmpty(bool _needMoreData)
 	{
-		if (!m_thread)
+		if (!isRunning())
 			return;
 
 		hdi08().injectTXInterrupt();
@@ -256,7 +279,7 @@ namespace mqLib
 				// We can't block/sleep the UC (DSPs need ongoing UC interaction at
 				// real-time pace), but a scheduler yield gives DSP threads a chance
 				// to run without meaningfully slowing the UC.
-				std::this_thread::yield();
+				m_hardware.ucYieldToDSP();
 			}
 		}
 
@@ -322,7 +345,7 @@ namespace mqLib
 
 	void MqDsp::hdiSendIrqToDSP(uint8_t _irq)
 	{
-		if (!m_thread)
+		if (!isRunning())
 			return;
 
 		const auto cmd = static_cast<HostCommand>(_irq);
@@ -62,6 +62,10 @@ namespace mqLib
 		dsp56k::DSPThread& thread() { return *m_thread; }
 		bool haveSentTXToDSP() const { return m_haveSentTXtoDSP; }
 		bool hasThread() const { return m_thread != nullptr; }
+		bool isRunning() const { return m_thread != nullptr || m_lockstepRunning; }
+
+		// lockstep mode: true if the DSP is running and can process an audio frame without blocking
+		bool canExecLockstep();
 
 		bool receivedMagicEsaiPacket() const { return m_receivedMagicEsaiPacket; }
 		void onDspBootFinished();
@@ -96,6 +100,7 @@ namespace mqLib
 		uint32_t m_hdiDspToUcCount = 0;
 
 		std::unique_ptr<dsp56k::DSPThread> m_thread;
+		bool m_lockstepRunning = false;
 
 		bool m_receivedMagicEsaiPacket = false;
 		uint32_t m_hdiTransferFailCount = 0;
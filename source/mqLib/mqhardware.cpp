@@ -55,12 +55,21 @@ namespace mqLib
 			// Set ESAI clock dividers immediately so frame rates are aligned from
 			// the very first frame, including during boot.
 			setupEsaiClockDividers();
+
+			// Route ESAI frames along the DSP chain from the very first frame on
+			setupVoiceExpansionRouting();
 		}
 		else
 		{
 			m_dsps.push_back(std::make_unique<MqDsp>(*this, m_uc.getHdi08A().getHdi08(), 0));
 		}
 
+		for (auto& dsp : m_dsps)
+		{
+			auto* d = dsp.get();
+			m_lockstep.addUnit([d] { d->dsp().exec(); }, [d] { return d->canExecLockstep(); });
+		}
+
 		m_uc.getPortF().setDirectionChangeCallback([&](const mc68k::Port& _port)
 		{
 			if(_port.getDirection() == 0xff)
@@ -164,152 +173,133 @@ namespace mqLib
 		m_dsps[1]->getPeriph().getPortC().hostWrite(0x10);	// set bit 4 of GPIO Port C, vexp DSPs are waiting for this
 		m_dsps[2]->getPeriph().getPortC().hostWrite(0x10);	// set bit 4 of GPIO Port C, vexp DSPs are waiting for this
 
-		auto& esaiA = m_dsps[0]->getPeriph().getEsai();
-		auto& esaiB = m_dsps[1]->getPeriph().getEsai();
-		auto& esaiC = m_dsps[2]->getPeriph().getEsai();
-
-		// During boot, set empty callbacks on all ESAI interfaces to prevent DSP threads from blocking
-		esaiA.setCallback([](dsp56k::Audio*) {});
-		esaiB.setCallback([](dsp56k::Audio*) {});
-		esaiC.setCallback([](dsp56k::Audio*) {});
-
-		// Boot pump loop: route ESAI data along the chain (ADC→B→C→A→DAC).
-		// Physical wiring: B's SDI0/RX0 is connected to the ADC (silence during
-		// boot), B TX1→C RX1, C TX1→A RX1. There is no A→B ESAI link.
-		// We feed empty frames to B (simulating ADC silence), route B→C and C→A,
-		// and drain A's TX output. DSP A sends 0x654300 via HDI08 TX when ready.
-		uint32_t loopCount = 0;
-		uint32_t routedBC = 0, routedCA = 0;
-		uint32_t lastStatusLog = 0;
-
-		m_inBootPump = true;
-		m_veResetCount = 0;
-
-		while (true)
+		// Wait until the UC firmware signals boot complete AND the chain has
+		// routed data (C→A confirms B→C→A path is working). Routing is done by
+		// the ESAI callbacks installed in the constructor, we are notified by
+		// them and by the UC, there is nothing to do for us in the meantime.
 		{
-			{
-				// Mutex protects ESAI buffers from concurrent access during
-				// DSP state reset (resetState drains/primes ESAI buffers)
-				std::lock_guard lock(m_esaiBootMutex);
-
-				auto& txOutA = esaiA.getAudioOutputs();
-				auto& txOutB = esaiB.getAudioOutputs();
-				auto& txOutC = esaiC.getAudioOutputs();
-				auto& rxInB  = esaiB.getAudioInputs();
-				auto& rxInC  = esaiC.getAudioInputs();
-				auto& rxInA  = esaiA.getAudioInputs();
-
-				// ADC → B: feed silence (empty frames) to B's RX, simulating the ADC
-				if (rxInB.empty())
-					rxInB.push_back({});
-
-				// B TX → C RX
-				while (!txOutB.empty() && !rxInC.full())
-				{
-					dsp56k::Audio::RxFrame rx;
-					txToRx(txOutB.pop_front(), rx);
-					rxInC.push_back(std::move(rx));
-					++routedBC;
-				}
-
-				// C TX → A RX
-				while (!txOutC.empty() && !rxInA.full())
-				{
-					dsp56k::Audio::RxFrame rx;
-					txToRx(txOutC.pop_front(), rx);
-					rxInA.push_back(std::move(rx));
-					++routedCA;
-				}
-
-				// Drain A's TX output (goes to DAC on real hardware, nowhere useful during boot)
-				while (!txOutA.empty())
-					txOutA.pop_front();
-			}
-
-			++loopCount;
+			std::unique_lock lock(m_veBootMutex);
 
-			// Periodic status logging
-			if (loopCount - lastStatusLog >= 5000000)
+			while (!m_veBootCv.wait_for(lock, std::chrono::seconds(5), [this] { return m_bootCompleted && m_veRoutedFramesCA > 0; }))
 			{
-				lastStatusLog = loopCount;
-				LOG("Boot pump status: loop=" << loopCount
-					<< " BC=" << routedBC << " CA=" << routedCA
+				LOG("Voice Expansion boot still in progress: CA=" << m_veRoutedFramesCA
 					<< " resets=" << m_veResetCount
 					<< " bootCompleted=" << m_bootCompleted
-					<< " threads=" << m_dsps[0]->hasThread() << m_dsps[1]->hasThread() << m_dsps[2]->hasThread());
+					<< " running=" << m_dsps[0]->isRunning() << m_dsps[1]->isRunning() << m_dsps[2]->isRunning());
 			}
-
-			// Exit when UC firmware signals boot complete AND the chain has
-			// routed data (C→A confirms B→C→A path is working)
-			if (m_bootCompleted && routedCA > 0)
-				break;
-
-			std::this_thread::yield();
 		}
 
 		LOG("Voice Expansion initialization completed after " << m_veResetCount << " resets");
 
-		// Block further DSP resets BEFORE clearing boot pump flag.
-		// Otherwise the UC thread can see m_inBootPump=false while
-		// m_voiceExpansionReady is still false and do a direct reset.
+		// Block further DSP resets. From now on, the routing callbacks pass
+		// every frame on instead of dropping frames that do not fit.
 		m_voiceExpansionReady = true;
-		m_inBootPump = false;
 
 		// ESAI clock dividers were already set in the Hardware constructor
 		// (before any DSP threads started) to ensure frame rates are aligned
 		// from the very first frame.
 
-		// Drain any stale boot-time output
-		for (auto& dsp : m_dsps)
-		{
-			auto& out = dsp->getPeriph().getEsai().getAudioOutputs();
-			auto& in  = dsp->getPeriph().getEsai().getAudioInputs();
-			while (!out.empty() || !in.empty())
-				out.pop_front();
-		}
+		// Drain any stale boot-time output. B and C write their output via
+		// the routing callbacks, only A uses its output ring
+		auto& outA = m_dsps[0]->getPeriph().getEsai().getAudioOutputs();
+		while (!outA.empty())
+			outA.pop_front();
 
 		// Set up A's ESAI callback for frame counting + CV notification
 		setupEsaiListener();
 
-		// Post-boot ESAI chain routing: B→C and C→A via direct TX callbacks.
-		// These fire from the DSP thread when a TX frame completes, bypassing
-		// the TX output ring buffer entirely. Audio input is fed to DSP B in
-		// processAudio (ADC→B→C→A→DAC).
+		// Prefill DSP B (the ADC-facing expansion DSP in the chain ADC→B→C→A→DAC)
+		// to give the VE pipeline enough slack to absorb per-callback jitter.
+		m_dsps[1]->getPeriph().getEsai().writeEmptyAudioIn(64);
+
+		/*
+		// Dump all DSP P memories as disassembly
+		const char* dspNames[] = {"A", "B", "C"};
+		for (uint32_t i = 0; i < m_dsps.size(); ++i)
+		{
+			const auto filename = std::string("e:\\mqDsp") + dspNames[i] + "_P.asm";
+			const auto& mem = m_dsps[i]->dsp().memory();
+			mem.saveAssembly(filename.c_str(), 0, MqDsp::g_pMemSize, false, false, m_dsps[i]->dsp().getPeriph(0), m_dsps[i]->dsp().getPeriph(1));
+			LOG("Saved DSP " << dspNames[i] << " P memory to " << filename);
+		}
+		*/
+	}
+
+	void Hardware::setupVoiceExpansionRouting()
+	{
+		// ESAI chain routing: B→C and C→A via direct TX callbacks.
+		// Physical wiring: B's SDI0/RX0 is connected to the ADC, B TX1→C RX1,
+		// C TX1→A RX1. There is no A→B ESAI link. These fire from the DSP
+		// thread when a TX frame completes, bypassing the TX output ring
+		// buffer entirely. Audio input is fed to DSP B in processAudio
+		// (ADC→B→C→A→DAC).
+		//
+		// During boot, nobody consumes audio and DSPs may be reset at any
+		// time. Frames that do not fit are dropped then, a DSP thread must
+		// never block in a callback or it cannot be terminated.
 
-		auto& rxInC = m_dsps[2]->getPeriph().getEsai().getAudioInputs();
-		auto& rxInA = m_dsps[0]->getPeriph().getEsai().getAudioInputs();
+		auto& esaiA = m_dsps[0]->getPeriph().getEsai();
+		auto& esaiB = m_dsps[1]->getPeriph().getEsai();
+		auto& esaiC = m_dsps[2]->getPeriph().getEsai();
 
-		m_dsps[1]->getPeriph().getEsai().setWriteTxCallback([&rxInC](uint64_t& _frameIndex, const dsp56k::Audio::TxFrame& _tx)
+		auto& rxInC = esaiC.getAudioInputs();
+		auto& rxInA = esaiA.getAudioInputs();
+		auto& rxInB = esaiB.getAudioInputs();
+		auto& txOutA = esaiA.getAudioOutputs();
+
+		esaiB.setWriteTxCallback([this, &rxInC](uint64_t& _frameIndex, const dsp56k::Audio::TxFrame& _tx)
 		{
+			++_frameIndex;
+
+			if (!m_voiceExpansionReady && rxInC.full())
+				return;
+
 			dsp56k::Audio::RxFrame rx;
 			txToRx(_tx, rx);
 			rxInC.push_back(std::move(rx));
-			++_frameIndex;
 		});
 
-		m_dsps[2]->getPeriph().getEsai().setWriteTxCallback([&rxInA](uint64_t& _frameIndex, const dsp56k::Audio::TxFrame& _tx)
+		esaiC.setWriteTxCallback([this, &rxInA](uint64_t& _frameIndex, const dsp56k::Audio::TxFrame& _tx)
 		{
+			++_frameIndex;
+
+			if (!m_voiceExpansionReady)
+			{
+				if (rxInA.full())
+					return;
+				if (m_veRoutedFramesCA++ == 0)
+					notifyVoiceExpansionBoot();
+			}
+
 			dsp56k::Audio::RxFrame rx;
 			txToRx(_tx, rx);
 			rxInA.push_back(std::move(rx));
-			++_frameIndex;
 		});
 
-		// Prefill DSP B (the ADC-facing expansion DSP in the chain ADC→B→C→A→DAC)
-		// to give the VE pipeline enough slack to absorb per-callback jitter.
-		m_dsps[1]->getPeriph().getEsai().writeEmptyAudioIn(64);
+		// During boot, feed silence to B, simulating the ADC, and drain A's
+		// TX output (goes to DAC on real hardware, nowhere useful during boot).
+		// Once booted, processAudio takes over and A's callback is replaced
+		esaiA.setCallback([this, &txOutA](dsp56k::Audio*)
+		{
+			while (!m_voiceExpansionReady && !txOutA.empty())
+				txOutA.pop_front();
+		});
 
-		/*
-		// Dump all DSP P memories as disassembly
-		const char* dspNames[] = {"A", "B", "C"};
-		for (uint32_t i = 0; i < m_dsps.size(); ++i)
+		esaiB.setCallback([this, &rxInB](dsp56k::Audio*)
 		{
-			const auto filename = std::string("e:\\mqDsp") + dspNames[i] + "_P.asm";
-			const auto& mem = m_dsps[i]->dsp().memory();
-			mem.saveAssembly(filename.c_str(), 0, MqDsp::g_pMemSize, false, false, m_dsps[i]->dsp().getPeriph(0), m_dsps[i]->dsp().getPeriph(1));
-			LOG("Saved DSP " << dspNames[i] << " P memory to " << filename);
+			while (!m_voiceExpansionReady && rxInB.size() < 2)
+				rxInB.push_back({});
+		});
+
+		esaiC.setCallback([](dsp56k::Audio*) {});
+	}
+
+	void Hardware::notifyVoiceExpansionBoot()
+	{
+		{
+			std::lock_guard lock(m_veBootMutex);
 		}
-		*/
+		m_veBootCv.notify_all();
 	}
 
 	void Hardware::setupEsaiClockDividers()
@@ -358,22 +348,22 @@ namespace mqLib
 #ifdef _DEBUG
 				LOG("DSP reset requested (count " << (m_veResetCount + 1) << ")");
 #endif
-				// Phase 1: Terminate DSP threads WITHOUT holding the mutex.
-				// The boot pump continues draining ESAI outputs, which unblocks
-				// any DSP thread stuck in Audio::writeTXimpl::waitNotFull().
+				// Phase 1: Terminate DSP threads. The boot routing callbacks never
+				// block, A's output is drained by its ESAI callback, so no DSP
+				// thread can be stuck in Audio::writeTXimpl::waitNotFull().
 				for (auto& dsp : m_dsps)
 					dsp->terminateThread();
 
-				// Phase 2: Lock mutex and reset DSP state (ESAI, P-memory, etc.)
-				// The boot pump waits on the mutex during this brief phase.
-				{
-					std::lock_guard lock(m_esaiBootMutex);
-					for (auto& dsp : m_dsps)
-						dsp->resetState();
+				// Phase 2: Reset DSP state (ESAI, P-memory, etc.). No DSP is
+				// running, nobody else touches the ESAI buffers now
+				for (auto& dsp : m_dsps)
+					dsp->resetState();
 
-					// Re-apply ESAI clock dividers cleared by resetHW()
-					setupEsaiClockDividers();
-				}
+				// Re-apply ESAI clock dividers cleared by resetHW()
+				setupEsaiClockDividers();
+
+				if (m_useVoiceExpansion)
+					setupVoiceExpansionRouting();
 
 				++m_veResetCount;
 				m_dspResetPending = true;
@@ -392,6 +382,7 @@ namespace mqLib
 		m_midi.write({0xf0,0x3e,0x10,0x7f,0x24,0x00,0x08,0x01,0xf7});	// Control Receive = on
 		m_bootCompleted = true;
 		LOG("Boot completed (m_bootCompleted=true)");
+		notifyVoiceExpansionBoot();
 
 		/*
 		if (m_dsps.size() == 1)
@@ -410,8 +401,6 @@ namespace mqLib
 		if(m_esaiFrameIndex == 0)
 			return;
 
-		m_midi.process(_frames);
-
 		beginProcessAudio();
 
 		auto& esai = m_dsps.front()->getPeriph().getEsai();
@@ -454,6 +443,7 @@ namespace mqLib
 				// Feed host audio input to DSP B (the expansion DSP whose
 				// SDI0/RX0 is wired to the ADC on real hardware).
 				m_dsps[1]->getPeriph().getEsai().processAudioInputInterleaved(inputs, processCount, _latency);
+				notifyLockstep();
 
 				// Batch the output drain: wait once for DSP A's TX to have
 				// enough frames rather than blocking per-frame in the pop loop
@@ -501,6 +491,7 @@ namespace mqLib
 			else
 			{
 				esai.processAudioInputInterleaved(inputs, processCount, _latency);
+				notifyLockstep();
 
 				const auto requiredSize = processCount > 8 ? processCount - 8 : 0;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -71,6 +73,8 @@ namespace mqLib
 	private:
 		void setupEsaiListener();
 		void setupEsaiClockDividers();
+		void setupVoiceExpansionRouting();
+		void notifyVoiceExpansionBoot();
 		void hdiProcessUCtoDSPNMIIrq();
 		void processUcCycle();
 		void setGlobalDefaultParameters();
@@ -80,10 +84,11 @@ namespace mqLib
 
 		bool m_requestNMI = false;
 		bool m_dspResetPending = false;
-		bool m_voiceExpansionReady = false;
-		bool m_inBootPump = false;
+		std::atomic<bool> m_voiceExpansionReady{false};
 		uint32_t m_veResetCount = 0;
-		dsp56k::Mutex m_esaiBootMutex;
+		std::atomic<uint32_t> m_veRoutedFramesCA{0};
+		std::mutex m_veBootMutex;
+		std::condition_variable m_veBootCv;
 
 		MqMc m_uc;
 		TAudioInputs m_audioInputs;
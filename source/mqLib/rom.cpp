@@ -9,7 +9,7 @@ namespace mqLib
 		verifyRom();
 	}
 
-	ROM::ROM(const std::vector<uint8_t>& _data, const std::string& _name) : wLib::ROM(_name, g_romSize, _data)
+	ROM::ROM(const synthLib::RomImage& _data, const std::string& _name) : wLib::ROM(_name, g_romSize, _data)
 	{
 		verifyRom();
 	}
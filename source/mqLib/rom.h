@@ -11,7 +11,7 @@ namespace mqLib
 
 		ROM() = default;
 		explicit ROM(const std::string& _filename);
-		explicit ROM(const std::vector<uint8_t>& _data, const std::string& _name);
+		explicit ROM(const synthLib::RomImage& _data, const std::string& _name);
 
 		static constexpr uint32_t size() { return g_romSize; }
 
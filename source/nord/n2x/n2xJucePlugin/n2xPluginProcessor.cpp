@@ -35,8 +35,9 @@ namespace n2xJucePlugin
 	                   .withOutput("Out CD", juce::AudioChannelSet::stereo(), true)
 		, getOptions(), pluginLib::initProcessorProperties())
 	{
+		beginDeviceBoot();
 		getController();
-		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(getPlugin().getLatencyBlocks()));
+		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(synthLib::Plugin::DefaultLatencyBlocks));
 		Processor::setLatencyBlocks(latencyBlocks);
 	}
 
@@ -50,12 +51,15 @@ namespace n2xJucePlugin
 		return new PluginEditorState(*this);
 	}
 
-	synthLib::Device* AudioPluginAudioProcessor::createDevice()
+	pluginLib::Processor::DeviceFactory AudioPluginAudioProcessor::getDeviceFactory()
 	{
-		auto* d = new n2x::Device({});
-		if(!d->isValid())
-			throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, "A firmware rom (512k .bin) is required, but was not found.");
-		return d;
+		return []() -> synthLib::Device*
+		{
+			auto* d = new n2x::Device({});
+			if(!d->isValid())
+				throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, "A firmware rom (512k .bin) is required, but was not found.");
+			return d;
+		};
 	}
 
 	void AudioPluginAudioProcessor::getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const
@@ -66,7 +70,7 @@ namespace n2xJucePlugin
 
 		if(rom.isValid())
 		{
-			_params.romData.assign(rom.data().begin(), rom.data().end());
+			_params.romData = rom.data();
 			_params.romName = rom.getFilename();
 		}
 	}
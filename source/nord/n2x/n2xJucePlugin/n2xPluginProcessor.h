@@ -11,7 +11,7 @@ namespace n2xJucePlugin
 	    ~AudioPluginAudioProcessor() override;
 
 	    jucePluginEditorLib::PluginEditorState* createEditorState() override;
-	    synthLib::Device* createDevice() override;
+	    DeviceFactory getDeviceFactory() override;
 		void getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const override;
 
 	    pluginLib::Controller* createController() override;
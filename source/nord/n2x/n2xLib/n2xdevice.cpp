@@ -7,7 +7,7 @@ namespace n2x
 {
 	Device::Device(const synthLib::DeviceCreateParams& _params)
 		: synthLib::Device(_params)
-		, m_hardware(_params.romData, _params.romName)
+		, m_hardware(_params.romData, _params.romName, (_params.customData & 2) != 0)
 		, m_state(&m_hardware, &getMidiTranslator())
 		, m_midiParser(synthLib::MidiEventSource::Device)
 	{
@@ -18,6 +18,12 @@ namespace n2x
 		return g_samplerate;
 	}
 
+	uint32_t Device::getInternalLatencyMidiToOutput() const
+	{
+		// Midi is processed in sync with DSP B but reaches DSP A, which runs ahead of DSP B
+		return m_hardware.getDspAtoBLookahead();
+	}
+
 	bool Device::isValid() const
 	{
 		return m_hardware.isValid();
@@ -23,6 +23,7 @@ namespace n2x
 		bool setDspClockPercent(uint32_t _percent) override;
 		uint32_t getDspClockPercent() const override;
 		uint64_t getDspClockHz() const override;
+		uint32_t getInternalLatencyMidiToOutput() const override;
 
 	protected:
 		void readMidiOut(std::vector<synthLib::SMidiEvent>& _midiOut) override;
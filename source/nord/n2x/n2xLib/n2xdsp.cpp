@@ -112,7 +112,10 @@ namespace n2x
 
 		m_irqInterruptDone = dsp().registerInterruptFunc([this]
 		{
-			m_triggerInterruptDone.notify();
+			if(m_hardware.isLockstep())
+				++m_lockstepInterruptDoneCount;
+			else
+				m_triggerInterruptDone.notify();
 		});
 	}
 
@@ -136,6 +139,13 @@ namespace n2x
 			hdiTransferUCtoDSP(_word);
 		});
 
+		// in lockstep mode, the UC thread executes the DSP
+		if(m_hardware.isLockstep())
+		{
+			m_lockstepRunning = true;
+			return;
+		}
+
 #if DSP56300_DEBUGGER
 		if(!m_index)
 			m_thread.reset(new dsp56k::DSPThread(dsp(), m_name.c_str(), std::make_shared<dsp56kDebugger::Debugger>(m_dsp)));
@@ -148,7 +158,14 @@ namespace n2x
 
 	void DSP::onUCRxEmpty(const bool _needMoreData)
 	{
-		if(_needMoreData)
+		if(_needMoreData && m_hardware.isLockstep())
+		{
+			m_hardware.lockstepExecUntil([this]
+			{
+				return !dsp().hasPendingInterrupts();
+			});
+		}
+		else if(_needMoreData)
 		{
 			dsp56k::ScopedResumeDSP rA(m_hardware.getDSPA().getHaltDSP());
 			dsp56k::ScopedResumeDSP rB(m_hardware.getDSPB().getHaltDSP());
@@ -183,6 +200,18 @@ namespace n2x
 			const_cast<uint64_t&>(dsp().getInstructionCounter()) = numOps;
 			const_cast<uint64_t&>(dsp().getCycles()) = numCycles;
 		}
+		else if(m_hardware.isLockstep())
+		{
+			const auto doneCount = m_lockstepInterruptDoneCount;
+
+			dsp().injectExternalInterrupt(_irq);
+			dsp().injectExternalInterrupt(m_irqInterruptDone);
+
+			m_hardware.lockstepExecUntil([&]
+			{
+				return m_lockstepInterruptDoneCount != doneCount;
+			});
+		}
 		else
 		{
 			dsp().injectExternalInterrupt(_irq);
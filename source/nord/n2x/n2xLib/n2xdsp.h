@@ -47,6 +47,8 @@ namespace n2x
 		void join() const;
 		void onDspBootFinished();
 
+		bool isLockstepRunning() const { return m_lockstepRunning; }
+
 	private:
 		void onUCRxEmpty(bool _needMoreData);
 		void hdiTransferUCtoDSP(uint32_t _word);
@@ -66,9 +68,11 @@ namespace n2x
 		dsp56k::DSP m_dsp;
 
 		std::unique_ptr<dsp56k::DSPThread> m_thread;
+		bool m_lockstepRunning = false;
 
 		dsp56k::SpscSemaphore m_triggerInterruptDone;
 		uint32_t m_irqInterruptDone = 0;
+		uint32_t m_lockstepInterruptDoneCount = 0;	// lockstep mode: replaces m_triggerInterruptDone
 
 		dsp56k::HaltDSP m_haltDSP;
 
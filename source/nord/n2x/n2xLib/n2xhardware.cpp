@@ -4,15 +4,19 @@
 #include "dsp56kBase/threadtools.h"
 #include "synthLib/deviceException.h"
 
+#include <algorithm>
+
 namespace n2x
 {
 	constexpr uint32_t g_syncEsaiFrameRate = 16;
 	constexpr uint32_t g_syncHaltDspEsaiThreshold = 32;
+	constexpr uint32_t g_lockstepPreEsaiUcInterval = 256;	// lockstep mode: UC instructions per DSP slice until ESAI is running
 
 	static_assert((g_syncEsaiFrameRate & (g_syncEsaiFrameRate - 1)) == 0, "esai frame sync rate must be power of two");
 	static_assert(g_syncHaltDspEsaiThreshold >= g_syncEsaiFrameRate * 2, "esai DSP halt threshold must be greater than two times the sync rate");
+	static_assert((g_lockstepPreEsaiUcInterval & (g_lockstepPreEsaiUcInterval - 1)) == 0, "lockstep UC interval must be power of two");
 
-	Rom initRom(const std::vector<uint8_t>& _romData, const std::string& _romName)
+	Rom initRom(const synthLib::RomImage& _romData, const std::string& _romName)
 	{
 		if(_romData.empty())
 			return RomLoader::findROM();
@@ -22,13 +26,16 @@ namespace n2x
 		return RomLoader::findROM();
 	}
 
-	Hardware::Hardware(const std::vector<uint8_t>& _romData, const std::string& _romName)
+	Hardware::Hardware(const synthLib::RomImage& _romData, const std::string& _romName, const bool _lockstep/* = false*/, const uint32_t _dspAtoBLookahead/* = DefaultDspAtoBLookahead*/)
 		: m_rom(initRom(_romData, _romName))
 		, m_uc(*this, m_rom)
 		, m_dspA(*this, m_uc.getHdi08A(), 0)
 		, m_dspB(*this, m_uc.getHdi08B(), 1)
 		, m_samplerateInv(1.0 / g_samplerate)
-		, m_semDspAtoB(2)
+		, m_dspAtoBLookahead(std::max(1u, _dspAtoBLookahead))
+		, m_semDspAtoB(static_cast<int>(m_dspAtoBLookahead))
+		, m_lockstepEnabled(_lockstep)
+		, m_lockstepAtoBCredits(static_cast<int32_t>(m_dspAtoBLookahead))
 	{
 		if(!m_rom.isValid())
 			throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, "No firmware found, expected firmware .bin with a size of " + std::to_string(Rom::MySize) + " bytes");
@@ -36,6 +43,9 @@ namespace n2x
 		m_dspA.getPeriph().getEsai().setCallback([this](dsp56k::Audio*){ onEsaiCallbackA(); });
 		m_dspB.getPeriph().getEsai().setCallback([this](dsp56k::Audio*){ onEsaiCallbackB(); });
 
+		m_lockstep.addUnit([this] { m_dspA.dsp().exec(); }, [this] { return canExecLockstepA(); });
+		m_lockstep.addUnit([this] { m_dspB.dsp().exec(); }, [this] { return canExecLockstepB(); });
+
 		m_ucThread.reset(new std::thread([this]
 		{
 			ucThreadFunc();
@@ -48,6 +58,15 @@ namespace n2x
 
 	Hardware::~Hardware()
 	{
+		if(m_lockstepEnabled)
+		{
+			// the UC thread runs the DSPs, there are no DSP threads to wake up
+			m_destroy = true;
+			notifyLockstep();
+			m_ucThread->join();
+			return;
+		}
+
 		m_destroy = true;
 
 		while(m_destroy)
@@ -94,8 +113,6 @@ namespace n2x
 
 	void Hardware::processAudio(uint32_t _frames, const uint32_t _latency)
 	{
-		getMidi().process(_frames);
-
 		ensureBufferSize(_frames);
 
 		dsp56k::TWord* outputs[12]{nullptr};
@@ -143,6 +160,9 @@ namespace n2x
 			// read output of DSP B to regular audio output
 			esaiB.processAudioOutputInterleaved(outputs, processCount);
 
+			if(m_lockstepEnabled)
+				notifyLockstep();
+
 			outputs[0] += processCount;
 			outputs[1] += processCount;
 			outputs[2] += processCount;
@@ -154,13 +174,8 @@ namespace n2x
 	{
 		processAudio(_frames, _latency);
 
-		for(size_t i=0; i<_frames; ++i)
-		{
-			_outputs[0][i] = dsp56k::dsp2sample<float>(m_audioOutputs[0][i]);
-			_outputs[1][i] = dsp56k::dsp2sample<float>(m_audioOutputs[1][i]);
-			_outputs[2][i] = dsp56k::dsp2sample<float>(m_audioOutputs[2][i]);
-			_outputs[3][i] = dsp56k::dsp2sample<float>(m_audioOutputs[3][i]);
-		}
+		for(size_t c=0; c<m_audioOutputs.size(); ++c)
+			m_dac.processBlock(_outputs[c], m_audioOutputs[c].data(), _frames);
 	}
 
 	bool Hardware::sendMidi(const synthLib::SMidiEvent& _ev)
@@ -184,8 +199,6 @@ namespace n2x
 
 		for (auto& audioOutput : m_audioOutputs)
 			audioOutput.resize(_frames, 0);
-
-		m_dspAtoBBuffer.resize(_frames * 4);
 	}
 
 	void Hardware::onEsaiCallbackA()
@@ -193,7 +206,8 @@ namespace n2x
 		// forward DSP A output to DSP B input
 		const auto out = m_dspA.getPeriph().getEsai().getAudioOutputs().pop_front();
 
-		dsp56k::Audio::RxFrame in;
+		// the frame is reused to not allocate memory once per sample
+		auto& in = m_dspAtoBFrame;
 		in.resize(out.size());
 
 		in[0] = dsp56k::Audio::RxSlot{out[0][0]};
@@ -203,7 +217,11 @@ namespace n2x
 
 		m_dspB.getPeriph().getEsai().getAudioInputs().push_back(in);
 
-		m_semDspAtoB.wait();
+		// DSP A only blocks if it is m_dspAtoBLookahead frames ahead of DSP B, both DSPs run in parallel otherwise
+		if(m_lockstepEnabled)
+			--m_lockstepAtoBCredits;
+		else
+			m_semDspAtoB.wait();
 	}
 
 	void Hardware::processMidiInput()
@@ -217,14 +235,23 @@ namespace n2x
 			if(e.offset > m_midiOffsetCounter)
 				break;
 
-			getMidi().write(e);
+			// the SCI ring is full, retry later
+			if(!getMidi().write(e))
+				break;
+
 			m_midiIn.pop_front();
 		}
+
+		// forward the MIDI data of this frame to the QSM, sysex is paced and may take longer
+		getMidi().process(1);
 	}
 
 	void Hardware::onEsaiCallbackB()
 	{
-		m_semDspAtoB.notify();
+		if(m_lockstepEnabled)
+			++m_lockstepAtoBCredits;
+		else
+			m_semDspAtoB.notify();
 
 		++m_esaiFrameIndex;
 
@@ -245,7 +272,10 @@ namespace n2x
 			m_requestedFramesAvailableMutex.unlock();
 		}
 
-		m_haltDSPSem.wait(1);
+		if(m_lockstepEnabled)
+			--m_lockstepFrameBudget;
+		else
+			m_haltDSPSem.wait(1);
 	}
 
 	void Hardware::syncUCtoDSP()
@@ -254,13 +284,28 @@ namespace n2x
 
 		// we can only use ESAI to clock the uc once it has been enabled
 		if(m_esaiFrameIndex <= 0)
+		{
+			// without a clock, lockstep mode interleaves UC and DSPs at a fixed rate
+			if(m_lockstepEnabled && (++m_lockstepUcCounter & (g_lockstepPreEsaiUcInterval-1)) == 0)
+				m_lockstep.execSlice();
 			return;
+		}
 
 		if(m_esaiFrameIndex == m_lastEsaiFrameIndex)
 		{
-			resumeDSPs();
-			std::unique_lock uLock(m_esaiFrameAddedMutex);
-			m_esaiFrameAddedCv.wait(uLock, [this]{return m_esaiFrameIndex > m_lastEsaiFrameIndex;});
+			if(m_lockstepEnabled)
+			{
+				lockstepExecUntil([this]
+				{
+					return m_esaiFrameIndex > m_lastEsaiFrameIndex;
+				});
+			}
+			else
+			{
+				resumeDSPs();
+				std::unique_lock uLock(m_esaiFrameAddedMutex);
+				m_esaiFrameAddedCv.wait(uLock, [this]{return m_esaiFrameIndex > m_lastEsaiFrameIndex;});
+			}
 		}
 
 		const auto esaiFrameIndex = m_esaiFrameIndex;
@@ -281,7 +326,8 @@ namespace n2x
 		// and consume them
 		m_remainingUcCyclesD -= static_cast<double>(m_remainingUcCycles);
 
-		if(esaiDelta > g_syncHaltDspEsaiThreshold)
+		// in lockstep mode, the DSPs never run ahead of the UC
+		if(esaiDelta > g_syncHaltDspEsaiThreshold && !m_lockstepEnabled)
 			haltDSPs();
 
 		m_lastEsaiFrameIndex = esaiFrameIndex;
@@ -319,7 +365,15 @@ namespace n2x
 
 		if (notifyCount > 0)
 		{
-			m_haltDSPSem.notify(notifyCount);
+			if(m_lockstepEnabled)
+			{
+				m_lockstepFrameBudget += notifyCount;
+				notifyLockstep();
+			}
+			else
+			{
+				m_haltDSPSem.notify(notifyCount);
+			}
 			m_dspNotifyCorrection = 0;
 		}
 		else
@@ -328,6 +382,55 @@ namespace n2x
 		}
 	}
 
+	void Hardware::lockstepExecUntil(const std::function<bool()>& _done)
+	{
+		while(!_done() && !m_destroy)
+		{
+			if(m_lockstep.execSlice())
+				continue;
+
+			// both DSPs are blocked, wait for the audio thread to request more frames or to read output.
+			// The timeout is a safety net only, every state change that unblocks a DSP notifies us
+			std::unique_lock lock(m_lockstepMutex);
+			m_lockstepCv.wait_for(lock, std::chrono::milliseconds(1), [&]
+			{
+				return _done() || m_destroy || m_lockstep.canExec();
+			});
+		}
+	}
+
+	void Hardware::notifyLockstep()
+	{
+		// lock to prevent that the notification gets lost if the waiter is between its check and the wait
+		{
+			std::lock_guard lock(m_lockstepMutex);
+		}
+		m_lockstepCv.notify_one();
+	}
+
+	bool Hardware::canExecLockstepA()
+	{
+		// DSP A pushes one frame to DSP B per ESAI frame
+		return m_dspA.isLockstepRunning() && m_lockstepAtoBCredits > 0 && !m_dspB.getPeriph().getEsai().getAudioInputs().full();
+	}
+
+	bool Hardware::canExecLockstepB()
+	{
+		if(!m_dspB.isLockstepRunning())
+			return false;
+
+		// until the first ESAI frame has been produced, the firmware is still initializing and neither consumes
+		// input nor needs a frame budget. Waiting for host audio would stall the boot
+		if(m_esaiFrameIndex == 0)
+			return true;
+
+		if(m_lockstepFrameBudget <= 0)
+			return false;
+
+		auto& esai = m_dspB.getPeriph().getEsai();
+		return !esai.getAudioInputs().empty() && !esai.getAudioOutputs().full();
+	}
+
 	void Hardware::haltDSPs()
 	{
 		if(m_dspHalted)
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
 #include "n2xdsp.h"
 #include "n2xmc.h"
 #include "n2xrom.h"
 
+#include "hardwareLib/lockstep.h"
+
 #include "synthLib/audioTypes.h"
+#include "synthLib/dac.h"
 #include "synthLib/midiTypes.h"
 
 namespace n2x
@@ -13,7 +21,14 @@ namespace n2x
 	{
 	public:
 		using AudioOutputs = std::array<std::vector<dsp56k::TWord>, 4>;
-		Hardware(const std::vector<uint8_t>& _romData = {}, const std::string& _romName = {});
+
+		// number of frames that DSP A may compute ahead of DSP B
+		static constexpr uint32_t DefaultDspAtoBLookahead = 16;
+
+		// _lockstep: the DSPs are executed by the microcontroller thread instead of running on threads of their own
+		// _dspAtoBLookahead: DSP A runs up to this many frames ahead of DSP B so that both DSP threads can run in
+		// parallel. Adds the same amount of frames to the latency between Midi input and audio output
+		Hardware(const synthLib::RomImage& _romData = {}, const std::string& _romName = {}, bool _lockstep = false, uint32_t _dspAtoBLookahead = DefaultDspAtoBLookahead);
 		~Hardware();
 
 		bool isValid() const;
@@ -47,6 +62,14 @@ namespace n2x
 
 		const std::string& getRomFilename() const { return m_rom.getFilename(); }
 
+		uint32_t getDspAtoBLookahead() const { return m_dspAtoBLookahead; }
+
+		bool isLockstep() const { return m_lockstepEnabled; }
+		hwLib::Lockstep& getLockstep() { return m_lockstep; }
+
+		// lockstep mode: executes the DSPs on the calling thread until _done returns true
+		void lockstepExecUntil(const std::function<bool()>& _done);
+
 	private:
 		void ensureBufferSize(uint32_t _frames);
 		void onEsaiCallbackA();
@@ -55,6 +78,9 @@ namespace n2x
 		void syncUCtoDSP();
 		void ucThreadFunc();
 		void advanceSamples(uint32_t _samples, uint32_t _latency);
+		void notifyLockstep();
+		bool canExecLockstepA();
+		bool canExecLockstepB();
 
 		Rom m_rom;
 		Microcontroller m_uc;
@@ -63,9 +89,9 @@ namespace n2x
 
 		std::vector<dsp56k::TWord> m_dummyInput;
 		std::vector<dsp56k::TWord> m_dummyOutput;
-		std::vector<dsp56k::TWord> m_dspAtoBBuffer;
 
 		AudioOutputs m_audioOutputs;
+		synthLib::Dac m_dac;
 
 		// timing
 		const double m_samplerateInv;
@@ -79,9 +105,12 @@ namespace n2x
 		dsp56k::ConditionVariable m_requestedFramesAvailableCv;
 		size_t m_requestedFrames = 0;
 		bool m_dspHalted = false;
-		dsp56k::SpscSemaphore m_semDspAtoB;
 
-		dsp56k::RingBuffer<dsp56k::Audio::RxFrame, 4, true> m_dspAtoBbuf;
+		// DSP A to DSP B pipeline. Frames are pushed to the ESAI input ring of DSP B directly, the semaphore counts
+		// the frames that DSP A may still compute ahead of DSP B
+		const uint32_t m_dspAtoBLookahead;
+		dsp56k::SpscSemaphore m_semDspAtoB;
+		dsp56k::Audio::RxFrame m_dspAtoBFrame;
 
 		std::unique_ptr<std::thread> m_ucThread;
 		bool m_destroy = false;
@@ -96,5 +125,16 @@ namespace n2x
 		dsp56k::SpscSemaphoreWithCount m_haltDSPSem;
 
 		bool m_bootFinished = false;
+
+		// Lockstep mode. DSP A may run m_dspAtoBLookahead frames ahead of DSP B, DSP B is limited by the number of frames that
+		// have been requested by the audio thread. Replaces the semaphores above that cannot be used if the DSPs
+		// run on the same thread
+		const bool m_lockstepEnabled;
+		hwLib::Lockstep m_lockstep;
+		int32_t m_lockstepAtoBCredits;
+		std::atomic<int32_t> m_lockstepFrameBudget{0};
+		uint32_t m_lockstepUcCounter = 0;
+		std::mutex m_lockstepMutex;
+		std::condition_variable m_lockstepCv;
 	};
 }
@@ -16,7 +16,7 @@ namespace n2x
 			invalidate();
 	}
 
-	Rom::Rom(const std::vector<uint8_t>& _data, const std::string& _filename) : RomData(_data, _filename)
+	Rom::Rom(const synthLib::RomImage& _data, const std::string& _filename) : RomData(_data, _filename)
 	{
 		if(!isValidRom(data()))
 			invalidate();
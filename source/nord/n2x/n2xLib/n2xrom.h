@@ -10,7 +10,7 @@ namespace n2x
 	public:
 		Rom();
 		Rom(const std::string& _filename);
-		Rom(const std::vector<uint8_t>& _data, const std::string& _filename);
+		Rom(const synthLib::RomImage& _data, const std::string& _filename);
 
 		static bool isValidRom(const std::vector<uint8_t>& _data);
 	};
@@ -16,14 +16,16 @@ namespace n2x
 	{
 		if(_filename.empty())
 			return;
-		if(!baseLib::filesystem::readFile(m_data, _filename))
+		std::vector<uint8_t> data;
+		if(!baseLib::filesystem::readFile(data, _filename))
 			return;
-		if(m_data.size() != MySize)
+		if(data.size() != MySize)
 			return;
+		m_data = synthLib::RomCache::get(std::move(data));
 		m_filename = _filename;
 	}
 
-	template <uint32_t Size> RomData<Size>::RomData(const std::vector<uint8_t>& _data, const std::string& _filename)
+	template <uint32_t Size> RomData<Size>::RomData(const synthLib::RomImage& _data, const std::string& _filename)
 	{
 		if(_data.size() != MySize)
 			return;
@@ -33,7 +35,7 @@ namespace n2x
 
 	template <uint32_t Size> void RomData<Size>::saveAs(const std::string& _filename) const
 	{
-		baseLib::filesystem::writeFile(_filename, m_data);
+		baseLib::filesystem::writeFile(_filename, m_data.get());
 	}
 
 	template class RomData<g_flashSize>;
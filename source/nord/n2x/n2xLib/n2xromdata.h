@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "synthLib/romCache.h"
+
 namespace n2x
 {
 	template<uint32_t Size>
@@ -13,11 +15,10 @@ namespace n2x
 		static constexpr uint32_t MySize = Size;
 		RomData();
 		RomData(const std::string& _filename);
-		RomData(const std::vector<uint8_t>& _data, const std::string& _filename);
+		RomData(const synthLib::RomImage& _data, const std::string& _filename);
 
 		bool isValid() const { return !m_filename.empty(); }
 		const auto& data() const { return m_data; }
-		auto& data() { return m_data; }
 
 		void saveAs(const std::string& _filename) const;
 
@@ -28,7 +29,7 @@ namespace n2x
 			m_filename.clear();
 		}
 	private:
-		std::vector<uint8_t> m_data;
+		synthLib::RomImage m_data;
 		std::string m_filename;
 	};
 }
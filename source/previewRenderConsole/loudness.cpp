@@ -0,0 +1,159 @@
+#include "loudness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace previewRender
+{
+	namespace
+	{
+		constexpr double g_pi = 3.14159265358979323846;
+
+		struct Biquad
+		{
+			double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+			double z1 = 0, z2 = 0;
+
+			double process(const double _in)
+			{
+				const double out = b0 * _in + z1;
+				z1 = b1 * _in - a1 * out + z2;
+				z2 = b2 * _in - a2 * out;
+				return out;
+			}
+		};
+
+		// K-weighting pre-filter, coefficients are derived for any samplerate from the BS.1770 reference filter
+		Biquad createHighShelf(const double _samplerate)
+		{
+			constexpr double gainDb = 3.999843853973347;
+			constexpr double q = 0.7071752369554196;
+			constexpr double fc = 1681.974450955533;
+
+			const double k = std::tan(g_pi * fc / _samplerate);
+			const double vh = std::pow(10.0, gainDb / 20.0);
+			const double vb = std::pow(vh, 0.4996667741545416);
+			const double a0 = 1.0 + k / q + k * k;
+
+			Biquad f;
+			f.b0 = (vh + vb * k / q + k * k) / a0;
+			f.b1 = 2.0 * (k * k - vh) / a0;
+			f.b2 = (vh - vb * k / q + k * k) / a0;
+			f.a1 = 2.0 * (k * k - 1.0) / a0;
+			f.a2 = (1.0 - k / q + k * k) / a0;
+			return f;
+		}
+
+		// RLB weighting high pass
+		Biquad createHighPass(const double _samplerate)
+		{
+			constexpr double q = 0.5003270373238773;
+			constexpr double fc = 38.13547087602444;
+
+			const double k = std::tan(g_pi * fc / _samplerate);
+			const double a0 = 1.0 + k / q + k * k;
+
+			Biquad f;
+			f.b0 = 1.0;
+			f.b1 = -2.0;
+			f.b2 = 1.0;
+			f.a1 = 2.0 * (k * k - 1.0) / a0;
+			f.a2 = (1.0 - k / q + k * k) / a0;
+			return f;
+		}
+
+		float toDb(const double _v)
+		{
+			return _v > 0.0 ? static_cast<float>(20.0 * std::log10(_v)) : -std::numeric_limits<float>::infinity();
+		}
+
+		double toLufs(const double _meanSquare)
+		{
+			return -0.691 + 10.0 * std::log10(_meanSquare);
+		}
+	}
+
+	LoudnessStats analyzeLoudness(const std::vector<std::vector<float>>& _channels, const float _samplerate)
+	{
+		LoudnessStats stats;
+
+		size_t frameCount = 0;
+		for (const auto& c : _channels)
+			frameCount = std::max(frameCount, c.size());
+
+		if(!frameCount || _samplerate <= 0.0f)
+		{
+			stats.peakDb = stats.rmsDb = stats.loudnessLufs = -std::numeric_limits<float>::infinity();
+			return stats;
+		}
+
+		double peak = 0.0;
+		double sumSquares = 0.0;
+
+		// gating blocks of 400 ms with 75% overlap, i.e. mean squares are accumulated in 100 ms steps
+		const auto stepSize = static_cast<size_t>(std::lround(_samplerate * 0.1f));
+		const size_t stepCount = frameCount / stepSize;
+
+		std::vector<double> stepEnergy(stepCount, 0.0);
+
+		for (const auto& channel : _channels)
+		{
+			auto shelf = createHighShelf(_samplerate);
+			auto highPass = createHighPass(_samplerate);
+
+			for(size_t i=0; i<channel.size(); ++i)
+			{
+				const double s = channel[i];
+				peak = std::max(peak, std::abs(s));
+				sumSquares += s * s;
+
+				const double k = highPass.process(shelf.process(s));
+
+				const auto step = i / stepSize;
+				if(step < stepCount)
+					stepEnergy[step] += k * k;
+			}
+		}
+
+		stats.peakDb = toDb(peak);
+		stats.rmsDb = toDb(std::sqrt(sumSquares / static_cast<double>(frameCount * _channels.size())));
+
+		std::vector<double> blocks;
+
+		for(size_t i=3; i<stepCount; ++i)
+		{
+			const auto energy = (stepEnergy[i-3] + stepEnergy[i-2] + stepEnergy[i-1] + stepEnergy[i]) / static_cast<double>(stepSize * 4);
+			if(energy > 0.0 && toLufs(energy) > -70.0)
+				blocks.push_back(energy);
+		}
+
+		if(blocks.empty())
+		{
+			stats.loudnessLufs = -std::numeric_limits<float>::infinity();
+			return stats;
+		}
+
+		double mean = 0.0;
+		for (const auto b : blocks)
+			mean += b;
+		mean /= static_cast<double>(blocks.size());
+
+		const auto relativeGate = toLufs(mean) - 10.0;
+
+		double gatedSum = 0.0;
+		size_t gatedCount = 0;
+
+		for (const auto b : blocks)
+		{
+			if(toLufs(b) > relativeGate)
+			{
+				gatedSum += b;
+				++gatedCount;
+			}
+		}
+
+		stats.loudnessLufs = gatedCount ? static_cast<float>(toLufs(gatedSum / static_cast<double>(gatedCount))) : -std::numeric_limits<float>::infinity();
+		return stats;
+	}
+}
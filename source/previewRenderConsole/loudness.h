@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace previewRender
+{
+	struct LoudnessStats
+	{
+		float peakDb = 0.0f;		// sample peak, dBFS
+		float rmsDb = 0.0f;			// RMS over all channels, dBFS
+		float loudnessLufs = 0.0f;	// integrated loudness according to ITU-R BS.1770 with absolute and relative gating
+	};
+
+	// Analyzes the given channels, all channels are weighted equally. Silence reports -inf for all values
+	LoudnessStats analyzeLoudness(const std::vector<std::vector<float>>& _channels, float _samplerate);
+}
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "loudness.h"
+
+#include "renderLib/deviceFactory.h"
+
+#include "synthLib/device.h"
+#include "synthLib/deviceException.h"
+#include "synthLib/midiFileReader.h"
+#include "synthLib/midiToSysex.h"
+#include "synthLib/offlineRenderer.h"
+#include "synthLib/wavWriter.h"
+
+#include "baseLib/commandline.h"
+#include "baseLib/filesystem.h"
+
+namespace
+{
+	struct Result
+	{
+		std::string filename;
+		previewRender::LoudnessStats stats;
+		bool success = false;
+	};
+
+	std::mutex g_logMutex;
+
+	template<typename... Ts> void log(const Ts&... _args)
+	{
+		std::scoped_lock lock(g_logMutex);
+		(std::cout << ... << _args) << '\n';
+	}
+
+	int error(const std::string& _msg)
+	{
+		std::cerr << "Error: " << _msg << '\n';
+		std::cerr << "Usage:\n"
+			"previewRenderConsole -synth <name> -patches <file.syx|file.mid> -outdir <folder> [-rom <file> -instances n -midi <phrase.mid> -channel n -samplerate x -blocksize n -warmup seconds -patchdelay seconds -tail seconds]\n"
+			"Supported synths: " << renderLib::DeviceFactory::getSupportedSynths() << '\n';
+		return 1;
+	}
+
+	void createDefaultPhrase(std::vector<synthLib::MidiFileEvent>& _events, const uint8_t _channel)
+	{
+		// C major chord, two seconds
+		for (const uint8_t note : {60, 64, 67})
+		{
+			_events.push_back({0.0, synthLib::SMidiEvent(synthLib::MidiEventSource::Host, synthLib::M_NOTEON | _channel, note, 100)});
+			_events.push_back({2.0, synthLib::SMidiEvent(synthLib::MidiEventSource::Host, synthLib::M_NOTEOFF | _channel, note, 64)});
+		}
+	}
+
+	std::string formatDb(const float _db)
+	{
+		if(!std::isfinite(_db))
+			return "-inf";
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(2) << _db;
+		return ss.str();
+	}
+}
+
+int main(const int _argc, char* _argv[])
+{
+	const baseLib::CommandLine cmdLine(_argc, _argv);
+
+	const auto synthType = renderLib::DeviceFactory::getSynthType(cmdLine.get("synth"));
+	const auto patchFile = cmdLine.get("patches");
+	auto outDir = cmdLine.get("outdir");
+
+	if(synthType == renderLib::SynthType::Invalid)
+		return error("No or unsupported synth specified");
+	if(patchFile.empty())
+		return error("No patch file specified");
+	if(outDir.empty())
+		return error("No output folder specified");
+
+	outDir = baseLib::filesystem::validatePath(outDir);
+
+	if(!baseLib::filesystem::isDirectory(outDir) && !baseLib::filesystem::createDirectory(outDir))
+		return error("Failed to create output folder " + outDir);
+
+	// patches, single dumps are retargeted to the edit buffer. If the file does not contain any single dumps
+	// that are known to us, each message is sent as is and is expected to change the current sound
+	synthLib::SysexBufferList messages;
+	if(!synthLib::MidiToSysex::extractSysexFromFile(messages, patchFile) || messages.empty())
+		return error("No patches found in " + patchFile);
+
+	synthLib::SysexBufferList patches;
+
+	for (auto& m : messages)
+	{
+		if(renderLib::DeviceFactory::toEditBufferDump(synthType, m))
+			patches.push_back(m);
+	}
+
+	if(patches.empty())
+		patches = messages;
+
+	// MIDI phrase played for each patch
+	const auto channel = static_cast<uint8_t>(std::clamp(cmdLine.getInt("channel", 1), 1, 16) - 1);
+
+	std::vector<synthLib::MidiFileEvent> phrase;
+
+	if(cmdLine.contains("midi"))
+	{
+		if(!synthLib::MidiFileReader::load(phrase, cmdLine.get("midi")))
+			return error("Failed to load MIDI file " + cmdLine.get("midi"));
+	}
+	else
+	{
+		createDefaultPhrase(phrase, channel);
+	}
+
+	// the ROM is loaded once and shared by all instances
+	synthLib::DeviceCreateParams params;
+
+	if(!renderLib::DeviceFactory::loadRom(params, synthType, cmdLine.get("rom")))
+		return error("No valid ROM found for " + renderLib::DeviceFactory::getSynthName(synthType));
+
+	synthLib::OfflineRenderer::Config config;
+	config.samplerate = cmdLine.getFloat("samplerate", 0.0f);
+	config.blockSize = static_cast<uint32_t>(std::max(64, cmdLine.getInt("blocksize", static_cast<int>(config.blockSize))));
+	config.tailSeconds = cmdLine.getFloat("tail", static_cast<float>(config.tailSeconds));
+
+	params.hostSamplerate = config.samplerate;
+	params.preferredSamplerate = config.samplerate;
+
+	const auto warmupSeconds = std::max(0.0f, cmdLine.getFloat("warmup", 2.0f));
+	const auto patchDelaySeconds = std::max(0.0f, cmdLine.getFloat("patchdelay", 0.5f));
+
+	const auto hwThreads = std::max(1u, std::thread::hardware_concurrency());
+	const auto instanceCount = static_cast<uint32_t>(std::clamp(cmdLine.getInt("instances", static_cast<int>(hwThreads)), 1, static_cast<int>(patches.size())));
+
+	const auto baseName = baseLib::filesystem::stripExtension(baseLib::filesystem::getFilenameWithoutPath(patchFile));
+
+	log("Rendering ", patches.size(), " patches of ", renderLib::DeviceFactory::getSynthName(synthType), " using ", instanceCount, " instances, ROM ", params.romName);
+
+	std::vector<Result> results(patches.size());
+	std::atomic<size_t> nextPatch{0};
+	std::atomic<uint32_t> failedInstances{0};
+
+	const auto tStart = std::chrono::high_resolution_clock::now();
+
+	auto workerFunc = [&](const uint32_t _instance)
+	{
+		std::unique_ptr<synthLib::Device> device;
+
+		try
+		{
+			device.reset(renderLib::DeviceFactory::createDevice(synthType, params));
+		}
+		catch(synthLib::DeviceException& e)
+		{
+			log("Instance ", _instance, ": device creation failed: ", e.what());
+		}
+
+		if(!device || !device->isValid())
+		{
+			++failedInstances;
+			return;
+		}
+
+		synthLib::OfflineRenderer renderer(*device, config);
+
+		const auto sr = static_cast<double>(renderer.getSamplerate());
+		const auto patchDelay = static_cast<uint64_t>(std::llround(patchDelaySeconds * sr));
+
+		std::vector<std::vector<float>> output;
+
+		// let the device finish its boot before the first patch is sent
+		renderer.render(output, static_cast<uint64_t>(std::llround(warmupSeconds * sr)));
+
+		while(true)
+		{
+			const auto index = nextPatch++;
+
+			if(index >= patches.size())
+				break;
+
+			renderer.clearEvents();
+
+			synthLib::SMidiEvent patchEvent(synthLib::MidiEventSource::Host);
+			patchEvent.sysex.assign(patches[index].begin(), patches[index].end());
+			renderer.addEvent(0, patchEvent);
+
+			uint64_t phraseEnd = patchDelay;
+
+			for (const auto& e : phrase)
+			{
+				const auto pos = patchDelay + static_cast<uint64_t>(std::llround(std::max(0.0, e.seconds) * sr));
+				renderer.addEvent(pos, e.event);
+				phraseEnd = std::max(phraseEnd, pos);
+			}
+
+			// make sure that nothing keeps sounding into the next patch
+			for(uint8_t c=0; c<16; ++c)
+				renderer.addEvent(phraseEnd + 1, synthLib::SMidiEvent(synthLib::MidiEventSource::Host, synthLib::M_CONTROLCHANGE | c, synthLib::MC_ALLNOTESOFF, 0));
+
+			auto& result = results[index];
+
+			if(!renderer.render(output))
+			{
+				log("Instance ", _instance, ": rendering patch ", index, " failed");
+				continue;
+			}
+
+			for (auto& o : output)
+				o.erase(o.begin(), o.begin() + static_cast<ptrdiff_t>(std::min<uint64_t>(patchDelay, o.size())));
+
+			// preview is stereo
+			output.resize(std::min<size_t>(output.size(), 2));
+
+			result.stats = previewRender::analyzeLoudness(output, renderer.getSamplerate());
+
+			std::vector<float> interleaved;
+			const auto frameCount = output.empty() ? 0 : output.front().size();
+			interleaved.reserve(frameCount * output.size());
+
+			for(size_t f=0; f<frameCount; ++f)
+			{
+				for (const auto& o : output)
+					interleaved.push_back(o[f]);
+			}
+
+			std::stringstream name;
+			name << baseName << '_' << std::setw(4) << std::setfill('0') << index << ".wav";
+			result.filename = name.str();
+
+			synthLib::WavWriter writer;
+			result.success = !interleaved.empty() && writer.write(outDir + result.filename, 32, true, static_cast<int>(output.size()), static_cast<int>(renderer.getSamplerate()), interleaved);
+
+			log("[", _instance, "] ", result.filename, ": peak ", formatDb(result.stats.peakDb), " dBFS, RMS ", formatDb(result.stats.rmsDb), " dBFS, ", formatDb(result.stats.loudnessLufs), " LUFS");
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(instanceCount);
+
+	for(uint32_t i=0; i<instanceCount; ++i)
+		workers.emplace_back(workerFunc, i);
+
+	for (auto& w : workers)
+		w.join();
+
+	if(failedInstances == instanceCount)
+		return error("Failed to create any device instance");
+
+	const auto duration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+	std::ofstream csv(outDir + baseName + "_stats.csv");
+	csv << "index,file,peak_dbfs,rms_dbfs,loudness_lufs\n";
+
+	size_t successCount = 0;
+
+	for(size_t i=0; i<results.size(); ++i)
+	{
+		const auto& r = results[i];
+		if(!r.success)
+			continue;
+		++successCount;
+		csv << i << ',' << r.filename << ',' << formatDb(r.stats.peakDb) << ',' << formatDb(r.stats.rmsDb) << ',' << formatDb(r.stats.loudnessLufs) << '\n';
+	}
+
+	log("Rendered ", successCount, " of ", patches.size(), " patches in ", duration, " seconds");
+
+	return successCount == patches.size() ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "renderLib/deviceFactory.h"
+
+#include "synthLib/device.h"
+#include "synthLib/deviceException.h"
+#include "synthLib/midiFileReader.h"
+#include "synthLib/offlineRenderer.h"
+#include "synthLib/wavReader.h"
+#include "synthLib/wavWriter.h"
+
+#include "baseLib/commandline.h"
+#include "baseLib/filesystem.h"
+
+namespace
+{
+	int error(const std::string& _msg)
+	{
+		std::cerr << "Error: " << _msg << '\n';
+		std::cerr << "Usage:\n"
+			"renderConsole -synth <name> -midi <file.mid> -out <file.wav> [-rom <file> -input <file.wav> -samplerate x -blocksize n -preroll seconds -tail seconds -channels n -nolatencycompensation]\n"
+			"Supported synths: " << renderLib::DeviceFactory::getSupportedSynths() << '\n';
+		return 1;
+	}
+
+	bool loadWav(std::vector<std::vector<float>>& _channels, uint32_t& _samplerate, std::string& _error, const std::string& _filename)
+	{
+		std::vector<uint8_t> file;
+		if(!baseLib::filesystem::readFile(file, _filename))
+		{
+			_error = "Failed to read input file " + _filename;
+			return false;
+		}
+
+		synthLib::Data data;
+		if(!synthLib::WavReader::load(data, nullptr, file.data(), file.size()) || !data.channels)
+		{
+			_error = "Failed to parse input file " + _filename;
+			return false;
+		}
+
+		const auto bytesPerSample = data.bitsPerSample >> 3;
+
+		const bool supported = data.isFloat
+			? (data.bitsPerSample == 32 || data.bitsPerSample == 64)
+			: (data.bitsPerSample >= 8 && data.bitsPerSample <= 32 && !(data.bitsPerSample & 7));
+
+		if(!supported)
+		{
+			_error = "Input file " + _filename + " uses an unsupported sample format, " + std::to_string(data.bitsPerSample) + " bits " + (data.isFloat ? "float" : "integer");
+			return false;
+		}
+
+		const auto frameCount = data.dataByteSize / (bytesPerSample * data.channels);
+		const auto* src = static_cast<const uint8_t*>(data.data);
+
+		_samplerate = data.samplerate;
+		_channels.assign(data.channels, std::vector<float>(frameCount));
+
+		for(size_t f=0; f<frameCount; ++f)
+		{
+			for(uint32_t c=0; c<data.channels; ++c)
+			{
+				float v;
+
+				if(data.isFloat)
+				{
+					if(bytesPerSample == sizeof(double))
+					{
+						double d;
+						memcpy(&d, src, sizeof(d));
+						v = static_cast<float>(d);
+					}
+					else
+					{
+						memcpy(&v, src, sizeof(v));
+					}
+				}
+				else if(bytesPerSample == 1)
+				{
+					// 8 bit samples are unsigned, 128 is the zero level
+					v = static_cast<float>(static_cast<int32_t>(src[0]) - 128) / 128.0f;
+				}
+				else
+				{
+					// little endian signed integer, left aligned into 32 bits
+					uint32_t u = 0;
+					for(uint32_t b=0; b<bytesPerSample; ++b)
+						u |= static_cast<uint32_t>(src[b]) << (32 - 8 * (bytesPerSample - b));
+					const auto s = static_cast<int32_t>(u);
+					v = static_cast<float>(static_cast<double>(s) / 2147483648.0);
+				}
+
+				_channels[c][f] = v;
+				src += bytesPerSample;
+			}
+		}
+		return true;
+	}
+}
+
+int main(const int _argc, char* _argv[])
+{
+	const baseLib::CommandLine cmdLine(_argc, _argv);
+
+	const auto synthType = renderLib::DeviceFactory::getSynthType(cmdLine.get("synth"));
+	const auto midiFile = cmdLine.get("midi");
+	const auto outFile = cmdLine.get("out");
+
+	if(synthType == renderLib::SynthType::Invalid)
+		return error("No or unsupported synth specified");
+	if(midiFile.empty())
+		return error("No MIDI file specified");
+	if(outFile.empty())
+		return error("No output file specified");
+
+	std::vector<synthLib::MidiFileEvent> events;
+	if(!synthLib::MidiFileReader::load(events, midiFile))
+		return error("Failed to load MIDI file " + midiFile);
+
+	synthLib::DeviceCreateParams params;
+
+	if(!renderLib::DeviceFactory::loadRom(params, synthType, cmdLine.get("rom")))
+		return error("No valid ROM found for " + renderLib::DeviceFactory::getSynthName(synthType));
+
+	synthLib::OfflineRenderer::Config config;
+	config.samplerate = cmdLine.getFloat("samplerate", 0.0f);
+	config.blockSize = static_cast<uint32_t>(std::max(64, cmdLine.getInt("blocksize", static_cast<int>(config.blockSize))));
+	config.preRollSeconds = cmdLine.getFloat("preroll", 1.0f);
+	config.tailSeconds = cmdLine.getFloat("tail", static_cast<float>(config.tailSeconds));
+	config.compensateLatency = !cmdLine.contains("nolatencycompensation");
+
+	params.hostSamplerate = config.samplerate;
+	params.preferredSamplerate = config.samplerate;
+
+	try
+	{
+		std::cout << "Creating device " << renderLib::DeviceFactory::getSynthName(synthType) << " using ROM " << params.romName << '\n';
+
+		const std::unique_ptr<synthLib::Device> device(renderLib::DeviceFactory::createDevice(synthType, params));
+
+		if(!device || !device->isValid())
+			return error("Failed to create device");
+
+		synthLib::OfflineRenderer renderer(*device, config);
+
+		renderer.addEvents(events);
+
+		uint64_t minLength = 0;
+
+		if(cmdLine.contains("input"))
+		{
+			std::vector<std::vector<float>> input;
+			uint32_t inputSamplerate = 0;
+			std::string err;
+
+			if(!loadWav(input, inputSamplerate, err, cmdLine.get("input")))
+				return error(err);
+
+			if(static_cast<float>(inputSamplerate) != renderer.getSamplerate())  // NOLINT(clang-diagnostic-float-equal)
+				std::cout << "Warning: input samplerate " << inputSamplerate << " Hz does not match render samplerate " << renderer.getSamplerate() << " Hz, input is not resampled\n";
+
+			minLength = input.empty() ? 0 : input.front().size();
+			renderer.setInput(std::move(input));
+		}
+
+		std::cout << "Rendering " << events.size() << " events at " << renderer.getSamplerate() << " Hz\n";
+
+		const auto tStart = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::vector<float>> output;
+		if(!renderer.render(output, minLength))
+			return error("Rendering failed, device is not valid");
+
+		const auto duration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+		const auto channelCount = std::min<size_t>(output.size(), static_cast<size_t>(std::max(1, cmdLine.getInt("channels", 2))));
+		const auto frameCount = output.empty() ? 0 : output.front().size();
+
+		std::vector<float> interleaved;
+		interleaved.reserve(frameCount * channelCount);
+
+		for(size_t f=0; f<frameCount; ++f)
+		{
+			for(size_t c=0; c<channelCount; ++c)
+				interleaved.push_back(output[c][f]);
+		}
+
+		if(interleaved.empty())
+			return error("Nothing rendered");
+
+		synthLib::WavWriter writer;
+		if(!writer.write(outFile, 32, true, static_cast<int>(channelCount), static_cast<int>(renderer.getSamplerate()), interleaved))
+			return error("Failed to write output file " + outFile);
+
+		const auto seconds = static_cast<double>(frameCount) / renderer.getSamplerate();
+		std::cout << "Rendered " << seconds << " seconds in " << duration << " seconds (" << (duration > 0 ? seconds / duration : 0.0) << "x realtime) to " << outFile << '\n';
+	}
+	catch(synthLib::DeviceException& e)
+	{
+		return error(std::string("Device creation failed: ") + e.what());
+	}
+
+	return 0;
+}
@@ -0,0 +1,260 @@
+#include "deviceFactory.h"
+
+#include "synthLib/device.h"
+
+#include "baseLib/filesystem.h"
+
+#include "dsp56kBase/logging.h"
+
+#if RENDERLIB_HAS_VIRUSLIB
+#include "virusLib/device.h"
+#include "virusLib/romloader.h"
+#endif
+
+#if RENDERLIB_HAS_MQLIB
+#include "mqLib/device.h"
+#include "mqLib/romloader.h"
+#endif
+
+#if RENDERLIB_HAS_XTLIB
+#include "xtLib/xtDevice.h"
+#include "xtLib/xtRomLoader.h"
+#endif
+
+#if RENDERLIB_HAS_N2XLIB
+#include "n2xLib/n2xdevice.h"
+#include "n2xLib/n2xromloader.h"
+#endif
+
+#if RENDERLIB_HAS_JELIB
+#include "jeLib/device.h"
+#include "jeLib/romloader.h"
+#endif
+
+namespace renderLib
+{
+	namespace
+	{
+		constexpr SynthType g_synthTypes[] =
+		{
+#if RENDERLIB_HAS_VIRUSLIB
+			SynthType::Virus,
+			SynthType::VirusTI,
+#endif
+#if RENDERLIB_HAS_MQLIB
+			SynthType::MicroQ,
+#endif
+#if RENDERLIB_HAS_XTLIB
+			SynthType::Xt,
+#endif
+#if RENDERLIB_HAS_N2XLIB
+			SynthType::N2x,
+#endif
+#if RENDERLIB_HAS_JELIB
+			SynthType::Je8086,
+#endif
+			SynthType::Invalid
+		};
+
+		bool loadRomFile(synthLib::DeviceCreateParams& _params, const std::string& _romFile)
+		{
+			_params.romData = synthLib::RomCache::loadFile(_romFile);
+
+			if(_params.romData.empty())
+			{
+				LOG("Failed to load ROM file " << _romFile);
+				return false;
+			}
+			_params.romName = _romFile;
+			return true;
+		}
+
+		uint8_t sysexChecksum(const synthLib::SysexBuffer& _sysex, const size_t _begin, const size_t _end)
+		{
+			uint8_t cs = 0;
+			for(size_t i=_begin; i<_end; ++i)
+				cs += _sysex[i];
+			return cs & 0x7f;
+		}
+	}
+
+	SynthType DeviceFactory::getSynthType(const std::string& _name)
+	{
+		const auto name = baseLib::filesystem::lowercase(_name);
+
+		for (const auto type : g_synthTypes)
+		{
+			if(type != SynthType::Invalid && baseLib::filesystem::lowercase(getSynthName(type)) == name)
+				return type;
+		}
+		return SynthType::Invalid;
+	}
+
+	std::string DeviceFactory::getSynthName(const SynthType _type)
+	{
+		switch (_type)
+		{
+		case SynthType::Virus:		return "Virus";
+		case SynthType::VirusTI:	return "VirusTI";
+		case SynthType::MicroQ:		return "MicroQ";
+		case SynthType::Xt:			return "XT";
+		case SynthType::N2x:		return "N2x";
+		case SynthType::Je8086:		return "JE8086";
+		default:					return {};
+		}
+	}
+
+	std::string DeviceFactory::getSupportedSynths()
+	{
+		std::string res;
+		for (const auto type : g_synthTypes)
+		{
+			if(type == SynthType::Invalid)
+				continue;
+			if(!res.empty())
+				res += ' ';
+			res += getSynthName(type);
+		}
+		return res;
+	}
+
+	bool DeviceFactory::loadRom(synthLib::DeviceCreateParams& _params, const SynthType _type, const std::string& _romFile)
+	{
+		switch (_type)
+		{
+#if RENDERLIB_HAS_VIRUSLIB
+		case SynthType::Virus:
+		case SynthType::VirusTI:
+			{
+				const auto model = _type == SynthType::VirusTI ? virusLib::DeviceModel::TI : virusLib::DeviceModel::ABC;
+				const auto rom = _romFile.empty() ? virusLib::ROMLoader::findROM(model) : virusLib::ROMLoader::findROM(_romFile, model);
+				if(!rom.isValid())
+					return false;
+				_params.romData = rom.getRomFileData();
+				_params.romName = rom.getFilename();
+				_params.customData = static_cast<uint32_t>(rom.getModel());
+				return true;
+			}
+#endif
+#if RENDERLIB_HAS_MQLIB
+		case SynthType::MicroQ:
+			{
+				const auto rom = _romFile.empty() ? mqLib::RomLoader::findROM() : mqLib::ROM(_romFile);
+				if(!rom.isValid())
+					return false;
+				_params.romData = rom.getData();
+				_params.romName = rom.getFilename();
+				return true;
+			}
+#endif
+#if RENDERLIB_HAS_XTLIB
+		case SynthType::Xt:
+			{
+				if(!_romFile.empty())
+					return loadRomFile(_params, _romFile);
+				const auto rom = xt::RomLoader::findROM();
+				if(!rom.isValid())
+					return false;
+				_params.romData = rom.getData();
+				_params.romName = rom.getFilename();
+				return true;
+			}
+#endif
+#if RENDERLIB_HAS_N2XLIB
+		case SynthType::N2x:
+			{
+				if(!_romFile.empty())
+					return loadRomFile(_params, _romFile);
+				const auto rom = n2x::RomLoader::findROM();
+				if(!rom.isValid())
+					return false;
+				_params.romData = rom.data();
+				_params.romName = rom.getFilename();
+				return true;
+			}
+#endif
+#if RENDERLIB_HAS_JELIB
+		case SynthType::Je8086:
+			{
+				const auto rom = _romFile.empty() ? jeLib::RomLoader::findROM() : jeLib::Rom(_romFile);
+				if(!rom.isValid())
+					return false;
+				_params.romData = rom.getData();
+				_params.romName = rom.getName();
+				return true;
+			}
+#endif
+		default:
+			return false;
+		}
+	}
+
+	synthLib::Device* DeviceFactory::createDevice(const SynthType _type, const synthLib::DeviceCreateParams& _params)
+	{
+		switch (_type)
+		{
+#if RENDERLIB_HAS_VIRUSLIB
+		case SynthType::Virus:
+		case SynthType::VirusTI:	return new virusLib::Device(_params);
+#endif
+#if RENDERLIB_HAS_MQLIB
+		case SynthType::MicroQ:		return new mqLib::Device(_params);
+#endif
+#if RENDERLIB_HAS_XTLIB
+		case SynthType::Xt:			return new xt::Device(_params);
+#endif
+#if RENDERLIB_HAS_N2XLIB
+		case SynthType::N2x:		return new n2x::Device(_params);
+#endif
+#if RENDERLIB_HAS_JELIB
+		case SynthType::Je8086:		return new jeLib::Device(_params);
+#endif
+		default:					return nullptr;
+		}
+	}
+
+	bool DeviceFactory::toEditBufferDump(const SynthType _type, synthLib::SysexBuffer& _sysex)
+	{
+		switch (_type)
+		{
+		case SynthType::Virus:
+		case SynthType::VirusTI:
+			{
+				// F0 00 20 33 01 dd 10 bank program <256 bytes> cs [<256 bytes> cs] F7
+				// The checksums start at the device id and include bank and program, they need to be recalculated
+				if(_sysex.size() != 267 && _sysex.size() != 524)
+					return false;
+				if(_sysex[1] != 0x00 || _sysex[2] != 0x20 || _sysex[3] != 0x33 || _sysex[4] != 0x01 || _sysex[6] != 0x10)
+					return false;
+
+				_sysex[7] = 0x00;	// edit buffer
+				_sysex[8] = 0x40;	// single mode
+
+				_sysex[265] = sysexChecksum(_sysex, 5, 265);
+				if(_sysex.size() == 524)
+					_sysex[522] = sysexChecksum(_sysex, 5, 522);
+				return true;
+			}
+		case SynthType::MicroQ:
+		case SynthType::Xt:
+			{
+				// F0 3E model dd 10 bank program <data> cs F7
+				// The mq checksum starts at the command byte and includes bank and program, the XT checksum only covers the data
+				constexpr uint8_t modelMq = 0x10;
+				constexpr uint8_t modelXt = 0x0e;
+
+				if(_sysex.size() < 10 || _sysex[1] != 0x3e || _sysex[2] != (_type == SynthType::MicroQ ? modelMq : modelXt) || _sysex[4] != 0x10)
+					return false;
+
+				_sysex[5] = 0x20;	// single edit buffer, single mode
+				_sysex[6] = 0x00;
+
+				if(_type == SynthType::MicroQ)
+					_sysex[_sysex.size() - 2] = sysexChecksum(_sysex, 4, _sysex.size() - 2);
+				return true;
+			}
+		default:
+			return false;
+		}
+	}
+}
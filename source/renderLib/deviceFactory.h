@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+#include "synthLib/midiTypes.h"
+
+namespace synthLib
+{
+	struct DeviceCreateParams;
+	class Device;
+}
+
+namespace renderLib
+{
+	enum class SynthType
+	{
+		Invalid,
+		Virus,
+		VirusTI,
+		MicroQ,
+		Xt,
+		N2x,
+		Je8086
+	};
+
+	// Creates emulated devices without any plugin or UI around them, used by the offline render tools
+	class DeviceFactory
+	{
+	public:
+		static SynthType getSynthType(const std::string& _name);
+		static std::string getSynthName(SynthType _type);
+
+		// space separated list of all synths that are part of the build, used for command line help
+		static std::string getSupportedSynths();
+
+		// loads _romFile or, if empty, searches the default locations for a firmware of the given synth
+		static bool loadRom(synthLib::DeviceCreateParams& _params, SynthType _type, const std::string& _romFile);
+
+		static synthLib::Device* createDevice(SynthType _type, const synthLib::DeviceCreateParams& _params);
+
+		// Retargets a single dump to the single mode edit buffer so that it can be auditioned without storing it.
+		// Returns false if the message is not a single dump of the given synth, in which case it is not modified
+		static bool toEditBufferDump(SynthType _type, synthLib::SysexBuffer& _sysex);
+	};
+}
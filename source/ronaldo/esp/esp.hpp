@@ -463,7 +463,7 @@ public:
 			};
 
 			if (newValues != oldValues)
-				opt.setProgramDirty();
+				opt.updateEram(this);
 		}
 		else if (if_mode == 0x57 && (address & 3) == 3) {
 			addr_sel = address & ~3;
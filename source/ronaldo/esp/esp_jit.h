@@ -18,7 +18,7 @@ namespace esp
 
 		virtual void eramRead(uint32_t _eramMask) = 0;
 		virtual void eramWrite(uint32_t _eramMask) = 0;
-		virtual void eramComputeAddr(uint32_t immOffset, bool highOffset, bool shouldUseVarOffset) = 0;
+		virtual void eramComputeAddr(uint32_t pc, bool highOffset, bool shouldUseVarOffset) = 0;
 
 		virtual void emitOp(uint32_t pc, const ESPOptInstr& instr, bool lastMul30) = 0;
 	};
@@ -131,13 +131,13 @@ namespace esp
 		m_asm.str(w9, ptr(tempA, eramEffectiveAddr, lsl(2))); // store eramWriteLatchNext
 	}
 
-	void EspJitArm64::eramComputeAddr(uint32_t immOffset, bool highOffset, bool shouldUseVarOffset)
+	void EspJitArm64::eramComputeAddr(uint32_t pc, bool highOffset, bool shouldUseVarOffset)
 	{
       // eramWriteLatchNext = eramWriteLatch;
       m_asm.mov(eramWriteLatchNext, eramWriteLatch);
 
-      // eramEffectiveAddr = eramPos + immOffset;
-      m_asm.mov(eramEffectiveAddr, immOffset);
+      // eramEffectiveAddr = eramPos + eramImmOffsets[pc];
+      m_asm.ldr(eramEffectiveAddr.w(), ptr(ptrVars, offsetof(CoreData, eramImmOffsets) + (pc << 2)));
       m_asm.add(eramEffectiveAddr, eramEffectiveAddr, eramPos);
       
       if (shouldUseVarOffset)
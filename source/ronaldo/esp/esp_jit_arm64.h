@@ -18,7 +18,7 @@ namespace esp
 
 		void eramRead(uint32_t eramMask) override;
 		void eramWrite(uint32_t eramMask) override;
-		void eramComputeAddr(uint32_t immOffset, bool highOffset, bool shouldUseVarOffset) override;
+		void eramComputeAddr(uint32_t pc, bool highOffset, bool shouldUseVarOffset) override;
 
 		void emitOp(uint32_t pc, const ESPOptInstr& instr, bool lastMul30) override;
 
@@ -78,7 +78,7 @@ namespace esp
 		m_asm.mov(eramPtr(eramEffectiveAddr), eramWriteLatchNext.r32());
 	}
 
-	void EspJitX64::eramComputeAddr(uint32_t immOffset, bool highOffset, bool shouldUseVarOffset)
+	void EspJitX64::eramComputeAddr(uint32_t pc, bool highOffset, bool shouldUseVarOffset)
 	{
 		// eramWriteLatchNext = eramWriteLatch;
 		{
@@ -87,9 +87,9 @@ namespace esp
 			m_asm.mov(eramWriteLatchNext, eramWriteLatch);
 		}
 
-		// eramEffectiveAddr = eramPos + immOffset;
+		// eramEffectiveAddr = eramPos + eramImmOffsets[pc];
 		auto eramEffectiveAddr = m_pool.get(m_data.eramEffectiveAddr, Access::Write);
-		m_asm.mov(eramEffectiveAddr, immOffset);
+		m_asm.mov(eramEffectiveAddr.r32(), eramImmOffsetPtr(pc));
 
 		auto eramPos = m_pool.get(m_data.eramPos, Access::Read);
 		m_asm.add(eramEffectiveAddr, eramPos);
@@ -480,6 +480,12 @@ namespace esp
 		return ptr(g_regBasePtr, m_pool.getPointerOffset(&m_data.coreData->shiftAmounts[index]), 1);
 	}
 
+	Mem EspJitX64::eramImmOffsetPtr(const uint32_t index) const
+	{
+		assert(index < std::size(m_data.coreData->eramImmOffsets));
+		return ptr(g_regBasePtr, m_pool.getPointerOffset(&m_data.coreData->eramImmOffsets[index]), 4);
+	}
+
 	Mem EspJitX64::hostregPtr() const
 	{
 		return ptr(g_regBasePtr, m_pool.getPointerOffset(m_data.coreData->hostRegPtr), 4);
@@ -18,7 +18,7 @@ namespace esp
 
 		void eramRead(uint32_t _eramMask) override;
 		void eramWrite(uint32_t _eramMask) override;
-		void eramComputeAddr(uint32_t immOffset, bool highOffset, bool shouldUseVarOffset);
+		void eramComputeAddr(uint32_t pc, bool highOffset, bool shouldUseVarOffset);
 
 		void checkUninit(const asmjit::x86::Gpq& reg) const;
 		void emitOp(uint32_t pc, const ESPOptInstr& instr, bool lastMul30);
@@ -30,6 +30,7 @@ namespace esp
 		asmjit::x86::Mem coefsPtr(uint32_t index) const;
 		asmjit::x86::Mem mulcoefsPtr(uint32_t index) const;
 		asmjit::x86::Mem shiftPtr(uint32_t index) const;
+		asmjit::x86::Mem eramImmOffsetPtr(uint32_t index) const;
 		asmjit::x86::Mem hostregPtr() const;
 
 		Asm& m_asm;
@@ -1,6 +1,7 @@
 #include <asmjit/asmjit.h>
 #include <asmjit/a64.h>
 #include <sstream>
+#include <vector>
 
 #include "esp_jit_x64.h"
 #include "esp_jit_arm64.h"
@@ -15,6 +16,7 @@ struct CoreData {
   int32_t mulcoeffs[8];
   int8_t coefs[PRAM_SIZE];
   int8_t shiftAmounts[PRAM_SIZE];
+  uint32_t eramImmOffsets[PRAM_SIZE]; // immediate ERAM address offsets, indexed by the pc of the address computation
 };
 
 enum { kNone = 0, kSavesA = 1, kSavesB = 2 };
@@ -176,10 +178,29 @@ struct ESPOptInstr
 	}
 };
 
+struct ESPOptimizerStats
+{
+  uint32_t programGenerations = 0;	// full regenerations of the code of both cores
+  uint32_t coefUpdates = 0;			// coefficient writes that only updated the coefficient tables
+  uint32_t eramUpdates = 0;			// ERAM control writes that only updated the ERAM offset table
+  uint32_t eramRegenerations = 0;	// ERAM control writes that changed the code and required a regeneration
+
+  ESPOptimizerStats& operator += (const ESPOptimizerStats& s)
+  {
+    programGenerations += s.programGenerations;
+    coefUpdates += s.coefUpdates;
+    eramUpdates += s.eramUpdates;
+    eramRegenerations += s.eramRegenerations;
+    return *this;
+  }
+};
+
 template<int lg2eram_size>
 class ESPOptimizer
 {
 public:
+  using Stats = ESPOptimizerStats;
+
   ESPOptimizer(ESP<lg2eram_size>* esp) : m_esp(esp), logger(fopen("esp_jit.log", "w"))
   {
     data_core0.hostRegPtr = (int32_t*)esp->shared.readback_regs;
@@ -197,7 +218,11 @@ public:
     coreEmitter0.init(esp, &esp->core0);
     coreEmitter1.init(esp, &esp->core1);
 
-    updateCoef(esp);
+    updateCoefTables(esp);
+    updateEramOffsets(eramEmitter.getEvents());
+
+    m_stats.programGenerations++;
+    m_regenerateProgram = false;
 
     // logger.log("#### CORE 0 ####\n");
     genCore(esp, 0, &coreEmitter0, &runCore0);
@@ -212,6 +237,7 @@ public:
   void setProgramDirty()
   {
 	  m_programDirty = 3;
+	  m_regenerateProgram = true;
   }
 
   void genProgramIfDirty()
@@ -219,11 +245,62 @@ public:
       if (m_programDirty > 0)
       {
           if (--m_programDirty == 0)
-              genProgram(m_esp);
+          {
+              if (m_regenerateProgram)
+                  genProgram(m_esp);
+              else
+                  applyEramUpdate();
+          }
 	  }
   }
 
+  // Called when the ERAM control bits of the program have been modified. Uses the same countdown as a regeneration,
+  // once it expires, only the immediate address offset table that is read by the jitted code is updated, unless the
+  // ERAM transactions themselves have changed
+  void updateEram(ESP<lg2eram_size>* esp)
+  {
+    if (!runCore1)
+    {
+      setProgramDirty();
+      return;
+    }
+
+    // restart the countdown, a pending regeneration picks up the change anyway
+    m_programDirty = 3;
+  }
+
+  const Stats& getStats() const { return m_stats; }
+
   void updateCoef(ESP<lg2eram_size>* esp)
+  {
+    updateCoefTables(esp);
+    m_stats.coefUpdates++;
+  }
+
+  inline void callOptimized(ESP<lg2eram_size>* esp)
+  {
+    if (runCore0) runCore0(data_core0.coefs, esp->core0.iram, esp->shared.gram, &data_core0, esp->shared.eram.eramPos, esp->core0.iramPos, 0, 0);
+    if (runCore1) runCore1(data_core1.coefs, esp->core1.iram, esp->shared.gram, &data_core1, esp->shared.eram.eramPos, esp->core1.iramPos, 0, 0);
+  }
+  
+private:
+  class CoreEmitter;
+
+  ESP<lg2eram_size>* m_esp;
+  asmjit::JitRuntime m_rt;
+  asmjit::FileLogger logger;
+  uint32_t m_programDirty = 0;
+  bool m_regenerateProgram = false;	// false if the countdown only needs to update the ERAM offsets
+  Stats m_stats;
+  
+  typedef void(*RunCore)(int8_t* coefsPtr, int32_t *iramPtr, int32_t *gramPtr, CoreData *varPtr, uint32_t eramPos, uint32_t iramPos, int64_t unused1, int64_t unused2);
+  RunCore runCore0 = nullptr, runCore1 = nullptr;
+
+  // State used by jitted code
+  CoreData data_core0{0};
+  CoreData data_core1{0};
+
+  void updateCoefTables(ESP<lg2eram_size>* esp)
   {
     for (size_t i = 0; i < PRAM_SIZE; i++) {
       uint32_t instr = esp->core0.pram[i];
@@ -248,26 +325,29 @@ public:
     }
   }
 
-  inline void callOptimized(ESP<lg2eram_size>* esp)
+  void applyEramUpdate()
   {
-    if (runCore0) runCore0(data_core0.coefs, esp->core0.iram, esp->shared.gram, &data_core0, esp->shared.eram.eramPos, esp->core0.iramPos, 0, 0);
-    if (runCore1) runCore1(data_core1.coefs, esp->core1.iram, esp->shared.gram, &data_core1, esp->shared.eram.eramPos, esp->core1.iramPos, 0, 0);
-  }
-  
-private:
-  class CoreEmitter;
+    eramEmitter.analyze(m_eramEvents);
 
-  ESP<lg2eram_size>* m_esp;
-  asmjit::JitRuntime m_rt;
-  asmjit::FileLogger logger;
-  uint32_t m_programDirty = 0;
-  
-  typedef void(*RunCore)(int8_t* coefsPtr, int32_t *iramPtr, int32_t *gramPtr, CoreData *varPtr, uint32_t eramPos, uint32_t iramPos, int64_t unused1, int64_t unused2);
-  RunCore runCore0 = nullptr, runCore1 = nullptr;
+    if (!eramEmitter.hasSameCode(m_eramEvents))
+    {
+      m_stats.eramRegenerations++;
+      genProgram(m_esp);
+      return;
+    }
 
-  // State used by jitted code
-  CoreData data_core0{0};
-  CoreData data_core1{0};
+    updateEramOffsets(m_eramEvents);
+    m_stats.eramUpdates++;
+  }
+
+  void updateEramOffsets(const std::vector<typename ERAMEmitter::Event>& _events)
+  {
+    for (const auto& e : _events)
+    {
+      if (e.type == ERAMEmitter::EventType::ComputeAddr)
+        data_core1.eramImmOffsets[e.pc] = e.immOffset;
+    }
+  }
 
   void genCore(ESP<lg2eram_size>* esp, uint32_t core, CoreEmitter* emitter, RunCore *dest, bool withEram = false)
   {
@@ -336,66 +416,124 @@ private:
   class ERAMEmitter
   {
   public:
+    enum class EventType : uint8_t { Write, Read, ComputeAddr };
+
+    struct Event
+    {
+      uint16_t pc = 0;
+      EventType type = EventType::Write;
+      bool highOffset = false, shouldUseVarOffset = false;
+      uint32_t immOffset = 0;
+
+      // the immediate offset is read from CoreData by the jitted code, it does not change the generated code
+      bool sameCode(const Event& e) const
+      {
+        return pc == e.pc && type == e.type && highOffset == e.highOffset && shouldUseVarOffset == e.shouldUseVarOffset;
+      }
+    };
+
     void init(ESP<lg2eram_size>* _esp)
     {
       esp = _esp;
-
-      eramPCCommit = 0, eramPCStartNext = 0;
-      eramModeCurrent = 0, eramModeNext = 0;
-      eramImmOffsetAccNext = 0;
-      eramActiveCurrent = false, eramActiveNext = false;
-      highOffset = false;
+      analyze(events);
+      nextEvent = 0;
     }
 
-    void emit(int pc, esp::EspJit& _jit, esp::Builder& m_asm)
+    // Runs the transaction state machine over the whole program and records the ERAM accesses that need to be emitted.
+    // This runs on every ERAM control write, the diagnostics are only printed once
+    void analyze(std::vector<Event>& _events) const
     {
+      _events.clear();
+
       if (lg2eram_size == 0) return;
 
-      uint32_t *decode = (uint32_t*)(&esp->intmem[0x1000]);
-      uint32_t eramCtrl = (decode[pc] >> 23) & 0x1f;
-      int stage1 = pc - eramPCStartNext;
-
-      // Transaction start
-      if (!eramActiveNext && ((eramCtrl & 0x18) != 0)) {
-        eramActiveNext = true;
-        eramModeNext = eramCtrl;
-        eramPCStartNext = pc;
-        eramImmOffsetAccNext = 0;
-        stage1 = 0;
-        if (eramModeNext & 0x7) printf("wtf %03x at pc=%04x\n", eramCtrl, pc);
-      }
+      uint16_t eramPCCommit = 0, eramPCStartNext = 0;
+      uint8_t eramModeCurrent = 0, eramModeNext = 0;
+      uint32_t eramImmOffsetAccNext = 0;
+      bool eramActiveCurrent = false, eramActiveNext = false;
+      bool highOffset = false;
 
-      // Accumulate immediates
-      else if (eramActiveNext && stage1 <= 4 && stage1 > 0) {
-        eramImmOffsetAccNext += eramCtrl << ((stage1 - 1) * 5);
-      }
+      const uint32_t *decode = (const uint32_t*)(&esp->intmem[0x1000]);
+
+      for (int pc = 0; pc < PRAM_SIZE; pc++)
+      {
+        uint32_t eramCtrl = (decode[pc] >> 23) & 0x1f;
+        int stage1 = pc - eramPCStartNext;
+
+        // Transaction start
+        if (!eramActiveNext && ((eramCtrl & 0x18) != 0)) {
+          eramActiveNext = true;
+          eramModeNext = eramCtrl;
+          eramPCStartNext = pc;
+          eramImmOffsetAccNext = 0;
+          stage1 = 0;
+          if ((eramModeNext & 0x7) && !warnedMode) { warnedMode = true; printf("wtf %03x at pc=%04x\n", eramCtrl, pc); }
+        }
+
+        // Accumulate immediates
+        else if (eramActiveNext && stage1 <= 4 && stage1 > 0) {
+          eramImmOffsetAccNext += eramCtrl << ((stage1 - 1) * 5);
+        }
+
+        // Is it time to commit?
+        if (eramActiveCurrent && (pc == eramPCCommit)) {
+          Event e;
+          e.pc = pc;
+          e.type = eramModeCurrent == 0x10 ? EventType::Write : EventType::Read;
+          _events.push_back(e);
+          eramActiveCurrent = false; // done
+        }
 
-      // Is it time to commit?
-      if (eramActiveCurrent && (pc == eramPCCommit)) {
-        if (eramModeCurrent == 0x10) emitWrite(_jit, m_asm);
-        else emitRead(_jit, m_asm);
-        eramActiveCurrent = false; // done
+        // Next stage
+        if (eramActiveNext && stage1 == 5) { // FIXME: stage1 should be 4, but there are some problems with latching
+          if (eramActiveCurrent && !warnedOverlap) { warnedOverlap = true; printf("ERAM transaction already active at pc %03x\n", pc); }
+          eramActiveCurrent = true;
+          eramModeCurrent = eramModeNext;
+          eramPCCommit = eramPCStartNext + ERAM_COMMIT_STAGE;
+          eramActiveNext = false;
+
+          // Addr computation
+          Event e;
+          e.pc = pc;
+          e.type = EventType::ComputeAddr;
+          e.immOffset = eramImmOffsetAccNext;
+          if (eramModeNext == 0x18)
+          {
+            e.immOffset = (eramImmOffsetAccNext >> 1) & 1;
+            highOffset = eramImmOffsetAccNext & 0x100;
+            e.shouldUseVarOffset = true;
+          }
+          e.highOffset = highOffset;
+          _events.push_back(e);
+        }
       }
+    }
+
+    // true if the given events result in the same code as the events that have been emitted
+    bool hasSameCode(const std::vector<Event>& _events) const
+    {
+      if (_events.size() != events.size()) return false;
+
+      for (size_t i = 0; i < events.size(); i++)
+        if (!events[i].sameCode(_events[i])) return false;
+
+      return true;
+    }
+
+    const std::vector<Event>& getEvents() const { return events; }
+
+    void emit(int pc, esp::EspJit& _jit, esp::Builder& m_asm)
+    {
+      for (; nextEvent < events.size() && events[nextEvent].pc == pc; nextEvent++)
+      {
+        const Event& e = events[nextEvent];
 
-      // Next stage
-      if (eramActiveNext && stage1 == 5) { // FIXME: stage1 should be 4, but there are some problems with latching
-        if (eramActiveCurrent) printf("ERAM transaction already active at pc %03x\n", pc);
-        eramActiveCurrent = true;
-        eramModeCurrent = eramModeNext;
-        eramPCCommit = eramPCStartNext + ERAM_COMMIT_STAGE;
-        eramActiveNext = false;
-
-        // Addr computation
-        uint32_t immOffset = eramImmOffsetAccNext;
-        bool shouldUseVarOffset = false;
-        if (eramModeNext == 0x18)
+        switch (e.type)
         {
-          immOffset = (eramImmOffsetAccNext >> 1) & 1;
-          highOffset = eramImmOffsetAccNext & 0x100;
-          shouldUseVarOffset = true;
+        case EventType::Write: emitWrite(_jit, m_asm); break;
+        case EventType::Read: emitRead(_jit, m_asm); break;
+        case EventType::ComputeAddr: emitComputeAddr(_jit, m_asm, e.pc, e.highOffset, e.shouldUseVarOffset); break;
         }
-
-        emitComputeAddr(_jit, m_asm, immOffset, highOffset, shouldUseVarOffset);
       }
     }
 
@@ -412,22 +550,21 @@ private:
 		_jit.eramRead(ERAM_MASK);
     }
 
-    void emitComputeAddr(esp::EspJit& _jit, esp::Builder& m_asm, uint32_t immOffset, bool highOffset, bool shouldUseVarOffset)
+    void emitComputeAddr(esp::EspJit& _jit, esp::Builder& m_asm, uint32_t pc, bool highOffset, bool shouldUseVarOffset)
     {
-		_jit.eramComputeAddr(immOffset, highOffset, shouldUseVarOffset);
+		_jit.eramComputeAddr(pc, highOffset, shouldUseVarOffset);
     }
-  
-    uint16_t eramPCCommit = 0, eramPCStartNext = 0;
-    uint8_t eramModeCurrent = 0, eramModeNext = 0;
-    uint32_t eramImmOffsetAccNext = 0;
-    bool eramActiveCurrent = false, eramActiveNext = false;
-    bool highOffset = false;
+
+    std::vector<Event> events;
+    size_t nextEvent = 0;
+    mutable bool warnedMode = false, warnedOverlap = false;
 
     ESP<lg2eram_size>* esp;
     static constexpr int64_t ERAM_COMMIT_STAGE = 10, ERAM_MASK_FULL = (1 << 19) - 1;
 		enum {eram_size = 1 << lg2eram_size, ERAM_MASK = eram_size - 1};
   };
   ERAMEmitter eramEmitter;
+  std::vector<typename ERAMEmitter::Event> m_eramEvents;
 
   class CoreEmitter
   {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -29,6 +31,26 @@ typedef struct _h8reg{
 	};
 } h8reg;
 
+// Address of an instruction. The address space is not backed by one contiguous block of host memory, which is why the
+// program counter is an address and not a host pointer
+struct h8pc
+{
+	uint32 a {0};
+	h8pc() = default;
+	explicit h8pc(uint32 _a) : a(_a) {}
+	h8pc& operator++()				{++a;return *this;}
+	h8pc operator++(int)			{h8pc r=*this;++a;return r;}
+	h8pc& operator--()				{--a;return *this;}
+	h8pc operator--(int)			{h8pc r=*this;--a;return r;}
+	h8pc& operator+=(int i)			{a+=i;return *this;}
+	h8pc& operator-=(int i)			{a-=i;return *this;}
+	h8pc operator+(int i) const		{return h8pc(a+i);}
+	h8pc operator-(int i) const		{return h8pc(a-i);}
+	int operator-(h8pc o) const		{return (int)(a-o.a);}
+	bool operator==(h8pc o) const	{return a==o.a;}
+	bool operator!=(h8pc o) const	{return a!=o.a;}
+};
+
 class H8SDevice
 {
 public:
@@ -44,12 +66,34 @@ static volatile bool g_dasm = true;
 
 class h8state {
 public:
-	uint8 memory[1<<24] {};
+	// The 24 bit address space is split into pages. Pages that are plain memory (rom/ram) point straight at their backing
+	// storage, which is allocated on first write or load, unwritten memory reads as zero. Only pages that contain
+	// device registers dispatch to H8SDevice, either one device for the whole page or a table with one entry per byte
+	enum
+	{
+		page_bits = 12,
+		page_size = 1 << page_bits,
+		page_mask = page_size - 1,
+		page_count = 1 << (24 - page_bits),
+		invalid_page = page_count
+	};
+
+	struct page
+	{
+		uint8 *direct {nullptr};					// set if the page is plain memory and has backing storage
+		uint8 *directWrite {nullptr};				// same as direct unless writes need to be tracked because the page contains code
+		H8SDevice *device {nullptr};				// set if the whole page is mapped to one device
+		std::unique_ptr<uint8[]> mem;				// backing storage
+		std::unique_ptr<H8SDevice*[]> devices;		// per byte devices if only parts of the page are mapped to devices
+		bool code {false};							// code of this page has been cached, see markCode()
+		uint32 codeVersion {0};						// incremented on every write to a page that contains code
+	};
+
 	h8reg regs[8] {};
-	uint8 *pc {0};		// program counter. pc is ALWAYS a multiple of 2. All instructions are 2bytes
+	h8pc pc;		// program counter. pc is ALWAYS a multiple of 2. All instructions are 2bytes
 	uint8 ccr {128};
 	uint8 exr {0};
-	H8SDevice* maps[1<<24] {};
+	page pages[page_count];
 	unsigned long long  cycles {0};
 	unsigned long long pending_irqs {0};
 	
@@ -77,7 +121,7 @@ public:
 	const char *getRegName16(int r)	const {const char *names[16]={"R0","R1","R2","R3","R4","R5","R6","R7","E0","E1","E2","E3","E4","E5","E6","E7"};return names[r&15];}
 	const char *getRegName32(int r)	const {const char *names[8]={"ER0","ER1","ER2","ER3","ER4","ER5","ER6","ER7"};return names[r&7];}
 	
-	uint32 addr(uint8 *p) {return (uint32)(p-memory);}
+	uint32 addr(h8pc p) {return p.a;}
 	
 	void boot()
 	{
@@ -86,7 +130,7 @@ public:
 		ccr = 128; exr = 0;
 	}
 	
-	uint8 *fail(uint8 *pc)
+	h8pc fail(h8pc pc)
 	{
 		printf("INVALID INSTRUCTION AT %s\n",printAddr(addr(pc)));
 		assert(false);
@@ -96,17 +140,65 @@ public:
 	void memmap(H8SDevice *dev,int start,int len = 1)
 	{
 		dev->setState(this);
-		for (int i=0;i<len;i++) maps[start+i]=dev;
+
+		while (len > 0)
+		{
+			page& p = pages[(start >> page_bits) & (page_count - 1)];
+			const int off = start & page_mask;
+			const int count = len < page_size - off ? len : page_size - off;
+
+			p.direct = p.directWrite = nullptr;
+			p.codeVersion++;
+			fetchPageIndex = invalid_page;
+
+			if (count == page_size)
+			{
+				p.device = dev;
+				p.devices.reset();
+			}
+			else
+			{
+				if (!p.devices)
+				{
+					p.devices.reset(new H8SDevice*[page_size]);
+					for (int i=0;i<page_size;i++) p.devices[i]=p.device;
+					p.device = nullptr;
+				}
+				for (int i=0;i<count;i++) p.devices[off+i]=dev;
+			}
+
+			start += count;
+			len -= count;
+		}
 	}
 	
 	void loadmem(const uint8* data,uint32_t size,uint32_t address)
 	{
-		memcpy(memory + address,data,size);
+		while (size > 0)
+		{
+			const uint32 off = address & page_mask;
+			const uint32 count = size < page_size - off ? size : page_size - off;
+			memcpy(getPageMemory(address) + off,data,count);
+			pages[address >> page_bits].codeVersion++;
+			data += count;
+			address += count;
+			size -= count;
+		}
 	}
 	
 	void readMemory(uint8* to, int from, int len)
 	{
-		memcpy(to, memory + from, len);
+		while (len > 0)
+		{
+			const page& p = pages[(from >> page_bits) & (page_count - 1)];
+			const int off = from & page_mask;
+			const int count = len < page_size - off ? len : page_size - off;
+			if (p.mem)	memcpy(to, p.mem.get() + off, count);
+			else		memset(to, 0, count);
+			to += count;
+			from += count;
+			len -= count;
+		}
 	}
 	
 	void interrupt(int which)
@@ -119,13 +211,19 @@ public:
 	}
 	
 	int getPC() const {return pcoff(pc);}
-	uint8 *makepc(int address) {return address+memory;}
-	int pcoff(uint8* pc) const {return (int)(pc - memory);}
+	h8pc makepc(int address) {return h8pc(address);}
+	int pcoff(h8pc pc) const {return (int)pc.a;}
 	
 	// memory accesses should use these
-	int32 read32(uint8 *from) {return read32((int)(from-memory));}
-	int16 read16(uint8 *from) {return read16((int)(from-memory));}
-	int8 read8(uint8 *from) {return read8((int)(from-memory));}
+	// reads via the program counter are opcode fetches, they are served from the cached code page if it is plain memory
+	int32 read32(h8pc from) {uint32 s=read16(from)&0xffff;s=(s<<16)|(read16(from+2)&0xffff);return s;}
+	int16 read16(h8pc from) {uint16 s=read8(from)&255;s=(s<<8)|(read8(from+1)&255);return s;}
+	int8 read8(h8pc from) {
+		const uint32 a=from.a&0xffffff;
+		if ((a>>page_bits)!=fetchPageIndex && !setFetchPage(a)) return read8((int)a);
+		clockMem(a, lastread);
+		return fetchPage[a & page_mask];
+	}
 	
 	void write32(int32 val,int to) {write16(val>>16,to);write16(val&0xffff,to+2);}
 	uint32 read32(int from) {uint32 s=read16(from)&0xffff;s=(s<<16)|(read16(from+2)&0xffff);return s;}
@@ -135,14 +233,16 @@ public:
 	void write8(int8 byte,int to) {
 		to&=0xffffff;
 		clockMem(to, lastwrite);
-		if (maps[to]) maps[to]->write(to, byte);
-		else memory[to]=byte;
+		page& p = pages[to >> page_bits];
+		if (p.directWrite) p.directWrite[to & page_mask]=byte;
+		else writeSlow(p, byte, to);
 	}
 	int8 read8(int from) {
 		from&=0xffffff;
 		clockMem(from, lastread);
-		if (maps[from]) return maps[from]->read(from);
-		return memory[from];
+		const page& p = pages[from >> page_bits];
+		if (p.direct) return p.direct[from & page_mask];
+		return readSlow(p, from);
 	}
 	
 	void pushL(uint32 val)	{uint32 sp=getSP()-4;write32(val,sp);setSP(sp);}
@@ -150,18 +250,18 @@ public:
 	void pushW(uint16 val)	{uint16 sp=getSP()-2;write16(val,sp);setSP(sp);}
 	uint16 popW() 			{uint16 sp=getSP();setSP(sp+2);return read16(sp);}
 	
-	void pushPC(uint8 *pc,bool andccr=false)
+	void pushPC(h8pc pc,bool andccr=false)
 	{
-		uint32 p=(uint32)((pc-memory)&0xffffff);
+		uint32 p=pc.a&0xffffff;
 		if (andccr) pushL(p | (ccr <<24)); else pushL(p);
 	}
-	uint8 *popPC(bool andccr=false) {
+	h8pc popPC(bool andccr=false) {
 		uint32 p = popL();
 		if (andccr) ccr = p>>24;
-		return (p & 0xffffff) + memory;
+		return h8pc(p & 0xffffff);
 	}
 	
-	uint8 *loadPCFrom(uint32 addr) {return (read32(addr)&0xFFFFFF)+memory;}
+	h8pc loadPCFrom(uint32 addr) {return h8pc(read32(addr)&0xFFFFFF);}
 	
 	void clockI(int I) {cycles += I;}
 	void clockMem(int addr, int& last)
@@ -259,7 +359,66 @@ protected:
 	
 	void ccrflags_set(int bit,int value) {ccr&=~bit;if (value)ccr|=bit;}
 
+	// returns the backing storage of the page that contains address, allocates it if needed
+	uint8 *getPageMemory(uint32 address)
+	{
+		page& p = pages[(address >> page_bits) & (page_count - 1)];
+		if (!p.mem)
+		{
+			p.mem.reset(new uint8[page_size]());
+			if (!p.device && !p.devices)
+			{
+				p.direct = p.mem.get();
+				if (!p.code) p.directWrite = p.direct;
+			}
+		}
+		return p.mem.get();
+	}
+
+	// Marks a page as containing cached code. Writes to it are no longer taken by the fast path but increment the code
+	// version of the page so that caches can detect modified code
+	void markCode(uint32 address)
+	{
+		page& p = pages[(address >> page_bits) & (page_count - 1)];
+		p.code = true;
+		p.directWrite = nullptr;
+	}
+
+	void writeSlow(page& p,int8 byte,int to)
+	{
+		H8SDevice *dev = p.devices ? p.devices[to & page_mask] : p.device;
+		if (dev) dev->write(to, byte);
+		else
+		{
+			getPageMemory(to)[to & page_mask]=byte;
+			if (p.code) {++p.codeVersion; ++codeWrites;}
+		}
+	}
+
+	int8 readSlow(const page& p,int from)
+	{
+		H8SDevice *dev = p.devices ? p.devices[from & page_mask] : p.device;
+		if (dev) return dev->read(from);
+		return p.mem ? p.mem[from & page_mask] : 0;
+	}
+
+	// caches the page for opcode fetches, fails if the page is not plain memory. Code is read straight from the backing
+	// storage, which is why writes to code do not need to invalidate anything
+	bool setFetchPage(uint32 address)
+	{
+		const page& p = pages[address >> page_bits];
+		if (!p.direct) return false;
+		fetchPage = p.direct;
+		fetchPageIndex = address >> page_bits;
+		return true;
+	}
+
 	int lastread {-1}, lastwrite {-1};
+
+	uint8 *fetchPage {nullptr};
+	uint32 fetchPageIndex {invalid_page};
+
+	uint32 codeWrites {0};	// total number of writes to pages that contain code
 };
 
 template<bool execute,bool disassemble>
@@ -270,7 +429,7 @@ public:
 	{
 		pc = handle_instr(pc);
 	}
-	uint8 *handle_instr(uint8 *_pc)
+	h8pc handle_instr(h8pc _pc)
 	{
 		pc = _pc;
 		if (execute && pending_irqs)
@@ -293,146 +452,67 @@ public:
 
 		}
 		if (disassemble && g_dasm) for (int i = 0; i < indent; i++) printf(" ");
-		if (((long long)pc)&1) pc--;	// ALWAYS mask off the bottom bit when loading short or int.
+		if (pc.a&1) pc--;	// ALWAYS mask off the bottom bit when loading short or int.
 		uint8 firstbyte=read8(pc);pc++;
-		switch((firstbyte>>4)&15)
-		{
-		case 0: return handle_instr_0(firstbyte,pc);
-		case 1: return handle_instr_1(firstbyte,pc);
-		case 2: return handle_movba(firstbyte,pc);
-		case 3: return handle_movba(firstbyte,pc);
-		case 4: return handle_bcc(firstbyte,pc);
-		case 5: return handle_instr_5(firstbyte,pc);
-		case 6: return handle_instr_6(firstbyte,pc);
-		case 7:	return handle_instr_7(firstbyte,pc);
-		case 8: return handle_addi(firstbyte,pc);
-		case 9:	return handle_addxi(firstbyte,pc);
-		case 10:return handle_cmpi(firstbyte,pc);
-		case 11:return handle_subxi(firstbyte,pc);
-		case 12:return handle_ori(firstbyte,pc);
-		case 13:return handle_xori(firstbyte,pc);
-		case 14:return handle_andi(firstbyte,pc);
-		case 15:return handle_movbi(firstbyte,pc);
-		}
-		return 0;
+		return (this->*dispatch[firstbyte])(firstbyte,pc);
 	}
 protected:
-	uint8 *handle_instr_0(uint8 op,uint8 *pc)
-	{
-		switch (op&15)
-		{
-		case 0:	return handle_nop(op,pc);
-		case 1:	return handle_instr_01(op,pc);
-		case 2:	return handle_stcr(op,pc);
-		case 3:	return handle_ldcr(op,pc);
-		case 4:	return handle_orc(op,pc);
-		case 5:	return handle_xorc(op,pc);
-		case 6:	return handle_andc(op,pc);
-		case 7:	return handle_ldci(op,pc);
-		case 8: return handle_addr(op,pc);
-		case 9: return handle_addrw(op,pc);
-		case 10:return handle_instr_0a(op,pc);
-		case 11:return handle_instr_0b(op,pc);
-		case 12:return handle_movr(op,pc);
-		case 13:return handle_movrw(op,pc);
-		case 14:return handle_addxr(op,pc);
-		case 15:return handle_instr_0f(op,pc);
-		}
-		return 0;
-	}
-	uint8 *handle_instr_1(uint8 op,uint8 *pc)
-	{
-		switch (op&15)
-		{
-		case 0:	return handle_instr_10(op,pc);
-		case 1:	return handle_instr_11(op,pc);
-		case 2:	return handle_instr_12(op,pc);
-		case 3:	return handle_instr_13(op,pc);
-		case 4:	return handle_orr(op,pc);
-		case 5:	return handle_xorr(op,pc);
-		case 6:	return handle_andr(op,pc);
-		case 7:	return handle_instr_17(op,pc);
-		case 8:	return handle_subr(op,pc);
-		case 9:	return handle_subrw(op,pc);
-		case 10:return handle_instr_1a(op,pc);
-		case 11:return handle_instr_1b(op,pc);
-		case 12:return handle_cmpr(op,pc);
-		case 13:return handle_cmprw(op,pc);
-		case 14:return handle_subxr(op,pc);
-		case 15:return handle_instr_1f(op,pc);
-		}
-		return 0;
-	}
-	uint8 *handle_instr_5(uint8 op,uint8 *pc)
-	{
-		switch (op&15)
-		{
-		case 0:	return handle_mulxu(op,pc);
-		case 1:	return handle_divxu(op,pc);
-		case 2:	return handle_mulxuw(op,pc);
-		case 3:	return handle_divxuw(op,pc);
-		case 4:	return handle_rts(op,pc);
-		case 5: return handle_bsr(op,pc);
-		case 6:	return handle_rte(op,pc);
-		case 7: return handle_trapa(op,pc);
-		case 8:	return handle_bccw(op,pc);
-		case 9:	return handle_jmpae(op,pc);
-		case 10:return handle_jmpimm(op,pc);
-		case 11:return handle_jmpaa(op,pc);
-		case 12:return handle_bsrw(op,pc);
-		case 13:return handle_jsrae(op,pc);
-		case 14:return handle_jsrimm(op,pc);
-		case 15:return handle_jsraa(op,pc);
-		}
-		return 0;
-	}
-	uint8 *handle_instr_6(uint8 op,uint8 *pc)
-	{
-		switch (op&15)
-		{
-		case 0: return handle_bsetr(op,pc);
-		case 1: return handle_bnotr(op,pc);
-		case 2: return handle_bclrr(op,pc);
-		case 3: return handle_btstr(op,pc);
-		case 4:	return handle_orrw(op,pc);
-		case 5:	return handle_xorrw(op,pc);
-		case 6:	return handle_andrw(op,pc);
-		case 7:	return handle_bsti(op,pc);
-		case 8: return handle_movbae(op,pc);
-		case 9:	return handle_movwae(op,pc);
-		case 10:return handle_instr_6a(op,pc);
-		case 11:return handle_movwaa(op,pc);
-		case 12:return handle_movbaep(op,pc);
-		case 13:return handle_movwaep(op,pc);
-		case 14:return handle_movbaeo(op,pc);
-		case 15:return handle_movwaeo(op,pc);
-		}
-		return 0;
-	}
-	uint8 *handle_instr_7(uint8 op,uint8 *pc)
-	{
-		switch (op&15)
-		{
-		case 0: return handle_bseti(op,pc);
-		case 1: return handle_bnoti(op,pc);
-		case 2: return handle_bclri(op,pc);
-		case 3: return handle_btsti(op,pc);
-		case 4:	return handle_bor(op,pc);
-		case 5:	return handle_bxor(op,pc);
-		case 6: return handle_band(op,pc);
-		case 7: return handle_bld(op,pc);
-		case 8: return handle_movbwaed(op,pc);
-		case 9:	return handle_instr_79(op,pc);
-		case 10:return handle_instr_7a(op,pc);
-		case 11:return handle_eepmov(op,pc);
-		case 12:return handle_bitstuff_1(op,pc);
-		case 13:return handle_bitstuff_1(op,pc);
-		case 14:return handle_bitstuff_1(op,pc);
-		case 15:return handle_bitstuff_1(op,pc);
-		}
-		return 0;
-	}
-	uint8 *handle_instr_01(uint8 op,uint8 *pc)
+	typedef h8pc (H8S::*handler)(uint8 op,h8pc pc);
+
+	// First level of instruction decoding, resolves the first opcode byte to its handler with a single indirect call
+	// instead of switching on both nibbles
+	static std::array<handler,256> createDispatchTable()
+	{
+		const handler groups[16] = {
+			nullptr,				nullptr,				&H8S::handle_movba,		&H8S::handle_movba,
+			&H8S::handle_bcc,		nullptr,				nullptr,				nullptr,
+			&H8S::handle_addi,		&H8S::handle_addxi,		&H8S::handle_cmpi,		&H8S::handle_subxi,
+			&H8S::handle_ori,		&H8S::handle_xori,		&H8S::handle_andi,		&H8S::handle_movbi};
+		const handler group0[16] = {
+			&H8S::handle_nop,		&H8S::handle_instr_01,	&H8S::handle_stcr,		&H8S::handle_ldcr,
+			&H8S::handle_orc,		&H8S::handle_xorc,		&H8S::handle_andc,		&H8S::handle_ldci,
+			&H8S::handle_addr,		&H8S::handle_addrw,		&H8S::handle_instr_0a,	&H8S::handle_instr_0b,
+			&H8S::handle_movr,		&H8S::handle_movrw,		&H8S::handle_addxr,		&H8S::handle_instr_0f};
+		const handler group1[16] = {
+			&H8S::handle_instr_10,	&H8S::handle_instr_11,	&H8S::handle_instr_12,	&H8S::handle_instr_13,
+			&H8S::handle_orr,		&H8S::handle_xorr,		&H8S::handle_andr,		&H8S::handle_instr_17,
+			&H8S::handle_subr,		&H8S::handle_subrw,		&H8S::handle_instr_1a,	&H8S::handle_instr_1b,
+			&H8S::handle_cmpr,		&H8S::handle_cmprw,		&H8S::handle_subxr,		&H8S::handle_instr_1f};
+		const handler group5[16] = {
+			&H8S::handle_mulxu,		&H8S::handle_divxu,		&H8S::handle_mulxuw,	&H8S::handle_divxuw,
+			&H8S::handle_rts,		&H8S::handle_bsr,		&H8S::handle_rte,		&H8S::handle_trapa,
+			&H8S::handle_bccw,		&H8S::handle_jmpae,		&H8S::handle_jmpimm,	&H8S::handle_jmpaa,
+			&H8S::handle_bsrw,		&H8S::handle_jsrae,		&H8S::handle_jsrimm,	&H8S::handle_jsraa};
+		const handler group6[16] = {
+			&H8S::handle_bsetr,		&H8S::handle_bnotr,		&H8S::handle_bclrr,		&H8S::handle_btstr,
+			&H8S::handle_orrw,		&H8S::handle_xorrw,		&H8S::handle_andrw,		&H8S::handle_bsti,
+			&H8S::handle_movbae,	&H8S::handle_movwae,	&H8S::handle_instr_6a,	&H8S::handle_movwaa,
+			&H8S::handle_movbaep,	&H8S::handle_movwaep,	&H8S::handle_movbaeo,	&H8S::handle_movwaeo};
+		const handler group7[16] = {
+			&H8S::handle_bseti,		&H8S::handle_bnoti,		&H8S::handle_bclri,		&H8S::handle_btsti,
+			&H8S::handle_bor,		&H8S::handle_bxor,		&H8S::handle_band,		&H8S::handle_bld,
+			&H8S::handle_movbwaed,	&H8S::handle_instr_79,	&H8S::handle_instr_7a,	&H8S::handle_eepmov,
+			&H8S::handle_bitstuff_1,&H8S::handle_bitstuff_1,&H8S::handle_bitstuff_1,&H8S::handle_bitstuff_1};
+
+		std::array<handler,256> table {};
+		for (int i=0;i<256;i++)
+		{
+			switch (i>>4)
+			{
+			case 0:	table[i]=group0[i&15];	break;
+			case 1:	table[i]=group1[i&15];	break;
+			case 5:	table[i]=group5[i&15];	break;
+			case 6:	table[i]=group6[i&15];	break;
+			case 7:	table[i]=group7[i&15];	break;
+			default:table[i]=groups[i>>4];	break;
+			}
+		}
+		return table;
+	}
+
+	static inline const std::array<handler,256> dispatch = createDispatchTable();
+
+	h8pc handle_instr_01(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -450,7 +530,7 @@ protected:
 		default:return fail(pc-2);	// 0x6 is MAC instruction, 0xA is CLRMAC instruction.
 		}
 	}
-	uint8 *handle_instr_0a(uint8 op,uint8 *pc)
+	h8pc handle_instr_0a(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -467,7 +547,7 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_0b(uint8 op,uint8 *pc)
+	h8pc handle_instr_0b(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -482,7 +562,7 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_0f(uint8 op,uint8 *pc)
+	h8pc handle_instr_0f(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -499,35 +579,35 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_10(uint8 op,uint8 *pc)
+	h8pc handle_instr_10(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		int top=(b>>4)&7; if (top==2 || top==6) return fail(pc-2);
 		if (b&128) 	return handle_shal(op, b, pc);
 		else		return handle_shll(op, b, pc);
 	}
-	uint8 *handle_instr_11(uint8 op,uint8 *pc)
+	h8pc handle_instr_11(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		int top=(b>>4)&7; if (top==2 || top==6) return fail(pc-2);
 		if (b&128) 	return handle_shar(op, b, pc);
 		else		return handle_shlr(op, b, pc);
 	}
-	uint8 *handle_instr_12(uint8 op,uint8 *pc)
+	h8pc handle_instr_12(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		int top=(b>>4)&7; if (top==2 || top==6) return fail(pc-2);
 		if (b&128) 	return handle_rotl(op, b, pc);
 		else		return handle_rotxl(op, b, pc);
 	}
-	uint8 *handle_instr_13(uint8 op,uint8 *pc)
+	h8pc handle_instr_13(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		int top=(b>>4)&7; if (top==2 || top==6) return fail(pc-2);
 		if (b&128) 	return handle_rotr(op, b, pc);
 		else		return handle_rotxr(op, b, pc);
 	}
-	uint8 *handle_instr_17(uint8 op,uint8 *pc)
+	h8pc handle_instr_17(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -545,14 +625,14 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_1a(uint8 op,uint8 *pc)
+	h8pc handle_instr_1a(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		if (b&0x80) return handle_subl(op, b, pc);
 		if (!(b&0xf0)) return handle_decb(op, b, pc);
 		return fail(pc-2);
 	}
-	uint8 *handle_instr_1b(uint8 op,uint8 *pc)
+	h8pc handle_instr_1b(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -567,14 +647,14 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_1f(uint8 op,uint8 *pc)
+	h8pc handle_instr_1f(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		if (b&0x80) return handle_cmpl(op, b, pc);
 		if (!(b&0xf0)) return handle_das(op, b, pc);
 		return fail(pc-2);
 	}
-	uint8 *handle_instr_6a(uint8 op,uint8 *pc)
+	h8pc handle_instr_6a(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -590,7 +670,7 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_79(uint8 op,uint8 *pc)
+	h8pc handle_instr_79(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -605,7 +685,7 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_7a(uint8 op,uint8 *pc)
+	h8pc handle_instr_7a(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		switch ((b>>4)&15)
@@ -620,7 +700,7 @@ protected:
 		default:return fail(pc-2);
 		}
 	}
-	uint8 *handle_instr_01c(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_instr_01c(uint8 op, uint8 b, h8pc pc)
 	{
 		if (b&15) return fail(pc-2);
 		int c=read8(pc);pc++;
@@ -632,9 +712,9 @@ protected:
 		case 2:	return handle_mulxsw(d, pc);
 		return fail(pc-4);
 		}
-		return 0;
+		return h8pc();
 	}
-	uint8 *handle_instr_01d(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_instr_01d(uint8 op, uint8 b, h8pc pc)
 	{
 		if (b&15) return fail(pc-2);
 		int c=read8(pc);pc++;
@@ -646,9 +726,9 @@ protected:
 		case 3:	return handle_divxsw(d, pc);
 		return fail(pc-4);
 		}
-		return 0;
+		return h8pc();
 	}
-	uint8 *handle_instr_01f(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_instr_01f(uint8 op, uint8 b, h8pc pc)
 	{
 		if (b&15) return fail(pc-2);
 		int c=read8(pc);pc++;
@@ -662,12 +742,12 @@ protected:
 		case 6: return handle_andrl(d, pc);
 		default:return fail(pc-4);
 		}
-		return 0;
+		return h8pc();
 	}
 
 
 	//////// MOV.B @immediate,Reg
-	uint8 *handle_movba(uint8 op,uint8 *pc)
+	h8pc handle_movba(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=((read8(pc))&255)+0xFFFF00;pc++;op=(op>>4)&15;
 		if (disassemble)
@@ -682,9 +762,9 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_movbaa(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_movbaa(uint8 op,uint8 b,h8pc pc)
 	{
-		uint8 *startpc=pc-2;int rd=b&15,regsrc=(b&0x80)?1:0,size=(b&0x20)?1:0;
+		h8pc startpc=pc-2;int rd=b&15,regsrc=(b&0x80)?1:0,size=(b&0x20)?1:0;
 		int imm=0;if (size) {imm=read32(pc);pc+=4;} else {imm=se16(read16(pc));pc+=2;}
 		if (disassemble)
 		{
@@ -698,7 +778,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_movbae(uint8 op,uint8 *pc)
+	h8pc handle_movbae(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int er=(r>>4)&7,d=(r>>7)&1;r&=15;
 		if (disassemble)
@@ -712,7 +792,7 @@ protected:
 		ccrflags_val(reg8(r));
 		return pc;
 	}
-	uint8 *handle_movwae(uint8 op,uint8 *pc)
+	h8pc handle_movwae(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int er=(r>>4)&7,d=(r>>7)&1;r&=15;
 		if (disassemble)
@@ -726,9 +806,9 @@ protected:
 		ccrflags_val(reg16(r));
 		return pc;
 	}
-	uint8 *handle_movwaa(uint8 op,uint8 *pc)
+	h8pc handle_movwaa(uint8 op,h8pc pc)
 	{
-		uint8 *ipc=pc-1;int r=read8(pc);pc++;int sub=(r>>4)&15;r&=15;int d=sub&8;
+		h8pc ipc=pc-1;int r=read8(pc);pc++;int sub=(r>>4)&15;r&=15;int d=sub&8;
 		int offset=read16(pc);pc+=2;
 		if (sub&5)	return fail(pc);	// valid values are 0,2,8,10
 		if (sub&2) {offset=(offset<<16)|(read16(pc) & 0xffff);pc+=2;} else offset=se16(offset);
@@ -742,7 +822,7 @@ protected:
 		ccrflags_val(reg16(r));
 		return pc;
 	}
-	uint8 *handle_movbaep(uint8 op,uint8 *pc)
+	h8pc handle_movbaep(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int e=(r>>4)&7,d=(r>>7)&1;r&=15;
 		if (disassemble)
@@ -757,7 +837,7 @@ protected:
 		clockI(2);
 		return pc;
 	}
-	uint8 *handle_movwaep(uint8 op,uint8 *pc)
+	h8pc handle_movwaep(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int e=(r>>4)&7,d=(r>>7)&1;r&=15;
 		if (disassemble)
@@ -773,7 +853,7 @@ protected:
 		ccrflags_val(reg16(r));
 		return pc;
 	}
-	uint8 *handle_movbaeo(uint8 op,uint8 *pc)
+	h8pc handle_movbaeo(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int e=(r>>4)&7,d=(r>>7)&1;r&=15;int offset=read16(pc);pc+=2;
 		if (disassemble)
@@ -787,7 +867,7 @@ protected:
 		ccrflags_val(reg8(r));
 		return pc;
 	}
-	uint8 *handle_movwaeo(uint8 op,uint8 *pc)
+	h8pc handle_movwaeo(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int e=(r>>4)&7,d=(r>>7)&1;r&=15;int offset=read16(pc);pc+=2;
 		if (disassemble)
@@ -801,7 +881,7 @@ protected:
 		ccrflags_val(reg16(r));
 		return pc;
 	}
-	uint8 *handle_movbwaed(uint8 op,uint8 *pc)
+	h8pc handle_movbwaed(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int e=(r>>4);
 		if (r&0x8f)	return fail(pc-2);
@@ -837,9 +917,9 @@ protected:
 		return pc;
 	}
 	
-	uint8* handle_movl(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_movl(uint8 op,uint8 b,h8pc pc)
 	{
-		uint8 *pcstart=pc-2;
+		h8pc pcstart=pc-2;
 		if (b) return fail(pcstart);
 		uint8 c=read8(pc);pc++;
 		if ((c&0xe8)!=0x68) return fail(pcstart);
@@ -907,7 +987,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_movrl(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_movrl(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&0x8) return fail(pc-2);
 		int rd=(b&7),rs=(b>>4)&7;
@@ -917,7 +997,7 @@ protected:
 	}
 	
 	//////// LDM/STM
-	uint8* handle_ldmstm(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_ldmstm(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&7) return fail(pc-2);	// must be zero
 		int c=read8(pc);pc++;
@@ -936,9 +1016,9 @@ protected:
 		return pc;
 	}
 	
-	uint8* handle_ldcstc(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_ldcstc(uint8 op,uint8 b,h8pc pc)
 	{
-		uint8 *pcstart=pc-2;
+		h8pc pcstart=pc-2;
 		if ((b&0xfe)!=0x40) return fail(pcstart);
 		int isexr=(b&1);	// if not exr then ccr
 		uint8 &cr=isexr?exr:ccr;
@@ -1031,7 +1111,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_tas(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_tas(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&0xf) return fail(pc-2);
 		int c=read8(pc);pc++;
@@ -1045,14 +1125,14 @@ protected:
 	}
 	
 	//////// REGISTER OPS
-	uint8 *handle_movr(uint8 op,uint8 *pc)
+	h8pc handle_movr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"MOV.B","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute) {int8 &src=reg8(rs), &dst=reg8(rd);	ccrflags_val(src);	dst=src; }
 		return pc;
 	}
-	uint8 *handle_movrw(uint8 op,uint8 *pc)
+	h8pc handle_movrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"MOV.W","%s,%s",getRegName16(rs),getRegName16(rd));
@@ -1060,7 +1140,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_orr(uint8 op,uint8 *pc)
+	h8pc handle_orr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"OR.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1068,14 +1148,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_orrw(uint8 op,uint8 *pc)
+	h8pc handle_orrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"OR.W","%s,%s",getRegName16(rs),getRegName16(rd));
 		if (execute) {int16 &src=reg16(rs),&dst=reg16(rd);	dst|=src;	ccrflags_val(dst); }
 		return pc;
 	}
-	uint8 *handle_orrl(uint8 d,uint8 *pc)
+	h8pc handle_orrl(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (disassemble)	dasm(pc-4,"OR.L","%s,%s",getRegName32(rs),getRegName32(rd));
@@ -1083,7 +1163,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_xorr(uint8 op,uint8 *pc)
+	h8pc handle_xorr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"XOR.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1091,14 +1171,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_xorrw(uint8 op,uint8 *pc)
+	h8pc handle_xorrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"XOR.W","%s,%s",getRegName16(rs),getRegName16(rd));
 		if (execute) {int16 &src=reg16(rs),&dst=reg16(rd);	dst^=src;	ccrflags_val(dst); }
 		return pc;
 	}
-	uint8 *handle_xorrl(uint8 d,uint8 *pc)
+	h8pc handle_xorrl(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (disassemble)	dasm(pc-4,"XOR.L","%s,%s",getRegName32(rs),getRegName32(rd));
@@ -1106,7 +1186,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_andr(uint8 op,uint8 *pc)
+	h8pc handle_andr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"AND.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1114,14 +1194,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_andrw(uint8 op,uint8 *pc)
+	h8pc handle_andrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"AND.W","%s,%s",getRegName16(rs),getRegName16(rd));
 		if (execute) {int16 &src=reg16(rs),&dst=reg16(rd);	dst&=src;	ccrflags_val(dst); }
 		return pc;
 	}
-	uint8 *handle_andrl(uint8 d,uint8 *pc)
+	h8pc handle_andrl(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (disassemble)	dasm(pc-4,"AND.L","%s,%s",getRegName32(rs),getRegName32(rd));
@@ -1129,14 +1209,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_incb(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_incb(uint8 op,uint8 b,h8pc pc)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"INC.B","%s",getRegName8(r));
 		if (execute) {int v = reg8(r)+1; ccrflags_val(v); ccrflags_set(ccr_v, (~reg8(r) & v) & 0x80); reg8(r) = v;}
 		return pc;
 	}
-	uint8 *handle_decb(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_decb(uint8 op,uint8 b,h8pc pc)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"DEC.B","%s",getRegName8(r));
@@ -1144,14 +1224,14 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_incwi(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_incwi(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"INC.W","#%d,%s",imm,getRegName16(r));
 		if (execute) {int v = reg16(r)+imm; ccrflags_val(v); ccrflags_set(ccr_v, (~reg16(r) & v) & 0x8000); reg16(r) = v;}
 		return pc;
 	}
-	uint8 *handle_decwi(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_decwi(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"DEC.W","#%d,%s",imm,getRegName16(r));
@@ -1159,7 +1239,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_incli(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_incli(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		if (b&0x8) return fail(pc-2);
 		int r=b&0xf;
@@ -1167,7 +1247,7 @@ protected:
 		if (execute) {int v = reg32(r)+imm; ccrflags_val(v); ccrflags_set(ccr_v, (~reg32(r) & v) & 0x80000000); reg32(r) = v;}
 		return pc;
 	}
-	uint8 *handle_decli(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_decli(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		if (b&0x8) return fail(pc-2);
 		int r=b&0xf;
@@ -1177,7 +1257,7 @@ protected:
 
 	}
 	
-	uint8 *handle_addr(uint8 op,uint8 *pc)
+	h8pc handle_addr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"ADD.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1185,7 +1265,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_addxr(uint8 op,uint8 *pc)
+	h8pc handle_addxr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"ADDX.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1193,7 +1273,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_addrw(uint8 op,uint8 *pc)
+	h8pc handle_addrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"ADD.W","%s,%s",getRegName16(rs),getRegName16(rd));
@@ -1201,7 +1281,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_addsi(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_addsi(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		if (b&0x8) return fail(pc-2);
 		int rd=(b&7);
@@ -1210,7 +1290,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_subsi(uint8 op,uint8 b,uint8 *pc,int imm)
+	h8pc handle_subsi(uint8 op,uint8 b,h8pc pc,int imm)
 	{
 		if (b&0x8) return fail(pc-2);
 		int rd=(b&7);
@@ -1219,7 +1299,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_addl(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_addl(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&0x8) return fail(pc-2);
 		int rs=(b>>4)&7,rd=(b&7);
@@ -1228,7 +1308,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_subr(uint8 op,uint8 *pc)
+	h8pc handle_subr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"SUB.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1236,7 +1316,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_subxr(uint8 op,uint8 *pc)
+	h8pc handle_subxr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"SUBX.B","%s,%s",getRegName8(rs),getRegName8(rd));
@@ -1244,14 +1324,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_subrw(uint8 op,uint8 *pc)
+	h8pc handle_subrw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"SUB.W","%s,%s",getRegName16(rs),getRegName16(rd));
 		if (execute) reg16(rd)=sub16(reg16(rd),reg16(rs));
 		return pc;
 	}
-	uint8 *handle_subl(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_subl(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&8) return fail(pc-2);
 		int rd=b&7,rs=(b>>4)&7;
@@ -1259,7 +1339,7 @@ protected:
 		if (execute)		reg32(rd)=sub32(reg32(rd),reg32(rs));
 		return pc;
 	}
-	uint8 *handle_cmpl(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_cmpl(uint8 op,uint8 b,h8pc pc)
 	{
 		if (b&8) return fail(pc-2);
 		int rd=b&7,rs=(b>>4)&7;
@@ -1268,14 +1348,14 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_cmpr(uint8 op,uint8 *pc)
+	h8pc handle_cmpr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"CMP.B","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute) sub8(reg8(rd),reg8(rs));
 		return pc;
 	}
-	uint8 *handle_cmprw(uint8 op,uint8 *pc)
+	h8pc handle_cmprw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"CMP.W","%s,%s",getRegName16(rs),getRegName16(rd));
@@ -1283,21 +1363,21 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_mulxu(uint8 op,uint8 *pc)
+	h8pc handle_mulxu(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"MULXU.B","%s,%s",getRegName8(rs),getRegName16(rd));
 		if (execute) {int a=(reg8(rs)&255),b=(reg16(rd)&255);int16 &d=reg16(rd);d=a*b; clockI(12);}
 		return pc;
 	}
-	uint8 *handle_mulxs(uint8 d,uint8 *pc)
+	h8pc handle_mulxs(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (disassemble)	dasm(pc-4,"MULXS.B","%s,%s",getRegName8(rs),getRegName16(rd));
 		if (execute) {int a=reg8(rs),b=se8(reg16(rd));int16 &d=reg16(rd);d=a*b;ccrflags_set(ccr_n,d<0);ccrflags_set(ccr_z,!d); clockI(12);}
 		return pc;
 	}
-	uint8 *handle_divxu(uint8 op,uint8 *pc)
+	h8pc handle_divxu(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (rd&8) printf("UNDEFINED BEHAVIOUR. Attempting to divide E register\n");
@@ -1314,7 +1394,7 @@ protected:
 		}
 		return pc;
 	}
-	uint8 *handle_divxs(uint8 d,uint8 *pc)
+	h8pc handle_divxs(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (rd&8) printf("UNDEFINED BEHAVIOUR. Attempting to divide E register\n");
@@ -1333,7 +1413,7 @@ protected:
 		return pc;
 	}
 		
-	uint8 *handle_mulxuw(uint8 op,uint8 *pc)
+	h8pc handle_mulxuw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (rd&8) return fail(pc-2);
@@ -1341,7 +1421,7 @@ protected:
 		if (execute) {uint32 a=(reg16(rs)&65535),b=(reg32(rd)&65535);reg32(rd)=a*b; clockI(20);}
 		return pc;
 	}
-	uint8 *handle_mulxsw(uint8 d,uint8 *pc)
+	h8pc handle_mulxsw(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (rd&8) return fail(pc-4);
@@ -1349,7 +1429,7 @@ protected:
 		if (execute) {int a=reg16(rs),b=se16(reg32(rd));int32 &d=reg32(rd);d=a*b;ccrflags_set(ccr_n,d<0);ccrflags_set(ccr_z,!d); clockI(20);}
 		return pc;
 	}
-	uint8 *handle_divxuw(uint8 op,uint8 *pc)
+	h8pc handle_divxuw(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (rd&8) return fail(pc-2);
@@ -1366,7 +1446,7 @@ protected:
 		}
 		return pc;
 	}
-	uint8 *handle_divxsw(uint8 d,uint8 *pc)
+	h8pc handle_divxsw(uint8 d,h8pc pc)
 	{
 		int rs=(d>>4)&15,rd=(d)&15;
 		if (rd&8) return fail(pc-4);
@@ -1386,7 +1466,7 @@ protected:
 	}
 	
 	//////// Shifts
-	uint8 *handle_shal(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_shal(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1410,7 +1490,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_shll(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_shll(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1430,7 +1510,7 @@ protected:
 		if (size==1) reg8(r)=v&0xff; else if (size==2) reg16(r)=v&0xffff; else if (size==4) reg32(r)=v;
 		return pc;
 	}
-	uint8 *handle_shar(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_shar(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1450,7 +1530,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_shlr(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_shlr(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1470,7 +1550,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_rotl(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_rotl(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1491,7 +1571,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_rotxl(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_rotxl(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1514,7 +1594,7 @@ protected:
 		if (size==1) reg8(r)=v&0xff; else if (size==2) reg16(r)=v&0xffff; else if (size==4) reg32(r)=v;
 		return pc;
 	}
-	uint8 *handle_rotr(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_rotr(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1536,7 +1616,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_rotxr(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_rotxr(uint8 op, uint8 b, h8pc pc)
 	{
 		int shift=(b&64)?2:1, size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1562,14 +1642,14 @@ protected:
 	}
 	
 	//////// BITWISE OPS
-	uint8 *handle_bsetr(uint8 op,uint8 *pc)
+	h8pc handle_bsetr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"BSET","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute)		reg8(rd)|=1<<(reg8(rs)&7);
 		return pc;
 	}
-	uint8 *handle_bseti(uint8 op,uint8 *pc)
+	h8pc handle_bseti(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&15,rd=(regs)&15;
 		if (imm&8) return fail(pc-2);
@@ -1578,14 +1658,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_bnotr(uint8 op,uint8 *pc)
+	h8pc handle_bnotr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"BNOT","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute)		reg8(rd)^=1<<(reg8(rs)&7);
 		return pc;
 	}
-	uint8 *handle_bnoti(uint8 op,uint8 *pc)
+	h8pc handle_bnoti(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&15,rd=(regs)&15;
 		if (imm&8) return fail(pc-2);
@@ -1594,14 +1674,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_bclrr(uint8 op,uint8 *pc)
+	h8pc handle_bclrr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"BCLR","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute)		reg8(rd)&=~(1<<(reg8(rs)&7));
 		return pc;
 	}
-	uint8 *handle_bclri(uint8 op,uint8 *pc)
+	h8pc handle_bclri(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&15,rd=(regs)&15;
 		if (imm&8) return fail(pc-2);
@@ -1610,14 +1690,14 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_btstr(uint8 op,uint8 *pc)
+	h8pc handle_btstr(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int rs=(regs>>4)&15,rd=(regs)&15;
 		if (disassemble)	dasm(pc-2,"BTST","%s,%s",getRegName8(rs),getRegName8(rd));
 		if (execute)		ccrflags_set(ccr_z,!(reg8(rd)&(1<<(reg8(rs)&7))));
 		return pc;
 	}
-	uint8 *handle_btsti(uint8 op,uint8 *pc)
+	h8pc handle_btsti(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&15,rd=(regs)&15;
 		if (imm&8) return fail(pc-2);
@@ -1626,7 +1706,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_bsti(uint8 op,uint8 *pc)
+	h8pc handle_bsti(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&7,rd=(regs)&15,n=(regs>>7)&1;
 		if (disassemble)	dasm(pc-2,n?"BIST":"BST","#%d,%s",imm,getRegName8(rd));
@@ -1634,28 +1714,28 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_bor(uint8 op,uint8 *pc)
+	h8pc handle_bor(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&7,rd=(regs)&15,n=(regs>>7)&1;
 		if (disassemble)	dasm(pc-2,n?"BIOR":"BOR","#%d,%s",imm,getRegName8(rd));
 		if (execute)		ccrflags_set(ccr_c,(ccr&1) | (((reg8(rd)>>imm)&1)^n));
 		return pc;
 	}
-	uint8 *handle_bxor(uint8 op,uint8 *pc)
+	h8pc handle_bxor(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&7,rd=(regs)&15,n=(regs>>7)&1;
 		if (disassemble)	dasm(pc-2,n?"BIXOR":"BXOR","#%d,%s",imm,getRegName8(rd));
 		if (execute)		ccrflags_set(ccr_c,(ccr&1) ^ (((reg8(rd)>>imm)&1)^n));
 		return pc;
 	}
-	uint8 *handle_band(uint8 op,uint8 *pc)
+	h8pc handle_band(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&7,rd=(regs)&15,n=(regs>>7)&1;
 		if (disassemble)	dasm(pc-2,n?"BIAND":"BAND","#%d,%s",imm,getRegName8(rd));
 		if (execute)		ccrflags_set(ccr_c,(ccr&1) & (((reg8(rd)>>imm)&1)^n));
 		return pc;
 	}
-	uint8 *handle_bld(uint8 op,uint8 *pc)
+	h8pc handle_bld(uint8 op,h8pc pc)
 	{
 		int regs=read8(pc);pc++;	int imm=(regs>>4)&7,rd=(regs)&15,n=(regs>>7)&1;
 		if (disassemble)	dasm(pc-2,n?"BILD":"BLD","#%d,%s",imm,getRegName8(rd));
@@ -1663,7 +1743,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_not(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_not(uint8 op, uint8 b, h8pc pc)
 	{
 		int size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1681,7 +1761,7 @@ protected:
 		}
 		return pc;
 	}
-	uint8 *handle_neg(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_neg(uint8 op, uint8 b, h8pc pc)
 	{
 		int size=((b>>4)&3)+1, r=(b&15);	// size=1,2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1699,7 +1779,7 @@ protected:
 		}
 		return pc;
 	}
-	uint8 *handle_extu(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_extu(uint8 op, uint8 b, h8pc pc)
 	{
 		int size=((b>>4)&3)+1, r=(b&15);	// size=2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1715,7 +1795,7 @@ protected:
 		}
 		return pc;
 	}
-	uint8 *handle_exts(uint8 op, uint8 b, uint8 *pc)
+	h8pc handle_exts(uint8 op, uint8 b, h8pc pc)
 	{
 		int size=((b>>4)&3)+1, r=(b&15);	// size=2,4
 		if (size==4 && (r&8)) return fail(pc-2);
@@ -1732,7 +1812,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *inner_bitstuff_aa(int c,int d,int aa,int type,uint8 *startpc,uint8 *pc)
+	h8pc inner_bitstuff_aa(int c,int d,int aa,int type,h8pc startpc,h8pc pc)
 	{
 		int rn=(d>>4),imm=(d>>4)&7,inv=(d&0x80)?1:0;	// Only some of these are valid/used depending on op.
 
@@ -1807,7 +1887,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_bitstuff_1(uint8 op,uint8 *pc)	// to get here, op==0x7c, 0x7d, 0x7e, 0x7f
+	h8pc handle_bitstuff_1(uint8 op,h8pc pc)	// to get here, op==0x7c, 0x7d, 0x7e, 0x7f
 	{
 		int b=read8(pc);pc++;
 		int c=read8(pc);pc++;
@@ -1895,9 +1975,9 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_bitstuff_2(uint8 op,uint8 b,uint8 *pc)	// op=6a, b=0x1? or 0x3?
+	h8pc handle_bitstuff_2(uint8 op,uint8 b,h8pc pc)	// op=6a, b=0x1? or 0x3?
 	{
-		uint8 *startpc=pc-2;
+		h8pc startpc=pc-2;
 		int aa=0;
 		if ((b&0xf0)==0x10)	{aa=se16(read16(pc));pc+=2;} else {aa=read32(pc);pc+=4;};
 		int c=read8(pc);pc++;
@@ -1906,56 +1986,56 @@ protected:
 	}
 
 	//////// IMMEDIATE OPS
-	uint8 *handle_cmpi(uint8 op,uint8 *pc)
+	h8pc handle_cmpi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"CMP.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) sub8(reg8(rd),imm);
 		return pc;
 	}
-	uint8 *handle_addi(uint8 op,uint8 *pc)
+	h8pc handle_addi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"ADD.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) reg8(rd)=add8(reg8(rd),imm);
 		return pc;
 	}
-	uint8 *handle_addxi(uint8 op,uint8 *pc)
+	h8pc handle_addxi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"ADDX.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) reg8(rd)=add8(reg8(rd),imm,ccr,1);
 		return pc;
 	}
-	uint8 *handle_subxi(uint8 op,uint8 *pc)
+	h8pc handle_subxi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"SUBX.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) reg8(rd)=sub8(reg8(rd),imm,ccr,1);
 		return pc;
 	}
-	uint8 *handle_ori(uint8 op,uint8 *pc)
+	h8pc handle_ori(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"OR.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) {int8 &r=reg8(rd);	r|=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_xori(uint8 op,uint8 *pc)
+	h8pc handle_xori(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"XOR.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) {int8 &r=reg8(rd);	r^=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_andi(uint8 op,uint8 *pc)
+	h8pc handle_andi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"AND.B","#0x%x,%s",imm,getRegName8(rd));
 		if (execute) {int8 &r=reg8(rd);	r&=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_movbi(uint8 op,uint8 *pc)
+	h8pc handle_movbi(uint8 op,h8pc pc)
 	{
 		int rd=op&15,imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"MOV.B","#0x%x,%s",imm,getRegName8(rd));
@@ -1963,49 +2043,49 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_cmpwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_cmpwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc);pc+=2;
 		if (disassemble) dasm(pc-4,"CMP.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) sub16(reg16(rd),imm);
 		return pc;
 	}
-	uint8 *handle_addwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_addwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc);pc+=2;
 		if (disassemble) dasm(pc-4,"ADD.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) reg16(rd)=add16(reg16(rd),imm);
 		return pc;
 	}
-	uint8 *handle_subwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_subwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc);pc+=2;
 		if (disassemble) dasm(pc-4,"SUB.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) reg16(rd)=sub16(reg16(rd),imm);
 		return pc;
 	}
-	uint8 *handle_orwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_orwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc);pc+=2;
 		if (disassemble) dasm(pc-4,"OR.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) {int16 &r=reg16(rd);	r|=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_xorwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_xorwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc);pc+=2;
 		if (disassemble) dasm(pc-4,"XOR.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) {int16 &r=reg16(rd);	r^=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_andwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_andwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc)&0xffff;pc+=2;
 		if (disassemble) dasm(pc-4,"AND.W","#0x%x,%s",imm,getRegName16(rd));
 		if (execute) {int16 &r=reg16(rd);	r&=imm;	ccrflags_val(r);}
 		return pc;
 	}
-	uint8 *handle_movwi(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_movwi(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read16(pc)&0xffff;pc+=2;
 		if (disassemble) dasm(pc-4,"MOV.W","#0x%x,%s",imm,getRegName16(rd));
@@ -2013,49 +2093,49 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_cmpli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_cmpli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"CMP.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) sub32(reg32(rd),imm);
 		return pc;
 	}
-	uint8 *handle_addli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_addli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"ADD.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) reg32(rd)=add32(reg32(rd),imm);
 		return pc;
 	}
-	uint8 *handle_subli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_subli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"SUB.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) reg32(rd)=sub32(reg32(rd),imm);
 		return pc;
 	}
-	uint8 *handle_orli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_orli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"OR.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) {int32 &r=reg32(rd);	r|=imm;	ccrflags_val(r); }
 		return pc;
 	}
-	uint8 *handle_xorli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_xorli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"XOR.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) {int32 &r=reg32(rd);	r^=imm;	ccrflags_val(r); }
 		return pc;
 	}
-	uint8 *handle_andli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_andli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"AND.L","#0x%x,%s",imm,getRegName32(rd));
 		if (execute) {int32 &r=reg32(rd);	r&=imm;	ccrflags_val(r); }
 		return pc;
 	}
-	uint8 *handle_movli(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_movli(uint8 op,uint8 b,h8pc pc)
 	{
 		int rd=b&15,imm=read32(pc);pc+=4;if (rd&8) return fail(pc-6);
 		if (disassemble) dasm(pc-6,"MOV.L","#0x%08x,%s",imm,getRegName32(rd));
@@ -2064,7 +2144,7 @@ protected:
 	}
 		
 	
-	uint8 *handle_daa(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_daa(uint8 op,uint8 b,h8pc pc)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"DAA","%s",getRegName8(r));
@@ -2078,7 +2158,7 @@ protected:
 		if (toadd>6) ccrflags_set(ccr_c,1);
 		return pc;
 	}
-	uint8 *handle_das(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_das(uint8 op,uint8 b,h8pc pc)
 	{
 		int r=b&0xf;
 		if (disassemble) dasm(pc-2,"DAS","%s",getRegName8(r));
@@ -2092,7 +2172,7 @@ protected:
 	}
 
 	///////// CCR OPS
-	uint8 *handle_stcr(uint8 op,uint8 *pc)
+	h8pc handle_stcr(uint8 op,h8pc pc)
 	{
 		int rd=read8(pc);pc++;
 		if ((rd>>4)>1) return fail(pc-2);
@@ -2100,7 +2180,7 @@ protected:
 		if (execute) {int8 &r=reg8(rd);	r=(rd&0xf0)?exr:ccr;}
 		return pc;
 	}
-	uint8 *handle_ldcr(uint8 op,uint8 *pc)
+	h8pc handle_ldcr(uint8 op,h8pc pc)
 	{
 		int rd=read8(pc);pc++;
 		if ((rd>>4)>1) return fail(pc-2);
@@ -2108,28 +2188,28 @@ protected:
 		if (execute) {const int8 &r=reg8(rd);if (rd&0xf0) exr=r; else ccr=r; }
 		return pc;
 	}
-	uint8 *handle_orc(uint8 op,uint8 *pc)
+	h8pc handle_orc(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"ORC","#0x%02X,CCR",imm&255);
 		if (execute) ccr|=imm;
 		return pc;
 	}
-	uint8 *handle_xorc(uint8 op,uint8 *pc)
+	h8pc handle_xorc(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"XORC","#0x%02X,CCR",imm&255);
 		if (execute) ccr^=imm;
 		return pc;
 	}
-	uint8 *handle_andc(uint8 op,uint8 *pc)
+	h8pc handle_andc(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"ANDC","#0x%02X,CCR",imm&255);
 		if (execute) ccr&=imm;
 		return pc;
 	}
-	uint8 *handle_ldci(uint8 op,uint8 *pc)
+	h8pc handle_ldci(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"LDC","#0x%02X,CCR",imm&255);
@@ -2138,7 +2218,7 @@ protected:
 	}
 	
 	//////// BCC
-	uint8 *inner_bcc(uint8 *startpc,uint8 *pc,int cc,int imm)
+	h8pc inner_bcc(h8pc startpc,h8pc pc,int cc,int imm)
 	{
 		const char *ccs[16]={"BRA","BRN","BHI","BLS","BCC","BCS","BNE","BEQ","BVC","BVS","BPL","BMI","BGE","BLT","BGT","BLE"};
 		if (disassemble) dasm(startpc,ccs[cc],"%s",printAddr(addr(pc+imm)));
@@ -2161,12 +2241,12 @@ protected:
 		if (test==(cc&1)) pc+=imm;	// if it matches, we're set.
 		return pc;
 	}
-	uint8 *handle_bcc(uint8 op,uint8 *pc)
+	h8pc handle_bcc(uint8 op,h8pc pc)
 	{
 		int cc=op&15,imm=read8(pc);pc++;
 		return inner_bcc(pc-2,pc,cc,imm);
 	}
-	uint8 *handle_bccw(uint8 op,uint8 *pc)
+	h8pc handle_bccw(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		if (b&0xf) return fail(pc-2);
@@ -2176,7 +2256,7 @@ protected:
 	}
 
 	
-	uint8 *handle_rts(uint8 op,uint8 *pc)
+	h8pc handle_rts(uint8 op,h8pc pc)
 	{
 		int test=read8(pc);pc++;
 		if (test!=0x70) return fail(pc-2);
@@ -2185,7 +2265,7 @@ protected:
 		return pc;
 	}
 
-	uint8 *handle_rte(uint8 op,uint8 *pc)
+	h8pc handle_rte(uint8 op,h8pc pc)
 	{
 		int test=read8(pc);pc++;
 		if (test!=0x70) return fail(pc-2);
@@ -2194,7 +2274,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_bsr(uint8 op,uint8 *pc)
+	h8pc handle_bsr(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (disassemble) dasm(pc-2,"BSR","%s",printAddr(addr(pc+imm)));
@@ -2204,7 +2284,7 @@ protected:
 		return pc+imm;
 	}
 
-	uint8 *handle_bsrw(uint8 op,uint8 *pc)
+	h8pc handle_bsrw(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (imm) return fail(pc-2);
@@ -2217,7 +2297,7 @@ protected:
 		return pc+imm;
 	}
 	
-	uint8 *handle_trapa(uint8 op,uint8 *pc)
+	h8pc handle_trapa(uint8 op,h8pc pc)
 	{
 		int imm=read8(pc);pc++;
 		if (imm&0xCF) return fail(pc-2);
@@ -2232,22 +2312,22 @@ protected:
 		return loadPCFrom(32+(imm>>2));	// Offset for TRAP calls is 0x20 + 4 * trap number.
 	}
 	
-	uint8 *handle_jmpae(uint8 op,uint8 *pc)
+	h8pc handle_jmpae(uint8 op,h8pc pc)
 	{
 		int er=read8(pc);pc++;
 		if (er&0x8f) return fail(pc-2);
 		if (disassemble) dasm(pc-2,"JMP","@%s",getRegName32(er>>4));
-		if (execute) return (reg32(er>>4)&0xffffff)+memory;
+		if (execute) return h8pc(reg32(er>>4)&0xffffff);
 		return pc;
 	}
-	uint8 *handle_jmpimm(uint8 op,uint8 *pc)
+	h8pc handle_jmpimm(uint8 op,h8pc pc)
 	{
 		int addr=(read16(pc) << 8) | (read8(pc+2) & 0xff);pc+=3;
 		if (disassemble) dasm(pc-4,"JMP","%s",printAddr(addr));
-		if (execute) {clockI(2); return memory+addr;}
+		if (execute) {clockI(2); return h8pc(addr);}
 		return pc;
 	}
-	uint8 *handle_jmpaa(uint8 op,uint8 *pc)
+	h8pc handle_jmpaa(uint8 op,h8pc pc)
 	{
 		int imm=(read8(pc))&255;pc++;
 		if (disassemble) dasm(pc-2,"JMP","@@0x%02x",imm);
@@ -2256,7 +2336,7 @@ protected:
 		return loadPCFrom(imm&~1);	// MASK THIS OFF! It's valid, but ignored.
 	}
 
-	uint8 *handle_jsrae(uint8 op,uint8 *pc)
+	h8pc handle_jsrae(uint8 op,h8pc pc)
 	{
 		int er=read8(pc);pc++;
 		if (er&0x8f) return fail(pc-2);
@@ -2264,9 +2344,9 @@ protected:
 		if (!execute) return pc;
 		pushPC(pc);
 		indent++;
-		return (reg32(er>>4)&0xffffff)+memory;
+		return h8pc(reg32(er>>4)&0xffffff);
 	}
-	uint8 *handle_jsrimm(uint8 op,uint8 *pc)
+	h8pc handle_jsrimm(uint8 op,h8pc pc)
 	{
 		int addr=(read16(pc) << 8) | (read8(pc+2) & 0xff);pc+=3;
 		if (disassemble) dasm(pc-4,"JSR","%s",printAddr(addr));
@@ -2274,9 +2354,9 @@ protected:
 		pushPC(pc);
 		indent++;
 		clockI(2);
-		return memory+addr;
+		return h8pc(addr);
 	}
-	uint8 *handle_jsraa(uint8 op,uint8 *pc)
+	h8pc handle_jsraa(uint8 op,h8pc pc)
 	{
 		int imm=(read8(pc))&255;pc++;
 		if (disassemble) dasm(pc-2,"JSR","@@0x%02x",imm);
@@ -2287,7 +2367,7 @@ protected:
 	}
 
 	
-	uint8 *handle_eepmov(uint8 op,uint8 *pc)
+	h8pc handle_eepmov(uint8 op,h8pc pc)
 	{
 		int r=read8(pc);pc++;int w=0;
 		if (r==0x5c) w=0; else if (r==0xd4) w=1; else return fail(pc-2);
@@ -2309,7 +2389,7 @@ protected:
 	}
 	
 	//////// NOP
-	uint8 *handle_nop(uint8 op,uint8 *pc)
+	h8pc handle_nop(uint8 op,h8pc pc)
 	{
 		int b=read8(pc);pc++;
 		if (b) return fail(pc-2);
@@ -2317,7 +2397,7 @@ protected:
 		return pc;
 	}
 	
-	uint8 *handle_sleep(uint8 op,uint8 b,uint8 *pc)
+	h8pc handle_sleep(uint8 op,uint8 b,h8pc pc)
 	{
 		if (disassemble) dasm(pc-2,"SLEEP","");
 		if (execute) pc-=2;
@@ -2325,7 +2405,7 @@ protected:
 	}
 
 	//////// END OF OPS
-	void dasm(uint8 *pc,const char *op,const char *params,...)
+	void dasm(h8pc pc,const char *op,const char *params,...)
 	{
 		if(!g_dasm)
 			return;
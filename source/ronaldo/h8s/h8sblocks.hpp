@@ -0,0 +1,188 @@
+#pragma once
+#include "h8s.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Executes the H8S in basic blocks instead of single instructions.
+//
+// A block is recorded while it is interpreted for the first time: for every instruction, the resolved handler, the
+// opcode and the address of the following instruction are stored. Replaying a block skips the opcode fetch and the
+// dispatch of the interpreter, the handlers themselves are the same, which means that cycle accounting via
+// clockI/clockMem and all memory and device accesses are identical to the interpreter.
+//
+// A block ends at a change of the control flow, at a page boundary or after max_block_instrs instructions. If an
+// instruction continues somewhere else than recorded, for example a conditional branch that is now taken, the block
+// is left early. Blocks are also left if an unmasked interrupt is pending, which is then taken by the interpreter at
+// the block boundary, and if code has been written to. Blocks are only formed from plain memory pages, code in device
+// memory is interpreted. Consecutive blocks are chained to skip the block lookup.
+//
+// The tick functor passed to stepBlock() is invoked after every instruction, as it would be after every step() of the
+// interpreter. Devices that are ticked there see the same cycle counts and raise their interrupts at the same
+// instruction as with the interpreter.
+class H8SBlockEmulator : public H8SEmulator
+{
+public:
+	enum { max_block_instrs = 32 };
+
+	struct stats
+	{
+		uint64_t blocksRecorded = 0;	// number of blocks that have been recorded, including re-recordings
+		uint64_t blocksInvalidated = 0;	// blocks that had to be recorded again because their code has been written to
+		uint64_t blocksExecuted = 0;	// number of executed blocks
+		uint64_t interpreted = 0;		// instructions executed by the interpreter outside of blocks
+	};
+
+	// executes one block, or one instruction if the current instruction cannot be executed in a block
+	template<typename Tick> void stepBlock(Tick&& tick)
+	{
+		// interrupts are taken by the interpreter
+		if ((pending_irqs && !(ccr & ccr_i)) || (pc.a & 0xff000001))
+		{
+			interpret(tick);
+			return;
+		}
+
+		block *b = (lastBlock && lastBlock->linkpc == pc.a) ? lastBlock->link : nullptr;
+
+		if (!b)
+		{
+			b = findBlock(pc.a);
+
+			if (!b)
+			{
+				interpret(tick);
+				return;
+			}
+
+			if (lastBlock)
+			{
+				lastBlock->link = b;
+				lastBlock->linkpc = pc.a;
+			}
+		}
+
+		const page& p = pages[pc.a >> page_bits];
+
+		if (b->instrs.empty() || b->version != p.codeVersion)
+		{
+			// the page might have been mapped to a device in the meantime
+			if (!p.direct)
+			{
+				interpret(tick);
+				return;
+			}
+			if (!b->instrs.empty()) blockStats.blocksInvalidated++;
+			record(*b, tick);
+		}
+		else
+		{
+			execute(*b, tick);
+		}
+
+		lastBlock = b;
+		blockStats.blocksExecuted++;
+	}
+
+	const stats& getStats() const {return blockStats;}
+
+private:
+	struct instr
+	{
+		handler h;
+		uint32 pc;
+		uint32 next;	// address of the following instruction when the block has been recorded
+		uint8 op;
+	};
+
+	struct block
+	{
+		std::vector<instr> instrs;
+		uint32 version {0};			// code version of the page when the block has been recorded
+		block *link {nullptr};		// block that followed this block the last time
+		uint32 linkpc {0};
+	};
+
+	template<typename Tick> void interpret(Tick& tick)
+	{
+		step();
+		tick();
+		lastBlock = nullptr;
+		blockStats.interpreted++;
+	}
+
+	// Interrupt check that the interpreter does before every instruction. The interrupt controller is read while an
+	// interrupt is pending even if it is masked, which costs a cycle. Returns true if the interrupt needs to be taken
+	bool irqCheck()
+	{
+		if (!pending_irqs) return false;
+		if (!(ccr & ccr_i)) return true;
+		read8(0xfffff2);
+		return false;
+	}
+
+	block *findBlock(uint32 address)
+	{
+		if (!pages[address >> page_bits].direct) return nullptr;
+
+		auto& b = blocks[address];
+		if (!b) b.reset(new block());
+		return b.get();
+	}
+
+	template<typename Tick> void execute(const block& b, Tick& tick)
+	{
+		const uint32 writes = codeWrites;
+
+		for (const instr& i : b.instrs)
+		{
+			if (irqCheck()) return;
+
+			clockMem(i.pc, lastread);	// fetch of the first opcode byte
+			pc = h8pc(i.pc + 1);
+			pc = (this->*i.h)(i.op, pc);
+			tick();
+
+			if (pc.a != i.next || codeWrites != writes) return;
+		}
+	}
+
+	template<typename Tick> void record(block& b, Tick& tick)
+	{
+		blockStats.blocksRecorded++;
+
+		const uint32 pageIndex = pc.a >> page_bits;
+		markCode(pc.a);
+
+		b.instrs.clear();
+		b.version = pages[pageIndex].codeVersion;
+
+		const uint32 writes = codeWrites;
+
+		for (int n=0;n<max_block_instrs;n++)
+		{
+			if (irqCheck()) break;
+
+			const uint32 a = pc.a;
+			const uint8 op = read8(pc);
+			const handler h = dispatch[op];
+			pc = h8pc(a + 1);
+			pc = (this->*h)(op, pc);
+			tick();
+
+			b.instrs.push_back({h, a, pc.a, op});
+
+			// H8S instructions are at most 10 bytes long, everything else has been a jump
+			const uint32 next = pc.a;
+			if (next <= a || next > a + 10 || (next & 0xff000001) || (next >> page_bits) != pageIndex) break;
+			if (codeWrites != writes) break;
+		}
+
+		// the block modified its own code, record it again next time
+		if (codeWrites != writes) b.instrs.clear();
+	}
+
+	std::unordered_map<uint32, std::unique_ptr<block>> blocks;
+	block *lastBlock {nullptr};
+	stats blockStats;
+};
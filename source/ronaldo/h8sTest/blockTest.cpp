@@ -0,0 +1,243 @@
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "h8sTest.h"
+
+#include "h8s/h8sblocks.hpp"
+
+namespace
+{
+	// Deterministic device that records all writes and periodically raises an interrupt when ticked
+	class TestDevice : public H8SDevice
+	{
+	public:
+		uint8_t read(const uint32_t _addr) override
+		{
+			return static_cast<uint8_t>(_addr * 31 + 7);
+		}
+
+		void write(const uint32_t _addr, const uint8_t _val) override
+		{
+			hash = (hash * 1099511628211ull) ^ (_addr * 257 + _val);
+		}
+
+		void tick()
+		{
+			// the hash covers the cycle count and pc of every tick, i.e. it only matches if devices are ticked after
+			// the same instructions
+			hash = (hash * 1099511628211ull) ^ (state->getCycles() * 31 + state->getPC());
+
+			if (state->getCycles() >= nextIrq)
+			{
+				nextIrq += IrqPeriod;
+				state->interrupt(24);
+			}
+		}
+
+		static constexpr uint64_t IrqPeriod = 997;
+
+		uint64_t hash = 0;
+		uint64_t nextIrq = IrqPeriod;
+	};
+
+	constexpr uint32_t ProgramStart = 0x100;
+	constexpr uint32_t ProgramEnd = 0x1c00;	// the program crosses a page boundary
+	constexpr uint32_t IrqHandler = 0x1e00;
+	constexpr uint32_t IrqNumber = 24;
+	constexpr uint32_t RamAddr = 0x200100;
+	constexpr uint32_t StackAddr = 0x201000;
+	constexpr uint32_t DeviceAddr = 0xffff20;
+
+	class ProgramWriter
+	{
+	public:
+		ProgramWriter(std::vector<uint8>& _mem, const uint32_t _pc, std::mt19937& _rng, const bool _irqHandler = false) : m_mem(_mem), m_pc(_pc), m_rng(_rng), m_irqHandler(_irqHandler) {}
+
+		void b(const uint32_t _byte) { m_mem[m_pc++] = static_cast<uint8>(_byte); }
+		void w(const uint32_t _word) { b(_word >> 8); b(_word); }
+		void l(const uint32_t _long) { w(_long >> 16); w(_long); }
+
+		uint32_t rnd(const uint32_t _max) { return m_rng() % _max; }
+
+		// ER4, ER5, ER6 and SP are used as pointers and are never modified by random instructions. The interrupt handler
+		// leaves R0 alone, the program uses R0L to rewrite code with its own value
+		uint32_t dstReg()
+		{
+			if (m_irqHandler)
+			{
+				const uint32_t r = 1 + rnd(6);
+				return r < 4 ? r : r + 5;
+			}
+			const uint32_t r = rnd(8);
+			return r < 4 ? r : r + 4;
+		}
+		uint32_t srcReg() { return rnd(16); }
+
+		uint32_t pc() const { return m_pc; }
+
+		// arithmetic, logic and moves between registers or with immediates
+		void alu()
+		{
+			static constexpr uint8 regOps[] = {0x08, 0x09, 0x0c, 0x0d, 0x14, 0x15, 0x16, 0x18, 0x19, 0x1c, 0x1d};
+			static constexpr uint8 immOps[] = {0x80, 0xa0, 0xc0, 0xd0, 0xe0, 0xf0};
+
+			if (rnd(2))
+			{
+				b(regOps[rnd(std::size(regOps))]);
+				b((srcReg() << 4) | dstReg());
+			}
+			else
+			{
+				b(immOps[rnd(std::size(immOps))] | dstReg());
+				b(rnd(256));
+			}
+		}
+
+		void unit()
+		{
+			switch (rnd(12))
+			{
+			case 0:	// conditional branch over the next instruction
+				b(0x40 | rnd(16));
+				b(2);
+				alu();
+				break;
+			case 1:	// mask or unmask interrupts
+				if (rnd(2))	{ b(0x04); b(0x80); }	// ORC #0x80,CCR
+				else		{ b(0x06); b(0x7f); }	// ANDC #0x7f,CCR
+				break;
+			case 2:	// load and store via ER6 to RAM
+				b(0x68); b((rnd(2) ? 0xe0 | srcReg() : 0x60 | dstReg()));
+				break;
+			case 3:	// device access via ER5
+				b(0x68); b((rnd(2) ? 0xd0 | srcReg() : 0x50 | dstReg()));
+				break;
+			case 4:	// rewrite a byte of the program with its own value, invalidates blocks but keeps the code intact
+				b(0x7a); b(0x04); l(ProgramStart + rnd(ProgramEnd - ProgramStart));
+				b(0x68); b(0x48);	// MOV.B @ER4,R0L
+				b(0x68); b(0xc8);	// MOV.B R0L,@ER4
+				break;
+			case 5:
+				b(0x00); b(0x00);	// NOP
+				break;
+			default:
+				alu();
+				break;
+			}
+		}
+
+	private:
+		std::vector<uint8>& m_mem;
+		uint32_t m_pc;
+		std::mt19937& m_rng;
+		const bool m_irqHandler;
+	};
+
+	// Random but valid code that loops forever. It covers taken and not taken branches, self modifying code, memory
+	// and device accesses and interrupts that are taken, masked and unmasked again
+	void setup(H8SEmulator& _emu, TestDevice& _device, const uint32_t _seed)
+	{
+		std::mt19937 rng(_seed);
+
+		std::vector<uint8> rom(0x2000);
+
+		ProgramWriter vectors(rom, 0, rng);
+		vectors.l(ProgramStart);
+
+		ProgramWriter irqVector(rom, IrqNumber << 2, rng);
+		irqVector.l(IrqHandler);
+
+		ProgramWriter main(rom, ProgramStart, rng);
+		main.b(0x7a); main.b(0x07); main.l(StackAddr);	// MOV.L #StackAddr,SP
+		main.b(0x7a); main.b(0x06); main.l(RamAddr);		// MOV.L #RamAddr,ER6
+		main.b(0x7a); main.b(0x05); main.l(DeviceAddr);	// MOV.L #DeviceAddr,ER5
+
+		const auto loop = main.pc();
+		while (main.pc() < ProgramEnd - 32)
+			main.unit();
+		main.b(0x5a); main.b(loop >> 16); main.w(loop);	// JMP @loop
+
+		ProgramWriter irq(rom, IrqHandler, rng, true);
+		for (uint32_t i=0; i<4; ++i)
+			irq.alu();
+		irq.b(0x56); irq.b(0x70);	// RTE
+
+		_emu.loadmem(rom.data(), static_cast<uint32_t>(rom.size()), 0);
+
+		_emu.memmap(&_device, 0xffff1c, 0xe4);
+
+		_emu.boot();
+	}
+
+	bool sameState(const H8SEmulator& _a, const H8SEmulator& _b)
+	{
+		if (_a.getCycles() != _b.getCycles() || _a.getPC() != _b.getPC())
+			return false;
+		if (_a.ccr != _b.ccr || _a.exr != _b.exr || _a.pending_irqs != _b.pending_irqs)
+			return false;
+		for (int i=0; i<8; ++i)
+		{
+			if (_a.regs[i].er != _b.regs[i].er)
+				return false;
+		}
+		return true;
+	}
+}
+
+// Runs random programs with the block emulator and the interpreter and compares both at every block boundary
+void testBlockEmulator()
+{
+	std::cout << "Testing H8S block emulator against the interpreter..." << std::endl;
+
+	constexpr uint32_t seedCount = 200;
+	constexpr uint32_t blockCount = 5000;
+
+	uint64_t blocksExecuted = 0;
+	uint64_t interpreted = 0;
+
+	for (uint32_t seed = 0; seed < seedCount; ++seed)
+	{
+		auto blockEmu = std::make_unique<H8SBlockEmulator>();
+		auto refEmu = std::make_unique<H8SEmulator>();
+
+		TestDevice blockDevice, refDevice;
+
+		setup(*blockEmu, blockDevice, seed);
+		setup(*refEmu, refDevice, seed);
+
+		for (uint32_t i = 0; i < blockCount; ++i)
+		{
+			blockEmu->stepBlock([&] { blockDevice.tick(); });
+
+			while (refEmu->getCycles() < blockEmu->getCycles())
+			{
+				refEmu->step();
+				refDevice.tick();
+			}
+
+			if (!sameState(*blockEmu, *refEmu) || blockDevice.hash != refDevice.hash)
+			{
+				std::stringstream ss;
+				ss << "Mismatch for seed " << seed << " at block " << i << ", pc " << std::hex << blockEmu->getPC() << " vs " << refEmu->getPC();
+				throw std::runtime_error(ss.str());
+			}
+		}
+
+		uint8 blockRam[0x1000], refRam[0x1000];
+		blockEmu->readMemory(blockRam, 0x200000, sizeof(blockRam));
+		refEmu->readMemory(refRam, 0x200000, sizeof(refRam));
+		TEST_ASSERT(memcmp(blockRam, refRam, sizeof(blockRam)) == 0);
+
+		blocksExecuted += blockEmu->getStats().blocksExecuted;
+		interpreted += blockEmu->getStats().interpreted;
+	}
+
+	// make sure that the block path has been exercised at all
+	TEST_ASSERT(blocksExecuted > interpreted);
+
+	std::cout << "  " << blocksExecuted << " blocks, " << interpreted << " interpreted instructions" << std::endl;
+	std::cout << "H8S block emulator tests passed" << std::endl;
+}
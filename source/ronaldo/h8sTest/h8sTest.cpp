@@ -0,0 +1,6 @@
+#include "h8sTest.h"
+
+int main()
+{
+	return baseLib::runUnitTests("H8S", testBlockEmulator);
+}
@@ -40,8 +40,9 @@ namespace jeJucePlugin
 			m_selectedRom = 0;
 		}
 
+		beginDeviceBoot();
 		getController();
-		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(getPlugin().getLatencyBlocks()));
+		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(synthLib::Plugin::DefaultLatencyBlocks));
 		Processor::setLatencyBlocks(latencyBlocks);
 	}
 
@@ -55,11 +56,11 @@ namespace jeJucePlugin
 		return new PluginEditorState(*this);
 	}
 
-	synthLib::Device* AudioPluginAudioProcessor::createDevice()
+	pluginLib::Processor::DeviceFactory AudioPluginAudioProcessor::getDeviceFactory()
 	{
 		const auto& rom = getSelectedRom();
 
-		auto* errorMsg = "A firmware rom (a single 512k .bin file or multiple .mid files) is required, but was not found.";
+		static constexpr const char* errorMsg = "A firmware rom (a single 512k .bin file or multiple .mid files) is required, but was not found.";
 
 		if (!rom.isValid())
 			throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, errorMsg);
@@ -70,10 +71,13 @@ namespace jeJucePlugin
 		params.romName = rom.getName();
 		params.homePath = getDataFolder();
 
-		auto* d = new jeLib::Device(params);
-		if(!d->isValid())
-			throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, errorMsg);
-		return d;
+		return [params]() -> synthLib::Device*
+		{
+			auto* d = new jeLib::Device(params);
+			if(!d->isValid())
+				throw synthLib::DeviceException(synthLib::DeviceError::FirmwareMissing, errorMsg);
+			return d;
+		};
 	}
 
 	void AudioPluginAudioProcessor::getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const
@@ -84,8 +88,7 @@ namespace jeJucePlugin
 
 		if (rom.isValid())
 		{
-			auto data = rom.getData();
-			_params.romData.assign(data.begin(), data.end());
+			_params.romData = rom.getData();
 			_params.romName = rom.getName();
 		}
 	}
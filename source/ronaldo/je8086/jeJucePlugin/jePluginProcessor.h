@@ -13,7 +13,7 @@ namespace jeJucePlugin
 	    ~AudioPluginAudioProcessor() override;
 
 	    jucePluginEditorLib::PluginEditorState* createEditorState() override;
-	    synthLib::Device* createDevice() override;
+	    DeviceFactory getDeviceFactory() override;
 		void getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const override;
 
 	    pluginLib::Controller* createController() override;
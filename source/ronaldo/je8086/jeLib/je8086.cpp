@@ -6,7 +6,7 @@
 
 namespace jeLib
 {
-	Je8086::Je8086(const std::vector<uint8_t>& _romData, const std::string& _ramDataFilename)
+	Je8086::Je8086(const synthLib::RomImage& _romData, const std::string& _ramDataFilename)
 	: ports([this](devices::Port* _port) { onLedsChanged(_port); })
 	, midi(0, [this](uint8_t _byte) { onReceiveMidiByte(_byte); })
 	, m_midiOutParser(synthLib::MidiEventSource::Device)
@@ -78,6 +78,18 @@ namespace jeLib
 		}
 	}
 
+	Je8086::SampleFrame Je8086::popSample()
+	{
+		const auto s = m_sampleBuffer[m_sampleReadPos++];
+
+		if (m_sampleReadPos == m_sampleBuffer.size())
+		{
+			m_sampleBuffer.clear();
+			m_sampleReadPos = 0;
+		}
+		return s;
+	}
+
 	void Je8086::step()
 	{
 		uint64_t now = emu.getCycles();
@@ -89,11 +101,14 @@ namespace jeLib
 			m_midiInEvents.clear();
 		}
 
-		emu.step();
-		timers.tick();
-		midi.tick();
+		// devices are ticked after every instruction of a block, interrupts are raised at the same point as before
+		emu.stepBlock([this]
+		{
+			timers.tick();
+			midi.tick();
 
-		asics.runForCycles(emu.getCycles() * 1323 / 625); // Convert from uC cycles to DSP steps. (this is (clockrate / 2) / (uc clock = 16000000), simplified)
+			asics.runForCycles(emu.getCycles() * 1323 / 625); // Convert from uC cycles to DSP steps. (this is (clockrate / 2) / (uc clock = 16000000), simplified)
+		});
 	}
 
 	void Je8086::setButton(const devices::SwitchType _type, const bool _pressed)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <h8s/h8sblocks.hpp>
 #include <h8s/h8sdevices.hpp>
 
 #include "je8086devices.h"
@@ -7,6 +8,7 @@
 #include "sysexRemoteControl.h"
 #include "synthLib/midiBufferParser.h"
 #include "synthLib/midiRateLimiter.h"
+#include "synthLib/romCache.h"
 
 namespace jeLib
 {
@@ -16,14 +18,15 @@ namespace jeLib
 		using SampleFrame = std::pair<int32_t, int32_t>; // left, right
 		using SampleBuffer = std::vector<SampleFrame>;
 
-		Je8086(const std::vector<uint8_t>& _romData, const std::string& _ramDataFilename);
+		Je8086(const synthLib::RomImage& _romData, const std::string& _ramDataFilename);
 		~Je8086() = default;
 
 		void addMidiEvent(const synthLib::SMidiEvent& _event);
 		void readMidiOut(std::vector<synthLib::SMidiEvent>& _events);
 
-		const auto& getSampleBuffer() const { return m_sampleBuffer; }
-		void clearSampleBuffer() { m_sampleBuffer.clear(); }
+		// the ASICs compute samples in blocks, they are consumed one by one
+		bool hasSample() const { return m_sampleReadPos < m_sampleBuffer.size(); }
+		SampleFrame popSample();
 
 		void step();
 
@@ -31,6 +34,9 @@ namespace jeLib
 
 		void setButton(devices::SwitchType _type, bool _pressed);
 
+		// JIT statistics of all ASICs, i.e. how often programs have been regenerated
+		ESPOptimizerStats getJitStats() const { return asics.getJitStats(); }
+
 	private:
 		static void onLedsChanged(devices::Port* _port);
 		void onReceiveMidiByte(uint8_t _byte);
@@ -40,7 +46,7 @@ namespace jeLib
 
 		void runfactoryreset(const std::string& _ramDataFilename);
 
-		H8SEmulator emu;
+		H8SBlockEmulator emu;
 		devices::MultiAsic asics;
 		Lcd lcd;
 		devices::Port ports;
@@ -57,6 +63,7 @@ namespace jeLib
 		synthLib::MidiBufferParser m_midiOutParser;
 		std::vector<synthLib::SMidiEvent> m_midiInEvents;
 		SampleBuffer m_sampleBuffer;
+		size_t m_sampleReadPos = 0;
 		synthLib::MidiRateLimiter m_midiInRateLimiter;
 		std::vector<synthLib::SMidiEvent> m_midiOutEvents;
 	};
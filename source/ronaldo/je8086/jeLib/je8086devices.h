@@ -122,6 +122,7 @@ namespace jeLib
 
 			uint8_t read(uint32_t _address) override
 			{
+				flush();
 				const int asic = (_address >> 14) & 3; _address &= 0x3fff;
 				if (asic == 0) return asic0.readuC(_address);
 				if (asic == 1) return asic1.readuC(_address);
@@ -131,6 +132,7 @@ namespace jeLib
 
 			void write(uint32_t _address, uint8_t _value) override
 			{
+				flush();
 				const int asic = (_address >> 14) & 3; _address &= 0x3fff;
 				if (asic == 0) asic0.writeuC(_address, _value);
 				else if (asic == 1) asic1.writeuC(_address, _value);
@@ -145,41 +147,92 @@ namespace jeLib
 				uint64_t samples = diff / (768/2);
 				cyclesResidual = diff % (768/2);
 
-				for (int i = 0; i < samples; i++) {
-					// Intepreter version
-					// for (size_t j = 0; j < (768/2); j++) asic0.step_cores();
-					// for (size_t j = 0; j < (768/2); j++) asic1.step_cores();
-					// for (size_t j = 0; j < (768/2); j++) asic2.step_cores();
-					// for (size_t j = 0; j < (768/2); j++) asic3.step_cores();
+				// Samples are not computed immediately but in blocks, the uC accessing an ASIC flushes them first
+				pendingSamples += static_cast<uint32_t>(samples);
+				if (pendingSamples >= blockSize)
+					flush();
+			}
 
-					// JIT version
-					asic0.opt.genProgramIfDirty();
-					asic1.opt.genProgramIfDirty();
-					asic2.opt.genProgramIfDirty();
-					asic3.opt.genProgramIfDirty();
+			// Computes all pending samples. Each ASIC only consumes the output of its predecessor from the same sample, so
+			// the chain is processed ASIC by ASIC for a block of samples, with the values passed between the ASICs buffered.
+			// The result is identical to computing all four ASICs sample by sample
+			void flush()
+			{
+				while (pendingSamples)
+				{
+					const uint32_t count = pendingSamples < MaxBlockSize ? pendingSamples : MaxBlockSize;
+					processBlock(count);
+					pendingSamples -= count;
+				}
+			}
 
+			// number of samples that are computed by one ASIC before switching to the next one. Defaults to 1, which
+			// computes the chain sample by sample. Larger blocks are opt-in until they have been verified against the JIT
+			void setBlockSize(const uint32_t _samples) { flush(); blockSize = _samples < 1 ? 1 : (_samples > MaxBlockSize ? MaxBlockSize : _samples); }
+			uint32_t getBlockSize() const { return blockSize; }
+
+			// JIT statistics of all four ASICs
+			ESPOptimizerStats getJitStats() const
+			{
+				ESPOptimizerStats stats = asic0.opt.getStats();
+				stats += asic1.opt.getStats();
+				stats += asic2.opt.getStats();
+				stats += asic3.opt.getStats();
+				return stats;
+			}
+
+			static constexpr uint32_t MaxBlockSize = 64;
+
+		private:
+			void processBlock(const uint32_t count)
+			{
+				// Intepreter version, per sample
+				// for (size_t j = 0; j < (768/2); j++) asic0.step_cores();
+				// for (size_t j = 0; j < (768/2); j++) asic1.step_cores();
+				// for (size_t j = 0; j < (768/2); j++) asic2.step_cores();
+				// for (size_t j = 0; j < (768/2); j++) asic3.step_cores();
+
+				// JIT version. A modified program is regenerated a number of samples after the modification, the countdown
+				// needs to advance per sample, not per block
+				for (uint32_t i = 0; i < count; i++) {
+					asic0.opt.genProgramIfDirty();
 					asic0.opt.callOptimized(&asic0);
+					for (int k = 0; k <= 0x4; k += 2) link01[i][k>>1] = asic0.readGRAM(0x80 + k);
+					asic0.sync_cores();
+				}
+
+				for (uint32_t i = 0; i < count; i++) {
+					asic1.opt.genProgramIfDirty();
 					asic1.opt.callOptimized(&asic1);
+					for (int k = 0; k <= 0x4; k += 2) asic1.writeGRAM(link01[i][k>>1], k);
+					for (int k = 0; k <= 0xa; k += 2) link12[i][k>>1] = asic1.readGRAM(0x80 + k);
+					asic1.sync_cores();
+				}
+
+				for (uint32_t i = 0; i < count; i++) {
+					asic2.opt.genProgramIfDirty();
 					asic2.opt.callOptimized(&asic2);
+					for (int k = 0; k <= 0xa; k += 2) asic2.writeGRAM(link12[i][k>>1], k);
+					for (int k = 0; k <= 0xe; k += 2) link23[i][k>>1] = asic2.readGRAM(0x80 + k);
+					link23[i][8] = asic2.readGRAM(0xa0);
+					link23[i][9] = asic2.readGRAM(0xa2);
+					asic2.sync_cores();
+				}
+
+				for (uint32_t i = 0; i < count; i++) {
+					asic3.opt.genProgramIfDirty();
 					asic3.opt.callOptimized(&asic3);
 
 					// Last DSP audio output
 					postSample(asic3.readGRAM(0xe8), asic3.readGRAM(0xec));
-					
-					// DSP->DSP communication
-					for (int k = 0; k <= 0x4; k += 2) asic1.writeGRAM(asic0.readGRAM(0x80 + k), k);
-					for (int k = 0; k <= 0xa; k += 2) asic2.writeGRAM(asic1.readGRAM(0x80 + k), k);
-					for (int k = 0; k <= 0xe; k += 2) asic3.writeGRAM(asic2.readGRAM(0x80 + k), k);
-					asic3.writeGRAM(asic2.readGRAM(0xa0), 0x20);
-					asic3.writeGRAM(asic2.readGRAM(0xa2), 0x22);
 
-					// Advance PCs
-					asic0.sync_cores();
-					asic1.sync_cores();
-					asic2.sync_cores();
+					for (int k = 0; k <= 0xe; k += 2) asic3.writeGRAM(link23[i][k>>1], k);
+					asic3.writeGRAM(link23[i][8], 0x20);
+					asic3.writeGRAM(link23[i][9], 0x22);
 					asic3.sync_cores();
 				}
 			}
+
 		protected:
 			ESP<17> asic0;
 			ESP<0> asic1, asic2;
@@ -188,6 +241,13 @@ namespace jeLib
 			std::function<void(int32_t, int32_t)> postSample;
 			uint64_t lastCycles = 0, cyclesResidual = 0;
 			uint32_t cycles_this_sample {0};
+			uint32_t pendingSamples = 0;
+			uint32_t blockSize = 1;
+
+			// DSP->DSP communication, values written by an ASIC per sample of a block
+			int32_t link01[MaxBlockSize][3] {};
+			int32_t link12[MaxBlockSize][6] {};
+			int32_t link23[MaxBlockSize][10] {};
 		};
 
 		class Port : public H8SDevice
@@ -132,11 +132,10 @@ namespace jeLib
 				}
 			}
 
-			while (m_je8086.getSampleBuffer().empty())
+			while (!m_je8086.hasSample())
 				m_je8086.step();
 
-			m_audioOut.push_back(m_je8086.getSampleBuffer().front());
-			m_je8086.clearSampleBuffer();
+			m_audioOut.push_back(m_je8086.popSample());
 
 			++m_processedSampleOffset;
 
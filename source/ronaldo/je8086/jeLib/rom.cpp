@@ -21,13 +21,13 @@ namespace jeLib
 
 	Rom::Rom(const std::string& _filename)
 	{
-		baseLib::filesystem::readFile(m_data, _filename);
+		m_data = synthLib::RomCache::loadFile(_filename);
 		m_name = baseLib::filesystem::getFilenameWithoutPath(_filename);
 
 		validate();
 	}
 
-	Rom::Rom(const std::vector<uint8_t>& _data, const std::string& _name)
+	Rom::Rom(const synthLib::RomImage& _data, const std::string& _name)
 	{
 		m_data = _data;
 		m_name = _name;
@@ -7,6 +7,7 @@
 #include "jetypes.h"
 
 #include "synthLib/midiTypes.h"
+#include "synthLib/romCache.h"
 
 namespace jeLib
 {
@@ -21,9 +22,9 @@ namespace jeLib
 
 		Rom() = default;
 		explicit Rom(const std::string& _filename);
-		explicit Rom(const std::vector<uint8_t>& _data, const std::string& _name);
+		explicit Rom(const synthLib::RomImage& _data, const std::string& _name);
 
-		const std::vector<uint8_t>& getData() const { return m_data; }
+		const synthLib::RomImage& getData() const { return m_data; }
 		const std::string& getName() const { return m_name; }
 
 		bool isValid() const;
@@ -44,6 +45,6 @@ namespace jeLib
 		uint32_t getPerformanceSize() const;
 
 		std::string m_name;
-		std::vector<uint8_t> m_data;
+		synthLib::RomImage m_data;
 	};
 }
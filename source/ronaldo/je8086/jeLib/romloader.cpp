@@ -121,7 +121,7 @@ namespace jeLib
 
 		const auto name = firstName + "..." + lastName + ext;
 
-		return Rom(fullRom, name);
+		return Rom(synthLib::RomCache::get(std::move(fullRom)), name);
 	}
 
 	void RomLoader::loadFromMidiFiles(std::vector<MidiData>& _filesKeyboard, std::vector<MidiData>& _filesRack, const std::vector<std::string>& _files)
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "jeLibTest.h"
+
+#include "jeLib/je8086devices.h"
+
+namespace
+{
+	constexpr uint32_t StepsPerSample = 384;
+	constexpr uint32_t SampleCount = 512;
+	constexpr uint32_t PatchChangeSample = 200;
+	constexpr uint32_t OutputAsic = 3;
+
+	void writeProgramWord(jeLib::devices::MultiAsic& _asics, const uint32_t _asic, const uint32_t _index, const uint32_t _word)
+	{
+		const uint32_t base = (_asic << 14) + (_index << 2);
+
+		for (uint32_t i=0; i<4; ++i)
+			_asics.write(base + i, static_cast<uint8_t>(_word >> (i << 3)));
+	}
+
+	// Writes a program to the last ASIC that outputs a constant that depends on _coef, as the uC does it
+	void writeProgram(jeLib::devices::MultiAsic& _asics, const uint8_t _coef)
+	{
+		_asics.write((OutputAsic << 14) + 0x2003, 0x54);	// program write mode
+
+		// A = 0x400000 * coef
+		writeProgramWord(_asics, OutputAsic, 0, (0x04 << 16) | (0x04 << 10) | _coef);
+		// two nops for the accumulator pipeline, then store A to GRAM 0xe8, the left output
+		writeProgramWord(_asics, OutputAsic, 3, (0x38 << 16) | (0xe8 << 10));
+	}
+
+	std::vector<int32_t> run(const uint32_t _blockSize)
+	{
+		auto asics = std::make_unique<jeLib::devices::MultiAsic>();
+
+		std::vector<int32_t> output;
+		output.reserve(SampleCount);
+
+		asics->setPostSample([&](const int32_t _left, int32_t)
+		{
+			output.push_back(_left);
+		});
+
+		asics->setBlockSize(_blockSize);
+
+		writeProgram(*asics, 0x10);
+
+		uint64_t steps = 0;
+
+		for (uint32_t i=0; i<SampleCount; ++i)
+		{
+			// patch change, the uC access flushes all samples that are pending so far
+			if (i == PatchChangeSample)
+				writeProgram(*asics, 0x20);
+
+			steps += StepsPerSample;
+			asics->runForCycles(steps);
+		}
+
+		asics->flush();
+
+		return output;
+	}
+}
+
+// A program change has to take effect at the same sample, independent of the number of samples that are processed
+// at once
+void testAsicBlockSize()
+{
+	std::cout << "Testing ASIC block processing across a program change..." << std::endl;
+
+	const auto reference = run(1);
+
+	TEST_ASSERT(reference.size() == SampleCount);
+
+	// make sure that both programs have been running, otherwise there is nothing to compare
+	const auto before = reference[PatchChangeSample - 1];
+	const auto after = reference.back();
+	TEST_ASSERT(before != 0);
+	TEST_ASSERT(after != 0);
+	TEST_ASSERT(before != after);
+
+	for (const uint32_t blockSize : {2u, 16u, jeLib::devices::MultiAsic::MaxBlockSize})
+	{
+		const auto output = run(blockSize);
+
+		TEST_ASSERT(output.size() == reference.size());
+
+		for (size_t i=0; i<output.size(); ++i)
+		{
+			if (output[i] != reference[i])
+			{
+				std::stringstream ss;
+				ss << "Block size " << blockSize << " differs from block size 1 at sample " << i << ", " << output[i] << " vs " << reference[i];
+				throw std::runtime_error(ss.str());
+			}
+		}
+	}
+
+	std::cout << "ASIC block processing tests passed" << std::endl;
+}
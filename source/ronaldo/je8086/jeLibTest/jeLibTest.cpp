@@ -0,0 +1,6 @@
+#include "jeLibTest.h"
+
+int main()
+{
+	return baseLib::runUnitTests("jeLib", testAsicBlockSize);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "baseLib/unitTest.h"
+
+void testAsicBlockSize();
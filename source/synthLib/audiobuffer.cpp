@@ -1,107 +1,179 @@
 #include "audiobuffer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>	// memcpy
 
 namespace synthLib
 {
-	void AudioBuffer::insertZeroes(size_t _size)
+	AudioBuffer::AudioBuffer(const size_t _channelCount, const size_t _capacity) : m_channelCount(_channelCount)
 	{
-		TChannel zeroes;
-		zeroes.resize(_size, 0.0f);
+		reserve(_capacity);
+	}
 
-		for(size_t c=0; c<m_data.size(); ++c)
-		{
-			m_data[c].insert(m_data[c].begin(), zeroes.begin(), zeroes.end());
-		}
+	void AudioBuffer::reserve(const size_t _capacity)
+	{
+		if(_capacity > m_capacity)
+			grow(_capacity);
 	}
 
-	AudioBuffer::AudioBuffer(size_t _channelCount, const size_t _capacity)
+	void AudioBuffer::clear()
 	{
-		m_data.resize(_channelCount);
-		reserve(_capacity);
+		m_readPos = 0;
+		m_size = 0;
 	}
 
-	void AudioBuffer::reserve(size_t _capacity)
+	void AudioBuffer::append(const TBuffer& _data)
 	{
-		for(auto i=0; i<m_data.size(); ++i)
-		{
-			if(m_data[i].capacity() < _capacity)
-				m_data[i].reserve(_capacity);
-		}
+		assert(_data.size() == m_channelCount);
+
+		const auto size = _data.empty() ? 0 : _data.front().size();
+
+		TAudioOutputs dst;
+		beginWrite(dst, size);
+
+		for(size_t c=0; c<m_channelCount; ++c)
+			memcpy(dst[c], _data[c].data(), size * sizeof(float));
+
+		endWrite(size);
 	}
 
-	void AudioBuffer::resize(size_t _capacity)
+	void AudioBuffer::append(const float** _data, const size_t _size)
 	{
-		for(auto i=0; i<m_data.size(); ++i)
-		{
-			m_data[i].resize(_capacity);
-		}
+		TAudioOutputs dst;
+		beginWrite(dst, _size);
+
+		for(size_t c=0; c<m_channelCount; ++c)
+			memcpy(dst[c], _data[c], _size * sizeof(float));
+
+		endWrite(_size);
 	}
 
-	void AudioBuffer::append(const TBuffer& _data)
+	void AudioBuffer::append(const TAudioInputs& _data, const size_t _size)
 	{
-		assert(_data.size() == m_data.size());
+		TAudioOutputs dst;
+		beginWrite(dst, _size);
 
-		for(size_t c=0; c<_data.size(); ++c)
+		for(size_t c=0; c<m_channelCount; ++c)
 		{
-			append(m_data[c], &_data[c].front(), _data[c].size());
+			if(c < _data.size() && _data[c])
+				memcpy(dst[c], _data[c], _size * sizeof(float));
+			else
+				std::fill_n(dst[c], _size, 0.0f);
 		}
+
+		endWrite(_size);
 	}
 
-	void AudioBuffer::append(const float** _data, size_t _size)
+	void AudioBuffer::remove(const size_t _count)
 	{
-		for(size_t c=0; c<m_data.size(); ++c)
+		if(_count >= m_size)
 		{
-			append(m_data[c], _data[c], _size);
+			clear();
+			return;
 		}
+
+		m_readPos = (m_readPos + _count) & (m_capacity - 1);
+		m_size -= _count;
 	}
 
-	void AudioBuffer::append(const TAudioInputs& _data, size_t _size)
+	void AudioBuffer::insertZeroes(const size_t _size)
 	{
-		const auto c = std::min(m_data.size(), _data.size());
+		if(!_size)
+			return;
 
-		for(size_t i=0; i<c; ++i)
-			append(m_data[i], _data[i], _size);
-	}
+		if(m_size + _size > m_capacity)
+			grow(m_size + _size);
 
-	void AudioBuffer::remove(const size_t _count)
-	{
-		for(size_t c=0; c<m_data.size(); ++c)
-		{
-			if(_count >= m_data[c].size())
-				m_data[c].clear();
-			else
-				m_data[c].erase(m_data[c].begin(), m_data[c].begin() + _count);
-		}
+		m_readPos = (m_readPos + m_capacity - _size) & (m_capacity - 1);
+
+		for(size_t c=0; c<m_channelCount; ++c)
+			std::fill_n(channelData(c) + m_readPos, _size, 0.0f);
+
+		mirror(m_readPos, _size);
+
+		m_size += _size;
 	}
 
-	void AudioBuffer::fillPointers(TAudioOutputs& _pointers, size_t _offset)
+	void AudioBuffer::fillPointers(TAudioInputs& _pointers, const size_t _offset) const
 	{
-		for(size_t c=0; c<m_data.size(); ++c)
-			_pointers[c] = &m_data[c][_offset];
+		assert(m_channelCount <= _pointers.size());
+
+		for(size_t c=0; c<m_channelCount; ++c)
+			_pointers[c] = getChannel(c) + _offset;
+		for(size_t c=m_channelCount; c<_pointers.size(); ++c)
+			_pointers[c] = nullptr;
 	}
 
-	void AudioBuffer::fillPointers(TAudioInputs& _pointers, size_t _offset) const
+	void AudioBuffer::beginWrite(TAudioOutputs& _pointers, const size_t _count)
 	{
-		for(size_t c=0; c<m_data.size(); ++c)
-			_pointers[c] = &m_data[c][_offset];
-		for(size_t c=m_data.size(); c<_pointers.size(); ++c)
+		assert(m_channelCount <= _pointers.size());
+
+		if(m_size + _count > m_capacity)
+			grow(m_size + _count);
+
+		// the write position is in the first half and _count <= capacity, the region never exceeds the second half
+		const auto pos = writePos();
+
+		for(size_t c=0; c<m_channelCount; ++c)
+			_pointers[c] = channelData(c) + pos;
+		for(size_t c=m_channelCount; c<_pointers.size(); ++c)
 			_pointers[c] = nullptr;
 	}
 
-	size_t AudioBuffer::size() const
+	void AudioBuffer::endWrite(const size_t _count)
 	{
-		if(m_data.empty())
-			return 0;
-		return m_data[0].size();
+		assert(m_size + _count <= m_capacity);
+
+		mirror(writePos(), _count);
+
+		m_size += _count;
 	}
 
-	void AudioBuffer::append(TChannel& _dst, const float* _data, size_t _size)
+	void AudioBuffer::mirror(const size_t _pos, const size_t _count)
 	{
-		const auto oldSize = _dst.size();
-		_dst.resize(oldSize + _size);
-		memcpy(&_dst[oldSize], _data, _size * sizeof(float));
+		// copy the part that is in the first half to the second half and vice versa
+		const auto end = _pos + _count;
+		const auto lowEnd = std::min(end, m_capacity);
+
+		for(size_t c=0; c<m_channelCount; ++c)
+		{
+			auto* buf = channelData(c);
+
+			if(lowEnd > _pos)
+				memcpy(buf + _pos + m_capacity, buf + _pos, (lowEnd - _pos) * sizeof(float));
+			if(end > m_capacity)
+				memcpy(buf, buf + m_capacity, (end - m_capacity) * sizeof(float));
+		}
 	}
 
+	void AudioBuffer::grow(const size_t _minCapacity)
+	{
+		size_t capacity = m_capacity ? m_capacity : 256;
+		while(capacity < _minCapacity)
+			capacity <<= 1;
+
+		const auto stride = capacity * 2;
+
+		std::vector<float> storage(m_channelCount * stride + Alignment / sizeof(float), 0.0f);
+
+		auto* data = storage.data();
+		const auto misalignment = reinterpret_cast<uintptr_t>(data) & (Alignment - 1);
+		if(misalignment)
+			data += (Alignment - misalignment) / sizeof(float);
+
+		for(size_t c=0; c<m_channelCount && m_size; ++c)
+		{
+			auto* dst = data + c * stride;
+			memcpy(dst, getChannel(c), m_size * sizeof(float));
+			memcpy(dst + capacity, getChannel(c), m_size * sizeof(float));
+		}
+
+		m_storage.swap(storage);
+		m_data = data;
+		m_channelStride = stride;
+		m_capacity = capacity;
+		m_readPos = 0;
+	}
 }
@@ -6,40 +6,66 @@
 
 namespace synthLib
 {
+	// Multi-channel FIFO for audio data
+	//
+	// Each channel is a ring buffer whose storage is mirrored, i.e. the second half of a channel contains a copy of
+	// the first half. This way, both the readable and the writable region of a channel are always contiguous and
+	// can be accessed directly without copying, and removing samples from the front only moves the read position.
+	// All channels live in a single allocation, each channel starts at a cache line boundary
 	class AudioBuffer
 	{
 	public:
 		using TChannel = std::vector<float>;
 		using TBuffer = std::vector< TChannel >;
 
+		AudioBuffer(size_t _channelCount = 2, size_t _capacity = 1024);
+
+		// only allocates if the capacity is not sufficient, call this outside of the audio thread if possible
 		void reserve(size_t _capacity);
-		void resize(size_t _capacity);
+		void clear();
+
 		void append(const TBuffer& _data);
 		void append(const float** _data, size_t _size);
 		void append(const TAudioInputs& _data, size_t _size);
 
+		// removes samples from the front
 		void remove(size_t _count);
-		
-		void fillPointers(TAudioOutputs& _pointers, size_t _offset = 0);
-		void fillPointers(TAudioInputs& _pointers, size_t _offset = 0) const;
-		size_t size() const;
-
-		void ensureSize(size_t _size)
-		{
-			if(size() < _size)
-				resize(_size);
-		}
 
+		// adds silence in front of the existing data
 		void insertZeroes(size_t _size);
 
-		const std::vector<float>& getChannel(const size_t _channel) const { return m_data[_channel]; }
-		float* getChannel(const size_t _channel) { return &m_data[_channel].front(); }
+		// pointers to the oldest sample, plus _offset, of each channel. Data is contiguous up to the end of the buffer
+		void fillPointers(TAudioInputs& _pointers, size_t _offset = 0) const;
+		const float* getChannel(const size_t _channel) const { return channelData(_channel) + m_readPos; }
+
+		// zero-copy write. beginWrite returns pointers to contiguous regions of _count samples behind the existing
+		// data that the caller fills. endWrite appends the first _count samples of these regions
+		void beginWrite(TAudioOutputs& _pointers, size_t _count);
+		void endWrite(size_t _count);
 
+		size_t size() const { return m_size; }
 		bool empty() const { return size() == 0; }
 
-		AudioBuffer(size_t _channelCount = 2, size_t _capacity = 1024);
+		size_t getCapacity() const { return m_capacity; }
+		size_t getChannelCount() const { return m_channelCount; }
+
 	private:
-		static void append(TChannel& _dst, const float* _data, size_t _size);
-		TBuffer m_data;
+		static constexpr size_t Alignment = 64;	// bytes
+
+		float* channelData(const size_t _channel) { return m_data + _channel * m_channelStride; }
+		const float* channelData(const size_t _channel) const { return m_data + _channel * m_channelStride; }
+
+		size_t writePos() const { return (m_readPos + m_size) & (m_capacity - 1); }
+		void mirror(size_t _pos, size_t _count);
+		void grow(size_t _minCapacity);
+
+		std::vector<float> m_storage;
+		float* m_data = nullptr;		// m_storage, aligned
+
+		size_t m_channelCount = 0;
+		size_t m_channelStride = 0;		// two times the capacity
+		size_t m_capacity = 0;			// power of two
+		size_t m_readPos = 0;
+		size_t m_size = 0;
 	};
 }
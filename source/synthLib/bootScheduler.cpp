@@ -0,0 +1,197 @@
+#include "bootScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "device.h"
+
+#include "dsp56kBase/logging.h"
+
+namespace synthLib
+{
+	namespace
+	{
+		using Task = std::packaged_task<std::unique_ptr<Device>()>;
+
+		class BootPool
+		{
+		public:
+			BootPool() : m_maxActive(std::max(1u, std::thread::hardware_concurrency()))
+			{
+			}
+
+			BootPool(const BootPool&) = delete;
+			BootPool(BootPool&&) = delete;
+			BootPool& operator = (const BootPool&) = delete;
+			BootPool& operator = (BootPool&&) = delete;
+
+			~BootPool()
+			{
+				{
+					std::lock_guard lock(m_mutex);
+					m_destroy = true;
+				}
+				m_cv.notify_all();
+
+				for (auto& t : m_threads)
+					t.join();
+			}
+
+			BootScheduler::DeviceFuture push(Task&& _task, const BootScheduler::Priority _priority)
+			{
+				auto future = _task.get_future();
+				{
+					std::lock_guard lock(m_mutex);
+					if(_priority == BootScheduler::Priority::Background)
+						m_backgroundTasks.push_back(std::move(_task));
+					else
+						m_tasks.push_back(std::move(_task));
+
+					// boot threads are only started on demand and then kept alive for subsequent boots
+					if(m_idle == 0 && m_threads.size() < m_maxActive)
+						m_threads.emplace_back([this] { threadFunc(); });
+				}
+				m_cv.notify_one();
+				return future;
+			}
+
+			void setMaxActive(const uint32_t _count)
+			{
+				{
+					std::lock_guard lock(m_mutex);
+					m_maxActive = std::max(1u, _count);
+
+					while(m_threads.size() < std::min<size_t>(m_maxActive, m_tasks.size() + m_backgroundTasks.size() + m_active))
+						m_threads.emplace_back([this] { threadFunc(); });
+				}
+				m_cv.notify_all();
+			}
+
+			uint32_t getMaxActive()
+			{
+				std::lock_guard lock(m_mutex);
+				return m_maxActive;
+			}
+
+			uint32_t getPendingCount()
+			{
+				std::lock_guard lock(m_mutex);
+				return m_active + static_cast<uint32_t>(m_tasks.size() + m_backgroundTasks.size());
+			}
+
+		private:
+			void threadFunc()
+			{
+				std::unique_lock lock(m_mutex);
+
+				while(true)
+				{
+					++m_idle;
+					m_cv.wait(lock, [this]
+					{
+						return m_destroy || (hasTasks() && m_active < m_maxActive);
+					});
+					--m_idle;
+
+					// pending boots are still executed when the process shuts down, otherwise their futures would never be satisfied
+					if(!hasTasks())
+						return;
+
+					// background boots only run if no foreground boot is waiting
+					auto& tasks = m_tasks.empty() ? m_backgroundTasks : m_tasks;
+					auto task = std::move(tasks.front());
+					tasks.pop_front();
+
+					++m_active;
+					lock.unlock();
+
+					task();
+
+					lock.lock();
+					--m_active;
+
+					// a slot became free
+					m_cv.notify_one();
+				}
+			}
+
+			bool hasTasks() const
+			{
+				return !m_tasks.empty() || !m_backgroundTasks.empty();
+			}
+
+			std::mutex m_mutex;
+			std::condition_variable m_cv;
+			std::deque<Task> m_tasks;
+			std::deque<Task> m_backgroundTasks;
+			std::vector<std::thread> m_threads;
+			uint32_t m_maxActive;
+			uint32_t m_active = 0;
+			uint32_t m_idle = 0;
+			bool m_destroy = false;
+		};
+
+		std::mutex g_poolMutex;
+
+		// intentionally not destroyed on static destruction, joining threads while the library is unloaded can dead lock
+		BootPool* g_pool = nullptr;
+
+		BootPool& getPool()
+		{
+			std::lock_guard lock(g_poolMutex);
+			if(!g_pool)
+				g_pool = new BootPool();
+			return *g_pool;
+		}
+	}
+
+	BootScheduler::DeviceFuture BootScheduler::boot(CreateFunc _create, const Priority _priority)
+	{
+		return getPool().push(Task([create = std::move(_create)]
+		{
+			const auto t = std::chrono::steady_clock::now();
+
+			std::unique_ptr<Device> device(create());
+
+			LOG("Device boot finished after " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t).count() << "ms");
+
+			return device;
+		}), _priority);
+	}
+
+	bool BootScheduler::isReady(const DeviceFuture& _future)
+	{
+		return _future.valid() && _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	void BootScheduler::setMaxConcurrentBoots(const uint32_t _count)
+	{
+		getPool().setMaxActive(_count);
+	}
+
+	uint32_t BootScheduler::getMaxConcurrentBoots()
+	{
+		return getPool().getMaxActive();
+	}
+
+	uint32_t BootScheduler::getPendingCount()
+	{
+		return getPool().getPendingCount();
+	}
+
+	void BootScheduler::shutdown()
+	{
+		BootPool* pool;
+		{
+			std::lock_guard lock(g_poolMutex);
+			pool = g_pool;
+			g_pool = nullptr;
+		}
+		delete pool;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace synthLib
+{
+	class Device;
+
+	// Process-wide scheduler that boots devices in the background
+	//
+	// Device construction includes the complete boot of the emulated hardware and takes seconds. If a host creates
+	// multiple plugin instances, booting them one after the other multiplies the load time. The scheduler constructs
+	// devices on boot threads instead, concurrently up to the number of CPU cores so that a large session does not
+	// oversubscribe the machine. All functions are thread-safe
+	class BootScheduler
+	{
+	public:
+		using CreateFunc = std::function<Device*()>;
+		using DeviceFuture = std::future<std::unique_ptr<Device>>;
+
+		enum class Priority
+		{
+			Foreground,	// a device that is needed by a plugin instance
+			Background	// a device that might be needed later, only booted if no foreground boot is waiting
+		};
+
+		// queues the creation of a device and returns immediately. Exceptions thrown by the create function, i.e. a
+		// DeviceException, are rethrown by DeviceFuture::get(). If the future is discarded, the device is destroyed
+		static DeviceFuture boot(CreateFunc _create, Priority _priority = Priority::Foreground);
+
+		// returns true if the device has been created, get() does not block in this case
+		static bool isReady(const DeviceFuture& _future);
+
+		// maximum number of devices that boot at the same time, defaults to the number of CPU cores
+		static void setMaxConcurrentBoots(uint32_t _count);
+		static uint32_t getMaxConcurrentBoots();
+
+		// number of devices that are currently booting or waiting for a free slot
+		static uint32_t getPendingCount();
+
+		// finishes all pending boots and joins the boot threads. Needs to be called before the library is unloaded,
+		// the threads are not joined during static destruction. A subsequent boot starts new threads
+		static void shutdown();
+	};
+}
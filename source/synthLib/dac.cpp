@@ -2,55 +2,154 @@
 
 #include "dsp56kBase/logging.h"
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#   define HAVE_SSE 1
+#   include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_ARCH_8) || defined(_M_ARM64)
+#   define HAVE_SSE 1
+#   include "baseLib/sse2neon.h"
+#else
+#   define HAVE_SSE 0
+#endif
+
 namespace synthLib
 {
 	namespace
 	{
-		template<uint32_t OutputBits> Dac::ProcessFunc findProcessFunc(const uint32_t _noiseBits)
+#if HAVE_SSE
+		// SSE2 has no 32 bit multiply that keeps the low half, emulate it with two 32x32->64 multiplies
+		__m128i mullo32(const __m128i _a, const __m128i _b)
+		{
+			const __m128i even = _mm_mul_epu32(_a, _b);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(_a, 32), _mm_srli_epi64(_b, 32));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+		}
+#endif
+
+		template<uint32_t OutputBits, uint32_t NoiseBits> constexpr Dac::ProcessFuncs processFuncs()
+		{
+			return {&DacProcessor<OutputBits, NoiseBits>::processSample, &DacProcessor<OutputBits, NoiseBits>::processBlock};
+		}
+
+		template<uint32_t OutputBits> Dac::ProcessFuncs findProcessFuncs(const uint32_t _noiseBits)
 		{
 			switch (_noiseBits)
 			{
-			case 0: return &DacProcessor<OutputBits, 0>::processSample;
-			case 1: return &DacProcessor<OutputBits, 1>::processSample;
-			case 2: return &DacProcessor<OutputBits, 2>::processSample;
-			case 3: return &DacProcessor<OutputBits, 3>::processSample;
-			case 4: return &DacProcessor<OutputBits, 4>::processSample;
-			case 5: return &DacProcessor<OutputBits, 5>::processSample;
-			case 6: return &DacProcessor<OutputBits, 6>::processSample;
-			case 7: return &DacProcessor<OutputBits, 7>::processSample;
-			default: return nullptr;
+			case 0: return processFuncs<OutputBits, 0>();
+			case 1: return processFuncs<OutputBits, 1>();
+			case 2: return processFuncs<OutputBits, 2>();
+			case 3: return processFuncs<OutputBits, 3>();
+			case 4: return processFuncs<OutputBits, 4>();
+			case 5: return processFuncs<OutputBits, 5>();
+			case 6: return processFuncs<OutputBits, 6>();
+			case 7: return processFuncs<OutputBits, 7>();
+			default: return {};
 			}
 		}
 
-		Dac::ProcessFunc findProcessFunc(const uint32_t _outputBits, const uint32_t _noiseBits)
+		Dac::ProcessFuncs findProcessFuncs(const uint32_t _outputBits, const uint32_t _noiseBits)
 		{
 			switch (_outputBits)
 			{
-			case 8:  return findProcessFunc<8>(_noiseBits);
-			case 12: return findProcessFunc<12>(_noiseBits);
-			case 16: return findProcessFunc<16>(_noiseBits);
-			case 18: return findProcessFunc<18>(_noiseBits);
-			case 24: return findProcessFunc<24>(_noiseBits);
-			default: return nullptr;
+			case 8:  return findProcessFuncs<8>(_noiseBits);
+			case 12: return findProcessFuncs<12>(_noiseBits);
+			case 16: return findProcessFuncs<16>(_noiseBits);
+			case 18: return findProcessFuncs<18>(_noiseBits);
+			case 24: return findProcessFuncs<24>(_noiseBits);
+			default: return {};
+			}
+		}
+	}
+
+	template<uint32_t OutputBits, uint32_t NoiseBits>
+	void DacProcessor<OutputBits, NoiseBits>::processBlock(DacState& _dacState, float* _out, const uint32_t* _in, const size_t _count)
+	{
+		size_t i = 0;
+
+#if HAVE_SSE
+		if(_count >= 4)
+		{
+			const __m128 scale = _mm_set1_ps(IntToFloatScale);
+
+			// four interleaved generator lanes, lane n produces the values for samples n, n+4, n+8, ...
+			__m128i random = _mm_setzero_si128();
+			__m128i randomPrev = _mm_setzero_si128();
+			__m128i randomMul = _mm_setzero_si128();
+			__m128i randomAdd = _mm_setzero_si128();
+
+			if constexpr (NoiseBits > 0)
+			{
+				constexpr auto jump = dacHelper::lcgJump(4);
+
+				uint32_t state = _dacState.randomValue;
+				const auto r0 = dacHelper::lcg(state);
+				const auto r1 = dacHelper::lcg(state);
+				const auto r2 = dacHelper::lcg(state);
+				const auto r3 = dacHelper::lcg(state);
+
+				random = _mm_set_epi32(static_cast<int32_t>(r3), static_cast<int32_t>(r2), static_cast<int32_t>(r1), static_cast<int32_t>(r0));
+				randomMul = _mm_set1_epi32(static_cast<int32_t>(jump.mul));
+				randomAdd = _mm_set1_epi32(static_cast<int32_t>(jump.add));
 			}
+
+			for(; i + 4 <= _count; i += 4)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_in + i));
+
+				// sign extend 24 to 32 bits
+				v = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+
+				if constexpr (OutBits > InBits)
+				{
+					v = _mm_slli_epi32(v, OutBits - InBits);
+				}
+				else if constexpr (OutBits < InBits)
+				{
+					constexpr int32_t rounder = (1<<(InBits - OutBits-1)) - 1;
+					v = _mm_add_epi32(v, _mm_set1_epi32(rounder));
+					v = _mm_srai_epi32(v, InBits - OutBits);
+				}
+
+				if constexpr (NoiseBits > 0)
+				{
+					constexpr int32_t rounder = (1<<(NoiseBits-1)) - 1;
+
+					const __m128i noise = _mm_srli_epi32(random, 32 - NoiseBits);
+					v = _mm_add_epi32(v, _mm_sub_epi32(noise, _mm_set1_epi32(rounder)));
+					v = _mm_srai_epi32(v, 1);
+
+					randomPrev = random;
+					random = _mm_add_epi32(mullo32(random, randomMul), randomAdd);
+				}
+
+				_mm_storeu_ps(_out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+			}
+
+			// the generator state is the value that has been used for the last sample
+			if constexpr (NoiseBits > 0)
+				_dacState.randomValue = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi32(randomPrev, _MM_SHUFFLE(3,3,3,3))));
 		}
+#endif
+
+		for(; i<_count; ++i)
+			_out[i] = processSample(_dacState, _in[i]);
 	}
 
-	Dac::Dac() : m_processFunc(&DacProcessor<24, 0>::processSample)
+	Dac::Dac() : m_funcs(processFuncs<24, 0>())
 	{
 	}
 
 	bool Dac::configure(const uint32_t _outputBits, const uint32_t _noiseBits)
 	{
-		const auto processFunc = findProcessFunc(_outputBits, _noiseBits);
+		const auto funcs = findProcessFuncs(_outputBits, _noiseBits);
 
-		if(processFunc == nullptr)
+		if(funcs.processSample == nullptr)
 		{
 			LOG("DAC configuration failed, unable to find process function for outputBits << " << _outputBits << " and noise bits " << _noiseBits);
 			return false;
 		}
 
-		m_processFunc = processFunc;
+		m_funcs = funcs;
 		m_outputBits = _outputBits;
 		m_noiseBits = _noiseBits;
 
@@ -19,18 +19,37 @@ namespace synthLib
 
 	namespace dacHelper
 	{
+		// https://en.wikipedia.org/wiki/Linear_congruential_generator
+		constexpr uint32_t LcgMul = 1664525;
+		constexpr uint32_t LcgAdd = 1013904223;
+//		constexpr uint32_t LcgMod = 0xffffffff;
+
 		inline uint32_t lcg(uint32_t& _state)
 		{
-			// https://en.wikipedia.org/wiki/Linear_congruential_generator
-			constexpr uint32_t a = 1664525;
-			constexpr uint32_t c = 1013904223;
-//			constexpr uint32_t m = 0xffffffff;
-
-			_state = (a * (_state) + c);// & m;
+			_state = (LcgMul * (_state) + LcgAdd);// & LcgMod;
 
 			return _state;
 		}
 
+		// multiplier and increment that advance the LCG by _steps at once. Used to run several interleaved lanes
+		// of the generator in parallel that produce exactly the same sequence as the serial version
+		struct LcgJump
+		{
+			uint32_t mul;
+			uint32_t add;
+		};
+
+		constexpr LcgJump lcgJump(const uint32_t _steps)
+		{
+			LcgJump j{1, 0};
+			for(uint32_t i=0; i<_steps; ++i)
+			{
+				j.mul *= LcgMul;
+				j.add = j.add * LcgMul + LcgAdd;
+			}
+			return j;
+		}
+
 		template<typename T, size_t numBitsSrc> T signextend(const T _src)
 		{
 			const T shiftAmount = (sizeof(T) * CHAR_BIT) - numBitsSrc;
@@ -83,6 +102,10 @@ namespace synthLib
 
 			return static_cast<float>(v) * IntToFloatScale;
 		}
+
+		// converts a whole buffer, produces the same output as calling processSample for each sample. Defined in
+		// dac.cpp, instantiated for all configurations supported by Dac
+		static void processBlock(DacState& _dacState, float* _out, const uint32_t* _in, size_t _count);
 	};
 
 	class Dac
@@ -91,18 +114,35 @@ namespace synthLib
 		Dac();
 
 		using ProcessFunc = float(*)(DacState&, uint32_t);
+		using ProcessBlockFunc = void(*)(DacState&, float*, const uint32_t*, size_t);
+
+		struct ProcessFuncs
+		{
+			ProcessFunc processSample = nullptr;
+			ProcessBlockFunc processBlock = nullptr;
+		};
 
 		bool configure(uint32_t _outputBits, uint32_t _noiseBits);
 
 		float processSample(const uint32_t _in)
 		{
-			return m_processFunc(m_state, _in);
+			return m_funcs.processSample(m_state, _in);
 		}
 
-	private:
-		static ProcessFunc findProcessFunc(uint32_t _outputBits, uint32_t _noiseBits);
+		void processBlock(float* _out, const uint32_t* _in, const size_t _count)
+		{
+			m_funcs.processBlock(m_state, _out, _in, _count);
+		}
 
-		ProcessFunc m_processFunc;
+		// converts all channels, the dither generator continues from one channel to the next
+		void processBlock(float* const* _outs, const uint32_t* const* _ins, const size_t _channelCount, const size_t _count)
+		{
+			for(size_t c=0; c<_channelCount; ++c)
+				m_funcs.processBlock(m_state, _outs[c], _ins[c], _count);
+		}
+
+	private:
+		ProcessFuncs m_funcs;
 		DacState m_state;
 		uint32_t m_outputBits = 24;
 		uint32_t m_noiseBits = 1;
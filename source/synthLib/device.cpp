@@ -38,6 +38,13 @@ namespace synthLib
 
 		for (const auto& ev : _midiIn)
 		{
+			// regular sysex passes the translator unmodified, send it directly instead of copying the payload
+			if (!ev.sysex.empty() && !MidiTranslator::isTranslatorSysex(ev))
+			{
+				sendMidi(ev, _midiOut);
+				continue;
+			}
+
 			m_translatorOut.clear();
 
 			m_midiTranslator.process(m_translatorOut, ev);
@@ -146,7 +146,19 @@
 #include "mameResamplers.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#   define HAVE_SSE 1
+#   include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_ARCH_8) || defined(_M_ARM64)
+#   define HAVE_SSE 1
+#   include "baseLib/sse2neon.h"
+#else
+#   define HAVE_SSE 0
+#endif
 
 namespace synthLib
 {
@@ -154,17 +166,164 @@ namespace synthLib
     {
         constexpr double kPi = 3.14159265358979323846;
 
-        static float sample_at(const std::deque<float>& src, const int64_t srcBase, const int64_t index)
+        float sample_at(const float* src, const size_t srcSize, const int64_t srcBase, const int64_t index)
         {
             if (index < srcBase)
                 return 0.0f;
 
             const int64_t off = index - srcBase;
-            if (off < 0 || static_cast<size_t>(off) >= src.size())
+            if (static_cast<size_t>(off) >= srcSize)
                 return 0.0f;
 
             return src[static_cast<size_t>(off)];
         }
+
+        // Fills ranges with pointers to the source range [rangeStart, rangeEnd] of every channel. If
+        // the range is fully available in the history, no copy is made. Otherwise (only at stream
+        // start), the range is copied to the scratch buffer and missing samples are zero
+        void source_ranges(const float** ranges, std::vector<float>& scratch, const float* const* src, const uint32_t channels, const size_t srcSize, const int64_t srcBase, const int64_t rangeStart, const int64_t rangeEnd)
+        {
+            if (rangeStart >= srcBase && rangeEnd < srcBase + static_cast<int64_t>(srcSize))
+            {
+                for (uint32_t c = 0; c < channels; ++c)
+                    ranges[c] = src[c] + (rangeStart - srcBase);
+                return;
+            }
+
+            const size_t rangeSize = static_cast<size_t>(rangeEnd - rangeStart + 1);
+            scratch.resize(rangeSize * channels);
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                float* dst = &scratch[rangeSize * c];
+                for (size_t i = 0; i < rangeSize; ++i)
+                    dst[i] = sample_at(src[c], srcSize, srcBase, rangeStart + static_cast<int64_t>(i));
+                ranges[c] = dst;
+            }
+        }
+
+#if HAVE_SSE
+        float horizontal_sum(__m128 v)
+        {
+            v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+            return _mm_cvtss_f32(v);
+        }
+#endif
+
+        // Computes the dot product of the coefficients a with N channels at once, each coefficient is loaded once for all channels
+        template<uint32_t N>
+        void dot_products(float* results, const float* a, const float* const* b, const uint32_t count)
+        {
+            uint32_t i = 0;
+#if HAVE_SSE
+            __m128 acc[N];
+            for (uint32_t c = 0; c < N; ++c)
+                acc[c] = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 coefs = _mm_loadu_ps(a + i);
+                for (uint32_t c = 0; c < N; ++c)
+                    acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(coefs, _mm_loadu_ps(b[c] + i)));
+            }
+
+            for (uint32_t c = 0; c < N; ++c)
+                results[c] = horizontal_sum(acc[c]);
+#else
+            for (uint32_t c = 0; c < N; ++c)
+                results[c] = 0.0f;
+#endif
+            for (; i < count; ++i)
+            {
+                for (uint32_t c = 0; c < N; ++c)
+                    results[c] += a[i] * b[c][i];
+            }
+        }
+
+        void dot_products(float* results, const float* a, const float* const* b, const uint32_t channels, const uint32_t count)
+        {
+            uint32_t c = 0;
+            for (; c + 4 <= channels; c += 4)
+                dot_products<4>(results + c, a, b + c, count);
+
+            switch (channels - c)
+            {
+            case 3: dot_products<3>(results + c, a, b + c, count); break;
+            case 2: dot_products<2>(results + c, a, b + c, count); break;
+            case 1: dot_products<1>(results + c, a, b + c, count); break;
+            default: break;
+            }
+        }
+    }
+
+    void MameResamplerHistory::clear()
+    {
+        m_readPos = 0;
+        m_size = 0;
+    }
+
+    void MameResamplerHistory::reserve(const size_t capacity)
+    {
+        if (capacity > m_capacity)
+            grow(capacity);
+    }
+
+    float* MameResamplerHistory::beginWrite(const size_t count)
+    {
+        if (m_size + count > m_capacity)
+            grow(m_size + count);
+
+        // write position is in the first half, and as count <= capacity, the region never exceeds the mirrored half
+        const size_t writePos = (m_readPos + m_size) & (m_capacity - 1);
+        return m_buffer.data() + writePos;
+    }
+
+    void MameResamplerHistory::endWrite(const size_t count)
+    {
+        assert(m_size + count <= m_capacity);
+
+        float* buf = m_buffer.data();
+
+        const size_t writePos = (m_readPos + m_size) & (m_capacity - 1);
+        const size_t writeEnd = writePos + count;
+
+        // mirror the written samples into the other half
+        const size_t lowEnd = std::min(writeEnd, m_capacity);
+        if (lowEnd > writePos)
+            std::memcpy(buf + writePos + m_capacity, buf + writePos, (lowEnd - writePos) * sizeof(float));
+        if (writeEnd > m_capacity)
+            std::memcpy(buf, buf + m_capacity, (writeEnd - m_capacity) * sizeof(float));
+
+        m_size += count;
+    }
+
+    void MameResamplerHistory::drop(const size_t count)
+    {
+        if (count >= m_size)
+        {
+            clear();
+            return;
+        }
+        m_readPos = (m_readPos + count) & (m_capacity - 1);
+        m_size -= count;
+    }
+
+    void MameResamplerHistory::grow(const size_t minCapacity)
+    {
+        size_t capacity = m_capacity ? m_capacity : 256;
+        while (capacity < minCapacity)
+            capacity <<= 1;
+
+        std::vector<float> buffer(capacity * 2, 0.0f);
+        if (m_size)
+        {
+            std::memcpy(buffer.data(), data(), m_size * sizeof(float));
+            std::memcpy(buffer.data() + capacity, data(), m_size * sizeof(float));
+        }
+
+        m_buffer.swap(buffer);
+        m_capacity = capacity;
+        m_readPos = 0;
     }
 
     std::unique_ptr<MameResampler> MameResampler::create(const MameResamplerMode mode, const uint32_t fs, const uint32_t ft)
@@ -198,14 +357,15 @@ namespace synthLib
             --filterLength;
         const uint32_t hlen = std::max(1u, filterLength / 2);
 
-        m_coefficients.resize(m_phases);
-        for (uint32_t i = 0; i != m_phases; ++i)
-            m_coefficients[i].resize(m_orderPerLane, 0.0f);
+        m_coefficientStride = (m_orderPerLane + 3) & ~3u;
+        m_coefficients.assign(size_t(m_phases) * m_coefficientStride, 0.0f);
 
         const double cutoff = std::min(fs / 2.0, ft / 2.0);
         auto set_filter = [this](const uint32_t i, const float v)
         {
-            m_coefficients[i % m_phases][i / m_phases] = v;
+            const uint32_t phase = i % m_phases;
+            const uint32_t tap = i / m_phases;
+            m_coefficients[size_t(phase) * m_coefficientStride + (m_orderPerLane - 1 - tap)] = v;
         };
 
         const double wc = 2.0 * kPi * cutoff / (double(fs) * double(m_fsm) / double(1u << m_phaseShift));
@@ -224,12 +384,13 @@ namespace synthLib
 
         for (uint32_t i = 0; i != m_phases; ++i)
         {
+            float* coefs = &m_coefficients[size_t(i) * m_coefficientStride];
             float s = 0.0f;
             for (uint32_t j = 0; j != m_orderPerLane; ++j)
-                s += m_coefficients[i][j];
+                s += coefs[j];
             const float inv = (s != 0.0f) ? (1.0f / s) : 1.0f;
             for (uint32_t j = 0; j != m_orderPerLane; ++j)
-                m_coefficients[i][j] *= inv;
+                coefs[j] *= inv;
         }
 
         m_delta = m_ftm % m_fsm;
@@ -288,34 +449,41 @@ namespace synthLib
         return maxS;
     }
 
-    void MameResamplerHq::apply(const std::deque<float>& src, const int64_t srcBase, float* dest, const uint64_t destSample, const uint32_t samples, const float gain) const
+    void MameResamplerHq::apply(const float* const* src, const uint32_t channels, const size_t srcSize, const int64_t srcBase, float* const* dest, const uint64_t destSample, const uint32_t samples, const float gain) const
     {
-        if (samples == 0)
+        if (samples == 0 || channels == 0)
             return;
 
+        assert(channels <= MaxChannels);
+
         const uint64_t seconds = destSample / m_ft;
         const uint32_t dsamp = static_cast<uint32_t>(destSample % m_ft);
         const uint32_t ssamp = static_cast<uint32_t>((uint64_t(dsamp) * m_fs) / m_ft);
         int64_t s = static_cast<int64_t>(ssamp + uint64_t(m_fs) * seconds);
         uint32_t phase = (dsamp * m_ftm) % m_fsm;
 
-        // Copy needed source range to contiguous buffer for cache-friendly inner loop
         const int64_t rangeStart = s - static_cast<int64_t>(m_orderPerLane) + 1;
         const int64_t rangeEnd = maxSourceIndexNeeded(destSample, samples);
-        const size_t rangeSize = static_cast<size_t>(rangeEnd - rangeStart + 1);
 
-        m_scratchBuffer.resize(rangeSize);
-        for (size_t i = 0; i < rangeSize; ++i)
-            m_scratchBuffer[i] = sample_at(src, srcBase, rangeStart + static_cast<int64_t>(i));
+        const float* sources[MaxChannels];
+        source_ranges(sources, m_scratchBuffer, src, channels, srcSize, srcBase, rangeStart, rangeEnd);
+
+        const float* windows[MaxChannels];
+        float results[MaxChannels];
 
         for (uint32_t sample = 0; sample != samples; ++sample)
         {
-            float acc = 0.0f;
-            const float* filter = m_coefficients[phase >> m_phaseShift].data();
-            const size_t srcOff = static_cast<size_t>(s - rangeStart);
-            for (uint32_t k = 0; k != m_orderPerLane; ++k)
-                acc += filter[k] * m_scratchBuffer[srcOff - k];
-            dest[sample] += acc * gain;
+            // coefficients are reversed, the first tap is applied to the oldest sample of the window
+            const float* filter = &m_coefficients[size_t(phase >> m_phaseShift) * m_coefficientStride];
+            const int64_t windowOffset = (s - rangeStart) - (m_orderPerLane - 1);
+
+            for (uint32_t c = 0; c < channels; ++c)
+                windows[c] = sources[c] + windowOffset;
+
+            dot_products(results, filter, windows, channels, m_orderPerLane);
+
+            for (uint32_t c = 0; c < channels; ++c)
+                dest[c][sample] += results[c] * gain;
 
             phase += m_delta;
             s += m_skip;
@@ -441,11 +609,13 @@ namespace synthLib
         return maxUsed;
     }
 
-    void MameResamplerLofi::apply(const std::deque<float>& src, const int64_t srcBase, float* dest, const uint64_t destSample, const uint32_t samples, const float gain) const
+    void MameResamplerLofi::apply(const float* const* src, const uint32_t channels, const size_t srcSize, const int64_t srcBase, float* const* dest, const uint64_t destSample, const uint32_t samples, const float gain) const
     {
-        if (samples == 0)
+        if (samples == 0 || channels == 0)
             return;
 
+        assert(channels <= MaxChannels);
+
         const uint64_t seconds = destSample / m_ft;
         const uint64_t dsamp = destSample % m_ft;
         const uint64_t ssamp = (dsamp * m_fs * 0x1000ull) / m_ft;
@@ -461,47 +631,58 @@ namespace synthLib
 
         ssample -= static_cast<int64_t>(4 * m_sourceDivide);
 
-        // Copy needed source range to contiguous buffer
         const int64_t rangeStart = ssample;
         const int64_t rangeEnd = maxSourceIndexNeeded(destSample, samples);
-        const size_t rangeSize = static_cast<size_t>(rangeEnd - rangeStart + 1);
 
-        m_scratchBuffer.resize(rangeSize);
-        for (size_t i = 0; i < rangeSize; ++i)
-            m_scratchBuffer[i] = sample_at(src, srcBase, rangeStart + static_cast<int64_t>(i));
+        const float* sources[MaxChannels];
+        source_ranges(sources, m_scratchBuffer, src, channels, srcSize, srcBase, rangeStart, rangeEnd);
 
-        int64_t readPos = ssample;
+        size_t readOffset = 0;
 
-        auto reader = [&]() -> float
+        float s0[MaxChannels], s1[MaxChannels], s2[MaxChannels], s3[MaxChannels];
+
+        auto reader = [&](float* dst)
         {
-            float sm = 0.0f;
-            const size_t off = static_cast<size_t>(readPos - rangeStart);
-            for (uint32_t i = 0; i != m_sourceDivide; ++i)
-                sm += m_scratchBuffer[off + i];
-            readPos += m_sourceDivide;
-            return sm * m_invSourceDivide;
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                float sm = 0.0f;
+                for (uint32_t i = 0; i != m_sourceDivide; ++i)
+                    sm += sources[c][readOffset + i];
+                dst[c] = sm * m_invSourceDivide;
+            }
+            readOffset += m_sourceDivide;
         };
 
         phase <<= 12;
 
-        float s0 = reader();
-        float s1 = reader();
-        float s2 = reader();
-        float s3 = reader();
+        reader(s0);
+        reader(s1);
+        reader(s2);
+        reader(s3);
 
         for (uint32_t sample = 0; sample != samples; ++sample)
         {
             const uint32_t cphase = phase >> 12;
-            dest[sample] += gain * (-s0 * s_interpolationTable[0][0x1000 - cphase] + s1 * s_interpolationTable[1][0x1000 - cphase] + s2 * s_interpolationTable[1][cphase] - s3 * s_interpolationTable[0][cphase]);
+
+            const float w0 = -s_interpolationTable[0][0x1000 - cphase] * gain;
+            const float w1 =  s_interpolationTable[1][0x1000 - cphase] * gain;
+            const float w2 =  s_interpolationTable[1][cphase] * gain;
+            const float w3 = -s_interpolationTable[0][cphase] * gain;
+
+            for (uint32_t c = 0; c < channels; ++c)
+                dest[c][sample] += w0 * s0[c] + w1 * s1[c] + w2 * s2[c] + w3 * s3[c];
 
             phase += m_step;
             if (phase & 0x1000000)
             {
                 phase &= 0x00ffffff;
-                s0 = s1;
-                s1 = s2;
-                s2 = s3;
-                s3 = reader();
+                for (uint32_t c = 0; c < channels; ++c)
+                {
+                    s0[c] = s1[c];
+                    s1[c] = s2[c];
+                    s2[c] = s3[c];
+                }
+                reader(s3);
             }
         }
     }
@@ -1,13 +1,44 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <vector>
 
 namespace synthLib
 {
+    // Contiguous history of source samples for the MAME resamplers.
+    // Implemented as a mirrored ring buffer: every sample is stored twice, at i and i + capacity,
+    // so that the whole history is always readable as one contiguous block without any copying
+    class MameResamplerHistory
+    {
+    public:
+        void clear();
+        void reserve(size_t capacity);
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // oldest sample first, valid for size() elements
+        const float* data() const { return m_buffer.data() + m_readPos; }
+
+        // returns a contiguous region to write count samples to, needs to be followed by endWrite(count)
+        float* beginWrite(size_t count);
+        void endWrite(size_t count);
+
+        // removes count samples from the front
+        void drop(size_t count);
+
+    private:
+        void grow(size_t minCapacity);
+
+        std::vector<float> m_buffer;
+        size_t m_capacity = 0;
+        size_t m_readPos = 0;
+        size_t m_size = 0;
+    };
+
     enum class MameResamplerMode : uint8_t
     {
         Hq,
@@ -19,10 +50,16 @@ namespace synthLib
     public:
         virtual ~MameResampler() = default;
 
+        static constexpr uint32_t MaxChannels = 16;
+
         virtual uint32_t historySize() const = 0;
         virtual int64_t minSourceIndexForOutput(uint64_t destSample) const = 0;
         virtual int64_t maxSourceIndexNeeded(uint64_t destSample, uint32_t samples) const = 0;
-        virtual void apply(const std::deque<float>& src, int64_t srcBase, float* dest, uint64_t destSample, uint32_t samples, float gain) const = 0;
+
+        // Resamples all channels in one go. As all channels share the same timing, phase and
+        // coefficient selection is done once per output sample and applied to every channel.
+        // All channels need to have the same source size and base
+        virtual void apply(const float* const* src, uint32_t channels, size_t srcSize, int64_t srcBase, float* const* dest, uint64_t destSample, uint32_t samples, float gain) const = 0;
 
         static std::unique_ptr<MameResampler> create(MameResamplerMode mode, uint32_t fs, uint32_t ft);
     };
@@ -35,7 +72,7 @@ namespace synthLib
         uint32_t historySize() const override;
         int64_t minSourceIndexForOutput(uint64_t destSample) const override;
         int64_t maxSourceIndexNeeded(uint64_t destSample, uint32_t samples) const override;
-        void apply(const std::deque<float>& src, int64_t srcBase, float* dest, uint64_t destSample, uint32_t samples, float gain) const override;
+        void apply(const float* const* src, uint32_t channels, size_t srcSize, int64_t srcBase, float* const* dest, uint64_t destSample, uint32_t samples, float gain) const override;
 
     private:
         static uint32_t computeGcd(uint32_t fs, uint32_t ft);
@@ -50,7 +87,10 @@ namespace synthLib
         uint32_t m_phases = 0;
         uint32_t m_phaseShift = 0;
 
-        std::vector<std::vector<float>> m_coefficients;
+        // one block of m_coefficientStride floats per phase, stored in reverse order so that
+        // the FIR becomes a forward dot product over the source history
+        std::vector<float> m_coefficients;
+        uint32_t m_coefficientStride = 0;
         mutable std::vector<float> m_scratchBuffer;
     };
 
@@ -62,7 +102,7 @@ namespace synthLib
         uint32_t historySize() const override;
         int64_t minSourceIndexForOutput(uint64_t destSample) const override;
         int64_t maxSourceIndexNeeded(uint64_t destSample, uint32_t samples) const override;
-        void apply(const std::deque<float>& src, int64_t srcBase, float* dest, uint64_t destSample, uint32_t samples, float gain) const override;
+        void apply(const float* const* src, uint32_t channels, size_t srcSize, int64_t srcBase, float* const* dest, uint64_t destSample, uint32_t samples, float gain) const override;
 
     private:
         static const std::array<std::array<float, 0x1001>, 2> s_interpolationTable;
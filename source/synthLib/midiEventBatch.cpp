@@ -0,0 +1,136 @@
+#include "midiEventBatch.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace synthLib
+{
+	MidiEventBatch::MidiEventBatch()
+	{
+		for (auto& lane : m_lanes)
+			lane.events.reserve(256);
+	}
+
+	void MidiEventBatch::add(const SMidiEvent& _ev)
+	{
+		auto& lane = getLane(_ev);
+		if(!lane.events.empty() && lane.events.back().ev.offset > _ev.offset)
+			lane.sorted = false;
+		lane.events.push_back({_ev, m_seq++});
+		++m_size;
+	}
+
+	void MidiEventBatch::add(SMidiEvent&& _ev)
+	{
+		auto& lane = getLane(_ev);
+		if(!lane.events.empty() && lane.events.back().ev.offset > _ev.offset)
+			lane.sorted = false;
+		lane.events.push_back({std::move(_ev), m_seq++});
+		++m_size;
+	}
+
+	bool MidiEventBatch::empty() const
+	{
+		return m_size == 0;
+	}
+
+	size_t MidiEventBatch::size() const
+	{
+		return m_size;
+	}
+
+	void MidiEventBatch::mergeTo(std::vector<SMidiEvent>& _dst)
+	{
+		if(!m_size)
+			return;
+
+		_dst.reserve(_dst.size() + m_size);
+
+		Lane* active[std::tuple_size_v<decltype(m_lanes)>];
+		size_t activeCount = 0;
+
+		for (auto& lane : m_lanes)
+		{
+			if(lane.events.empty())
+				continue;
+			if(!lane.sorted)
+				sortLane(lane);
+			lane.readPos = 0;
+			active[activeCount++] = &lane;
+		}
+
+		// k-way merge. k is tiny, a linear scan over the lane heads is faster than a heap
+		while(activeCount > 1)
+		{
+			size_t best = 0;
+			for(size_t i=1; i<activeCount; ++i)
+			{
+				if(isBefore(head(*active[i]), head(*active[best])))
+					best = i;
+			}
+
+			// the earliest head of all other lanes
+			const Entry* limit = nullptr;
+			for(size_t i=0; i<activeCount; ++i)
+			{
+				if(i != best && (!limit || isBefore(head(*active[i]), *limit)))
+					limit = &head(*active[i]);
+			}
+
+			// take all events of this lane that arrived before the limit
+			auto& lane = *active[best];
+
+			do
+			{
+				_dst.push_back(std::move(lane.events[lane.readPos++].ev));
+			}
+			while(lane.readPos < lane.events.size() && isBefore(head(lane), *limit));
+
+			if(lane.readPos == lane.events.size())
+			{
+				lane.events.clear();
+				for(size_t i=best+1; i<activeCount; ++i)
+					active[i-1] = active[i];
+				--activeCount;
+			}
+		}
+
+		if(activeCount)
+		{
+			auto& lane = *active[0];
+			for(size_t i=lane.readPos; i<lane.events.size(); ++i)
+				_dst.push_back(std::move(lane.events[i].ev));
+			lane.events.clear();
+		}
+
+		for (auto& lane : m_lanes)
+			lane.sorted = true;
+
+		m_size = 0;
+		m_seq = 0;
+	}
+
+	void MidiEventBatch::clear()
+	{
+		for (auto& lane : m_lanes)
+		{
+			lane.events.clear();
+			lane.sorted = true;
+		}
+		m_size = 0;
+		m_seq = 0;
+	}
+
+	MidiEventBatch::Lane& MidiEventBatch::getLane(const SMidiEvent& _ev)
+	{
+		const auto index = static_cast<size_t>(_ev.source);
+		assert(index < m_lanes.size());
+		return m_lanes[std::min(index, m_lanes.size() - 1)];
+	}
+
+	void MidiEventBatch::sortLane(Lane& _lane)
+	{
+		std::sort(_lane.events.begin(), _lane.events.end(), isBefore);
+		_lane.sorted = true;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "midiTypes.h"
+
+namespace synthLib
+{
+	// Collects the MIDI events of one audio block from multiple sources (host, editor, physical inputs, internal events
+	// such as MIDI clock) and merges them into a single list that is sorted by sample offset.
+	//
+	// Each source has its own lane. Sources usually deliver their events in order, so adding an event is a plain append.
+	// The lanes are combined via k-way merge, which is linear in the number of events, instead of inserting each event at
+	// its sorted position. Events with equal offsets keep the order in which they have been added, across all lanes
+	class MidiEventBatch
+	{
+	public:
+		MidiEventBatch();
+
+		void add(const SMidiEvent& _ev);
+		void add(SMidiEvent&& _ev);
+
+		bool empty() const;
+		size_t size() const;
+
+		// appends all events to _dst, sorted by offset. The batch is empty afterwards
+		void mergeTo(std::vector<SMidiEvent>& _dst);
+
+		void clear();
+
+	private:
+		struct Entry
+		{
+			SMidiEvent ev;
+			uint32_t seq;	// arrival order, breaks ties between lanes
+		};
+
+		struct Lane
+		{
+			std::vector<Entry> events;
+			size_t readPos = 0;
+			bool sorted = true;
+		};
+
+		Lane& getLane(const SMidiEvent& _ev);
+		static void sortLane(Lane& _lane);
+
+		static bool isBefore(const Entry& _a, const Entry& _b)
+		{
+			return _a.ev.offset < _b.ev.offset || (_a.ev.offset == _b.ev.offset && _a.seq < _b.seq);
+		}
+
+		static const Entry& head(const Lane& _lane)
+		{
+			return _lane.events[_lane.readPos];
+		}
+
+		std::array<Lane, static_cast<size_t>(MidiEventSource::Count)> m_lanes;
+		size_t m_size = 0;
+		uint32_t m_seq = 0;
+	};
+}
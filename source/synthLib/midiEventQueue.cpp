@@ -0,0 +1,121 @@
+#include "midiEventQueue.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace synthLib
+{
+	namespace
+	{
+		uint32_t roundUpToPowerOfTwo(const uint32_t _value)
+		{
+			uint32_t v = 1;
+			while(v < _value)
+				v <<= 1;
+			return v;
+		}
+	}
+
+	MidiEventQueue::MidiEventQueue(const uint32_t _capacity, const uint32_t _maxOverflowSize)
+	: m_mask(roundUpToPowerOfTwo(std::max(_capacity, 2u)) - 1)
+	, m_maxOverflowSize(_maxOverflowSize)
+	, m_cells(new Cell[m_mask + 1])
+	{
+		for(size_t i=0; i<=m_mask; ++i)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool MidiEventQueue::push(const SMidiEvent& _ev)
+	{
+		return pushImpl(_ev);
+	}
+
+	bool MidiEventQueue::push(SMidiEvent&& _ev)
+	{
+		return pushImpl(std::move(_ev));
+	}
+
+	bool MidiEventQueue::pop(SMidiEvent& _ev)
+	{
+		Cell& cell = m_cells[m_readPos & m_mask];
+
+		const auto seq = cell.sequence.load(std::memory_order_acquire);
+
+		if(seq != m_readPos + 1)
+			return false;	// empty or a producer has not finished writing yet
+
+		// copy instead of move, the cell keeps its sysex capacity and _ev keeps its allocator
+		auto& ev = cell.event;
+		_ev.a = ev.a;
+		_ev.b = ev.b;
+		_ev.c = ev.c;
+		_ev.offset = ev.offset;
+		_ev.source = ev.source;
+		_ev.sysex.assign(ev.sysex.begin(), ev.sysex.end());
+		ev.sysex.clear();
+
+		cell.sequence.store(m_readPos + m_mask + 1, std::memory_order_release);
+		++m_readPos;
+		return true;
+	}
+
+	template<typename T> bool MidiEventQueue::pushImpl(T&& _ev)
+	{
+		if(!m_overflowPending.load(std::memory_order_acquire) && tryPushLockFree(_ev))
+			return true;
+
+		return pushOverflow(std::forward<T>(_ev));
+	}
+
+	template<typename T> bool MidiEventQueue::tryPushLockFree(T& _ev)
+	{
+		auto pos = m_writePos.load(std::memory_order_relaxed);
+
+		while(true)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+
+			const auto seq = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if(diff == 0)
+			{
+				if(m_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.event = std::forward<T>(_ev);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if(diff < 0)
+			{
+				return false;	// full
+			}
+			else
+			{
+				pos = m_writePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template<typename T> bool MidiEventQueue::pushOverflow(T&& _ev)
+	{
+		std::lock_guard lock(m_overflowMutex);
+
+		// the consumer might have drained the ring in the meantime
+		if(!m_overflowPending.load(std::memory_order_relaxed) && tryPushLockFree(_ev))
+			return true;
+
+		if(m_overflow.size() >= m_maxOverflowSize)
+		{
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// always copy, moving would take over the allocator of the event which might belong to another thread
+		m_overflow.emplace_back(static_cast<const SMidiEvent&>(_ev));
+		m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+		m_overflowPending.store(true, std::memory_order_release);
+		return true;
+	}
+}
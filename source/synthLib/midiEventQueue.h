@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "midiTypes.h"
+
+namespace synthLib
+{
+	// Lock-free multi producer / single consumer queue for incoming MIDI events
+	//
+	// Any number of threads (editor, MIDI input, host) may push events, only the audio thread pops them. Producers never wait
+	// for the consumer and the consumer never waits for a producer.
+	//
+	// Overflow policy: if the queue is full, events are appended to an overflow list that is guarded by a mutex. Producers
+	// keep appending to that list until the consumer has drained it to preserve ordering. The consumer only uses try_lock
+	// on it, if a producer holds the lock the overflow is picked up in the next block. If the overflow list exceeds its
+	// maximum size, events are dropped and counted
+	class MidiEventQueue
+	{
+	public:
+		explicit MidiEventQueue(uint32_t _capacity = 4096, uint32_t _maxOverflowSize = 65536);
+
+		MidiEventQueue(const MidiEventQueue&) = delete;
+		MidiEventQueue(MidiEventQueue&&) = delete;
+		MidiEventQueue& operator = (const MidiEventQueue&) = delete;
+		MidiEventQueue& operator = (MidiEventQueue&&) = delete;
+
+		// thread-safe, returns false if the event had to be dropped
+		bool push(const SMidiEvent& _ev);
+		bool push(SMidiEvent&& _ev);
+
+		// consumer only. Invokes _func for each pending event, in order. Every event is copied into _ev before _func is
+		// called, which allows the consumer to control where the sysex payload is allocated. _func may move from _ev
+		template<typename TFunc> void popAll(SMidiEvent& _ev, TFunc&& _func)
+		{
+			while(pop(_ev))
+				_func(_ev);
+
+			if(!m_overflowPending.load(std::memory_order_acquire))
+				return;
+
+			std::unique_lock lock(m_overflowMutex, std::try_to_lock);
+			if(!lock.owns_lock())
+				return;
+
+			// the ring may have received events from producers that did not see the overflow flag yet, they are older
+			while(pop(_ev))
+				_func(_ev);
+
+			for (const auto& e : m_overflow)
+			{
+				_ev = e;
+				_func(_ev);
+			}
+
+			m_overflow.clear();
+			m_overflowPending.store(false, std::memory_order_release);
+		}
+
+		// consumer only. The payload is copied into _ev, the queue keeps its buffers to be reused by the next push
+		bool pop(SMidiEvent& _ev);
+
+		// number of events that did not fit into the lock-free queue and were moved to the overflow list
+		uint64_t getOverflowCount() const { return m_overflowCount.load(std::memory_order_relaxed); }
+
+		// number of events that were lost because the overflow list was full, too
+		uint64_t getDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+	private:
+		template<typename T> bool pushImpl(T&& _ev);
+		template<typename T> bool tryPushLockFree(T& _ev);
+		template<typename T> bool pushOverflow(T&& _ev);
+
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			SMidiEvent event;
+		};
+
+		const size_t m_mask;
+		const uint32_t m_maxOverflowSize;
+
+		std::unique_ptr<Cell[]> m_cells;
+
+		alignas(64) std::atomic<size_t> m_writePos{0};
+		alignas(64) size_t m_readPos = 0;
+
+		alignas(64) std::atomic<bool> m_overflowPending{false};
+		std::mutex m_overflowMutex;
+		std::vector<SMidiEvent> m_overflow;
+
+		std::atomic<uint64_t> m_overflowCount{0};
+		std::atomic<uint64_t> m_droppedCount{0};
+	};
+}
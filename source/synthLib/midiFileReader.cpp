@@ -0,0 +1,312 @@
+#include "midiFileReader.h"
+
+#include <algorithm>
+#include <cstring>	// memcmp
+
+#include "baseLib/filesystem.h"
+
+#include "dsp56kBase/logging.h"
+
+namespace synthLib
+{
+	namespace
+	{
+		constexpr uint32_t g_defaultTempo = 500000;	// microseconds per quarter note, 120 bpm
+
+		struct TickEvent
+		{
+			uint64_t tick = 0;
+			uint32_t tempo = 0;	// != 0 for tempo changes
+			SMidiEvent event;
+		};
+
+		class Reader
+		{
+		public:
+			Reader(const uint8_t* _data, const size_t _size) : m_data(_data), m_size(_size) {}
+
+			bool eof() const { return m_pos >= m_size; }
+			size_t pos() const { return m_pos; }
+			size_t remaining() const { return m_size - m_pos; }
+
+			bool read8(uint8_t& _v)
+			{
+				if(eof())
+					return false;
+				_v = m_data[m_pos++];
+				return true;
+			}
+
+			bool readBE(uint32_t& _v, const uint32_t _bytes)
+			{
+				if(remaining() < _bytes)
+					return false;
+				_v = 0;
+				for(uint32_t i=0; i<_bytes; ++i)
+					_v = (_v << 8) | m_data[m_pos++];
+				return true;
+			}
+
+			bool readVarLen(uint32_t& _v)
+			{
+				_v = 0;
+				for(uint32_t i=0; i<4; ++i)
+				{
+					uint8_t c;
+					if(!read8(c))
+						return false;
+					_v = (_v << 7) | (c & 0x7f);
+					if(!(c & 0x80))
+						return true;
+				}
+				return false;
+			}
+
+			bool checkChunk(const char* _id)
+			{
+				if(remaining() < 4 || memcmp(m_data + m_pos, _id, 4) != 0)
+					return false;
+				m_pos += 4;
+				return true;
+			}
+
+			const uint8_t* current() const { return m_data + m_pos; }
+
+			bool skip(const size_t _count)
+			{
+				if(remaining() < _count)
+					return false;
+				m_pos += _count;
+				return true;
+			}
+
+		private:
+			const uint8_t* m_data;
+			size_t m_size;
+			size_t m_pos = 0;
+		};
+
+		bool readTrack(std::vector<TickEvent>& _events, Reader& _reader, const MidiEventSource _source)
+		{
+			uint64_t tick = 0;
+			uint8_t runningStatus = 0;
+
+			while(!_reader.eof())
+			{
+				uint32_t delta;
+				if(!_reader.readVarLen(delta))
+					return false;
+
+				tick += delta;
+
+				uint8_t status;
+				if(!_reader.read8(status))
+					return false;
+
+				if(status == 0xff)
+				{
+					// meta events cancel running status
+					runningStatus = 0;
+
+					uint8_t type;
+					uint32_t len;
+					if(!_reader.read8(type) || !_reader.readVarLen(len) || _reader.remaining() < len)
+						return false;
+
+					if(type == 0x2f)
+						return true;	// end of track
+
+					if(type == 0x51 && len == 3)
+					{
+						const auto* d = _reader.current();
+						TickEvent e;
+						e.tick = tick;
+						e.tempo = (static_cast<uint32_t>(d[0]) << 16) | (static_cast<uint32_t>(d[1]) << 8) | d[2];
+						if(e.tempo)
+							_events.push_back(std::move(e));
+					}
+
+					_reader.skip(len);
+					continue;
+				}
+
+				if(status == M_STARTOFSYSEX || status == M_ENDOFSYSEX)
+				{
+					runningStatus = 0;
+
+					uint32_t len;
+					if(!_reader.readVarLen(len) || _reader.remaining() < len)
+						return false;
+
+					// F0 starts a new message, F7 is either a continuation packet or an escaped raw sequence.
+					// Incomplete packets are forwarded as is, the plugin reassembles them
+					TickEvent e;
+					e.tick = tick;
+					e.event.source = _source;
+					e.event.sysex.reserve(len + 1);
+					if(status == M_STARTOFSYSEX)
+						e.event.sysex.push_back(M_STARTOFSYSEX);
+					e.event.sysex.insert(e.event.sysex.end(), _reader.current(), _reader.current() + len);
+					_reader.skip(len);
+
+					if(!e.event.sysex.empty())
+						_events.push_back(std::move(e));
+					continue;
+				}
+
+				uint8_t data1;
+
+				if(status & 0x80)
+				{
+					runningStatus = status;
+					if(!_reader.read8(data1))
+						return false;
+				}
+				else
+				{
+					if(!runningStatus)
+					{
+						LOG("Invalid MIDI file, data byte without running status at offset " << _reader.pos());
+						return false;
+					}
+					data1 = status;
+					status = runningStatus;
+				}
+
+				uint8_t data2 = 0;
+
+				const auto type = status & 0xf0;
+
+				if(type != M_PROGRAMCHANGE && type != M_AFTERTOUCH)
+				{
+					if(!_reader.read8(data2))
+						return false;
+				}
+
+				TickEvent e;
+				e.tick = tick;
+				e.event = SMidiEvent(_source, status, data1, data2);
+				_events.push_back(std::move(e));
+			}
+
+			// missing end of track meta event, accept anyway
+			return true;
+		}
+	}
+
+	bool MidiFileReader::load(std::vector<MidiFileEvent>& _events, const std::string& _filename, const MidiEventSource _source)
+	{
+		std::vector<uint8_t> data;
+
+		if(!baseLib::filesystem::readFile(data, _filename))
+		{
+			LOG("Failed to open file " << _filename);
+			return false;
+		}
+
+		return load(_events, data.data(), data.size(), _source);
+	}
+
+	bool MidiFileReader::load(std::vector<MidiFileEvent>& _events, const uint8_t* _data, const size_t _size, const MidiEventSource _source)
+	{
+		Reader reader(_data, _size);
+
+		uint32_t headerLen;
+
+		if(!reader.checkChunk("MThd") || !reader.readBE(headerLen, 4) || headerLen < 6)
+			return false;
+
+		uint32_t format, trackCount, division;
+		if(!reader.readBE(format, 2) || !reader.readBE(trackCount, 2) || !reader.readBE(division, 2))
+			return false;
+
+		reader.skip(headerLen - 6);
+
+		if(format > 1)
+		{
+			LOG("MIDI file format " << format << " is not supported");
+			return false;
+		}
+
+		std::vector<TickEvent> events;
+
+		for(uint32_t t=0; t<trackCount && !reader.eof(); ++t)
+		{
+			uint32_t len;
+
+			// skip unknown chunks
+			while(!reader.checkChunk("MTrk"))
+			{
+				if(!reader.skip(4) || !reader.readBE(len, 4) || !reader.skip(len))
+					return !events.empty();
+			}
+
+			if(!reader.readBE(len, 4))
+				return false;
+
+			len = std::min(len, static_cast<uint32_t>(reader.remaining()));
+
+			Reader trackReader(reader.current(), len);
+			reader.skip(len);
+
+			// events of one track are appended in order, stable sorting below keeps track order for events on the same tick
+			if(!readTrack(events, trackReader, _source))
+			{
+				LOG("Failed to parse MIDI track " << t);
+				return false;
+			}
+		}
+
+		std::stable_sort(events.begin(), events.end(), [](const TickEvent& _a, const TickEvent& _b)
+		{
+			return _a.tick < _b.tick;
+		});
+
+		// convert ticks to seconds. SMPTE based files use a fixed tick duration, tempo changes do not apply
+		const bool smpte = (division & 0x8000) != 0;
+
+		double secondsPerTickSmpte = 0.0;
+		uint32_t ticksPerQuarter = 0;
+
+		if(smpte)
+		{
+			const auto fps = static_cast<uint32_t>(-static_cast<int8_t>(division >> 8));
+			const auto ticksPerFrame = division & 0xff;
+			if(!fps || !ticksPerFrame)
+				return false;
+			secondsPerTickSmpte = 1.0 / ((fps == 29 ? 29.97 : static_cast<double>(fps)) * ticksPerFrame);
+		}
+		else
+		{
+			ticksPerQuarter = division;
+			if(!ticksPerQuarter)
+				return false;
+		}
+
+		uint32_t tempo = g_defaultTempo;
+		uint64_t lastTick = 0;
+		double seconds = 0.0;
+
+		_events.reserve(_events.size() + events.size());
+
+		for (auto& e : events)
+		{
+			const auto deltaTicks = static_cast<double>(e.tick - lastTick);
+
+			seconds += smpte ? deltaTicks * secondsPerTickSmpte : deltaTicks * static_cast<double>(tempo) / (1000000.0 * ticksPerQuarter);
+			lastTick = e.tick;
+
+			if(e.tempo)
+			{
+				tempo = e.tempo;
+				continue;
+			}
+
+			MidiFileEvent& ev = _events.emplace_back();
+			ev.seconds = seconds;
+			ev.event = std::move(e.event);
+		}
+
+		return true;
+	}
+}
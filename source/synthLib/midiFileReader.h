@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "midiTypes.h"
+
+namespace synthLib
+{
+	struct MidiFileEvent
+	{
+		double seconds = 0.0;	// absolute time since start of the file, tempo changes already applied
+		SMidiEvent event;
+	};
+
+	// Reads all channel and sysex events of a standard MIDI file (format 0 and 1) with their absolute timestamps.
+	// Meta events are consumed for tempo evaluation only and are not returned
+	class MidiFileReader
+	{
+	public:
+		static bool load(std::vector<MidiFileEvent>& _events, const std::string& _filename, MidiEventSource _source = MidiEventSource::Host);
+		static bool load(std::vector<MidiFileEvent>& _events, const uint8_t* _data, size_t _size, MidiEventSource _source = MidiEventSource::Host);
+	};
+}
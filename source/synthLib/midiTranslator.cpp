@@ -35,7 +35,7 @@ namespace synthLib
 			return;
 		}
 
-		if (size < 4 || _source.sysex.front() != 0xf0 || _source.sysex.back() != 0xf7 || _source.sysex[1] != ManufacturerId)
+		if (!isTranslatorSysex(_source))
 		{
 			_results.push_back(_source);
 			return;
@@ -71,6 +71,12 @@ namespace synthLib
 		}
 	}
 
+	bool MidiTranslator::isTranslatorSysex(const SMidiEvent& _ev)
+	{
+		const auto& sysex = _ev.sysex;
+		return sysex.size() >= 4 && sysex.front() == 0xf0 && sysex.back() == 0xf7 && sysex[1] == ManufacturerId;
+	}
+
 	bool MidiTranslator::addTargetChannel(const uint8_t _sourceChannel, const uint8_t _targetChannel)
 	{
 		if (_sourceChannel >= 16 || _targetChannel >= 16)
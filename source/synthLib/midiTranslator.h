@@ -43,6 +43,9 @@ namespace synthLib
 		void reset();
 		void clear();
 
+		// returns true if the event is a sysex message addressed to the translator itself
+		static bool isTranslatorSysex(const SMidiEvent& _ev);
+
 		static SMidiEvent& createPacketSkipTranslation(SMidiEvent& _ev);
 		static SMidiEvent createPacketSetTargetChannel(MidiEventSource _source, uint8_t _sourceChannel, uint8_t _targetChannel);
 
@@ -232,6 +232,14 @@ namespace synthLib
 		{
 		}
 
+#if SYNTHLIB_HAS_PMR
+		// creates an event whose sysex payload is allocated from the given memory resource
+		explicit SMidiEvent(std::pmr::memory_resource* _sysexResource, const MidiEventSource _source = MidiEventSource::Unknown)
+			: a(0), b(0), c(0), sysex(_sysexResource), offset(0), source(_source)
+		{
+		}
+#endif
+
 		SMidiEvent(const SMidiEvent& _e) : a(_e.a), b(_e.b), c(_e.c), sysex(_e.sysex), offset(_e.offset), source(_e.source)
 		{
 			assert(empty() || source != MidiEventSource::Unknown);
@@ -0,0 +1,164 @@
+#include "offlineRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "device.h"
+
+namespace synthLib
+{
+	OfflineRenderer::OfflineRenderer(Device& _device, const Config& _config)
+	: m_config(_config)
+	, m_channelCountIn(_device.getChannelCountIn())
+	, m_channelCountOut(_device.getChannelCountOut())
+	, m_plugin(&_device, [](Device* _d) { return _d; })
+	{
+		m_samplerate = _config.samplerate > 0.0f ? _config.samplerate : _device.getSamplerate();
+
+		m_plugin.setOfflineMode(true);
+		m_plugin.setResamplerMode(_config.resamplerMode);
+		m_plugin.setHostSamplerate(m_samplerate, m_samplerate);
+		m_plugin.setBlockSize(_config.blockSize);
+
+		m_blockIn.resize(m_channelCountIn);
+		m_blockOut.resize(m_channelCountOut);
+
+		for (auto& b : m_blockIn)
+			b.resize(_config.blockSize, 0.0f);
+		for (auto& b : m_blockOut)
+			b.resize(_config.blockSize, 0.0f);
+	}
+
+	void OfflineRenderer::addEvent(const uint64_t _samplePos, const SMidiEvent& _ev)
+	{
+		if(!m_events.empty() && _samplePos < m_events.back().samplePos)
+			m_eventsSorted = false;
+
+		m_events.push_back({_samplePos, _ev});
+	}
+
+	void OfflineRenderer::addEvents(const std::vector<MidiFileEvent>& _events)
+	{
+		m_events.reserve(m_events.size() + _events.size());
+
+		for (const auto& e : _events)
+			addEvent(static_cast<uint64_t>(std::llround(std::max(0.0, e.seconds) * static_cast<double>(m_samplerate))), e.event);
+	}
+
+	void OfflineRenderer::clearEvents()
+	{
+		m_events.clear();
+		m_eventsSorted = true;
+		m_nextEvent = 0;
+	}
+
+	void OfflineRenderer::setInput(std::vector<std::vector<float>> _channels)
+	{
+		m_input = std::move(_channels);
+	}
+
+	bool OfflineRenderer::render(std::vector<std::vector<float>>& _output, const uint64_t _length)
+	{
+		if(!m_plugin.isValid())
+			return false;
+
+		if(!m_eventsSorted)
+		{
+			std::stable_sort(m_events.begin(), m_events.end(), [](const TimedEvent& _a, const TimedEvent& _b)
+			{
+				return _a.samplePos < _b.samplePos;
+			});
+			m_eventsSorted = true;
+		}
+
+		m_nextEvent = 0;
+
+		const auto sr = static_cast<double>(m_samplerate);
+
+		const auto preRoll = static_cast<uint64_t>(std::llround(std::max(0.0, m_config.preRollSeconds) * sr));
+		const auto tail = static_cast<uint64_t>(std::llround(std::max(0.0, m_config.tailSeconds) * sr));
+		const uint64_t latency = m_config.compensateLatency ? m_plugin.getLatencyMidiToOutput() : 0;
+
+		const auto length = std::max(getEventsLength() + tail, _length);
+		const auto skip = preRoll + latency;
+		const auto total = skip + length;
+
+		_output.resize(m_channelCountOut);
+
+		for (auto& o : _output)
+		{
+			o.clear();
+			o.reserve(length);
+		}
+
+		for(uint64_t pos = 0; pos < total;)
+		{
+			const auto count = static_cast<uint32_t>(std::min<uint64_t>(m_config.blockSize, total - pos));
+
+			processBlock(pos, count, preRoll);
+
+			// drop pre-roll and latency
+			const auto first = pos < skip ? std::min<uint64_t>(skip - pos, count) : 0;
+
+			for(uint32_t c=0; c<m_channelCountOut; ++c)
+				_output[c].insert(_output[c].end(), m_blockOut[c].begin() + static_cast<ptrdiff_t>(first), m_blockOut[c].begin() + count);
+
+			pos += count;
+		}
+
+		return true;
+	}
+
+	uint64_t OfflineRenderer::getEventsLength() const
+	{
+		uint64_t len = 0;
+		for (const auto& e : m_events)
+			len = std::max(len, e.samplePos + 1);
+		return len;
+	}
+
+	void OfflineRenderer::processBlock(const uint64_t _pos, const uint32_t _count, const uint64_t _eventOffset)
+	{
+		const auto blockEnd = _pos + _count;
+
+		while(m_nextEvent < m_events.size() && m_events[m_nextEvent].samplePos + _eventOffset < blockEnd)
+		{
+			const auto& e = m_events[m_nextEvent++];
+
+			SMidiEvent ev(e.event);
+			ev.offset = static_cast<uint32_t>(e.samplePos + _eventOffset - _pos);
+			m_plugin.addMidiEvent(std::move(ev));
+		}
+
+		TAudioInputs ins{};
+		TAudioOutputs outs{};
+
+		for(uint32_t c=0; c<m_channelCountIn && c<ins.size(); ++c)
+		{
+			auto& in = m_blockIn[c];
+
+			std::fill(in.begin(), in.begin() + _count, 0.0f);
+
+			if(c < m_input.size() && blockEnd > _eventOffset)
+			{
+				// input is aligned to the event timeline, i.e. starts after the pre-roll
+				const auto& src = m_input[c];
+				const auto inStart = _pos > _eventOffset ? _pos - _eventOffset : 0;
+				const auto dstStart = _pos > _eventOffset ? 0 : _eventOffset - _pos;
+
+				if(inStart < src.size())
+				{
+					const auto n = std::min<uint64_t>(src.size() - inStart, _count - dstStart);
+					std::copy_n(src.begin() + static_cast<ptrdiff_t>(inStart), n, in.begin() + static_cast<ptrdiff_t>(dstStart));
+				}
+			}
+
+			ins[c] = in.data();
+		}
+
+		for(uint32_t c=0; c<m_channelCountOut && c<outs.size(); ++c)
+			outs[c] = m_blockOut[c].data();
+
+		m_plugin.process(ins, outs, _count, 0.0f, 0.0f, false);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "midiFileReader.h"
+#include "plugin.h"
+
+namespace synthLib
+{
+	class Device;
+
+	// Drives a device as fast as the emulation allows instead of in host sized realtime blocks.
+	// Events are scheduled at absolute sample positions and output is aligned to the MIDI input,
+	// i.e. the plugin latency is removed from the rendered audio
+	class OfflineRenderer
+	{
+	public:
+		struct Config
+		{
+			float samplerate = 0.0f;		// 0 = use the device samplerate, which avoids resampling
+			uint32_t blockSize = 8192;
+			double preRollSeconds = 0.0;	// silence rendered and discarded before the first event, gives the device time to settle
+			double tailSeconds = 2.0;		// rendered after the last event
+			bool compensateLatency = true;
+			Resampler::Mode resamplerMode = Resampler::Mode::Legacy;
+		};
+
+		OfflineRenderer(Device& _device, const Config& _config);
+
+		OfflineRenderer(const OfflineRenderer&) = delete;
+		OfflineRenderer(OfflineRenderer&&) = delete;
+		OfflineRenderer& operator = (const OfflineRenderer&) = delete;
+		OfflineRenderer& operator = (OfflineRenderer&&) = delete;
+
+		void addEvent(uint64_t _samplePos, const SMidiEvent& _ev);
+		void addEvents(const std::vector<MidiFileEvent>& _events);
+		void clearEvents();
+
+		// one vector per channel, missing channels or samples beyond the input length are silent
+		void setInput(std::vector<std::vector<float>> _channels);
+
+		// renders all scheduled events plus the configured tail. _length is a minimum length, 0 renders until the last event only
+		bool render(std::vector<std::vector<float>>& _output, uint64_t _length = 0);
+
+		uint64_t getEventsLength() const;
+		float getSamplerate() const { return m_samplerate; }
+		uint32_t getChannelCountIn() const { return m_channelCountIn; }
+		uint32_t getChannelCountOut() const { return m_channelCountOut; }
+
+		Plugin& getPlugin() { return m_plugin; }
+
+	private:
+		struct TimedEvent
+		{
+			uint64_t samplePos;
+			SMidiEvent event;
+		};
+
+		void processBlock(uint64_t _pos, uint32_t _count, uint64_t _eventOffset);
+
+		const Config m_config;
+		const uint32_t m_channelCountIn;
+		const uint32_t m_channelCountOut;
+
+		Plugin m_plugin;
+		float m_samplerate = 0.0f;
+
+		std::vector<TimedEvent> m_events;
+		bool m_eventsSorted = true;
+		size_t m_nextEvent = 0;
+
+		std::vector<std::vector<float>> m_input;
+		std::vector<std::vector<float>> m_blockIn;
+		std::vector<std::vector<float>> m_blockOut;
+	};
+}
@@ -11,25 +11,29 @@ namespace synthLib
 {
 	constexpr uint8_t g_stateVersion = 1;
 
+	constexpr size_t g_midiEventReserve = 1024;
+
 	Plugin::Plugin(Device* _device, CallbackDeviceInvalid _callbackDeviceInvalid)
-	: m_resampler(_device->getChannelCountIn(), _device->getChannelCountOut())
+	: m_midiInQueueEvent(m_sysexArena.createEvent())
+	, m_pendingSysexInput(m_sysexArena.createEvent())
+	, m_resampler(_device->getChannelCountIn(), _device->getChannelCountOut())
 	, m_device(_device)
 	, m_midiClock(*this)
 	, m_deviceSamplerate(_device->getSamplerate())
 	, m_callbackDeviceInvalid(std::move(_callbackDeviceInvalid))
 	{
+		m_midiIn.reserve(g_midiEventReserve);
+		m_midiOut.reserve(g_midiEventReserve);
 	}
 
 	void Plugin::addMidiEvent(const SMidiEvent& _ev)
 	{
-		std::lock_guard lock(m_lockAddMidiEvent);
+		m_midiInQueue.push(_ev);
+	}
 
-		if(m_midiInRingBuffer.full())
-		{
-			std::lock_guard l(m_lock);
-			processMidiInEvent(m_midiInRingBuffer.pop_front());
-		}
-		m_midiInRingBuffer.push_back(_ev);
+	void Plugin::addMidiEvent(SMidiEvent&& _ev)
+	{
+		m_midiInQueue.push(std::move(_ev));
 	}
 
 	bool Plugin::setPreferredDeviceSamplerate(const float _samplerate)
@@ -74,6 +78,11 @@ namespace synthLib
 
 	void Plugin::process(const TAudioInputs& _inputs, const TAudioOutputs& _outputs, size_t _count, const float _bpm, const float _ppqPos, const bool _isPlaying)
 	{
+		using Stage = ProcessTimings::Stage;
+		using Clock = ProcessTimings::Clock;
+
+		const auto tStart = Clock::now();
+
 		baseLib::setFlushDenormalsToZero();
 
 		TAudioInputs inputs(_inputs);
@@ -98,13 +107,33 @@ namespace synthLib
 		processMidiInEvents();
 		processMidiClock(_bpm, _ppqPos, _isPlaying, _count);
 
+		m_midiInBatch.mergeTo(m_midiIn);
+
+		const auto tMidi = Clock::now();
+
+		Clock::duration deviceTime{0};
+
 		m_resampler.process(inputs, outputs, m_midiIn, m_midiOut, static_cast<uint32_t>(_count), 
 			[&](const TAudioInputs& _ins, const TAudioOutputs& _outs, size_t _c, const ResamplerInOut::TMidiVec& _midiIn, ResamplerInOut::TMidiVec& _midiOut)
 		{
+			const auto t = Clock::now();
 			m_device->process(_ins, _outs, _c, _midiIn, _midiOut);
+			deviceTime += Clock::now() - t;
 		});
 
 		m_midiIn.clear();
+
+		const auto tEnd = Clock::now();
+
+		ProcessTimings::StageTimes times;
+		times[static_cast<size_t>(Stage::Total)] = tEnd - tStart;
+		times[static_cast<size_t>(Stage::Midi)] = tMidi - tStart;
+		times[static_cast<size_t>(Stage::Resampler)] = tEnd - tMidi - deviceTime;
+		times[static_cast<size_t>(Stage::Device)] = deviceTime;
+
+		const auto budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(static_cast<double>(_count) * m_hostSamplerateInv));
+
+		m_processTimings.addBlock(times, budget);
 	}
 
 	void Plugin::getMidiOut(std::vector<SMidiEvent>& _midiOut)
@@ -180,22 +209,7 @@ namespace synthLib
 #endif
 	void Plugin::insertMidiEvent(const SMidiEvent& _ev)
 	{
-		if(m_midiIn.empty() || m_midiIn.back().offset <= _ev.offset)
-		{
-			m_midiIn.push_back(_ev);
-			return;
-		}
-
-		for (auto it = m_midiIn.begin(); it != m_midiIn.end(); ++it)
-		{
-			if (it->offset > _ev.offset)
-			{
-				m_midiIn.insert(it, _ev);
-				return;
-			}
-		}
-
-		m_midiIn.push_back(_ev);
+		m_midiInBatch.add(_ev);
 	}
 
 	bool Plugin::setLatencyBlocks(uint32_t _latencyBlocks)
@@ -210,6 +224,17 @@ namespace synthLib
 		return true;
 	}
 
+	void Plugin::setOfflineMode(const bool _offline)
+	{
+		std::lock_guard lock(m_lock);
+
+		if(m_offlineMode == _offline)
+			return;
+
+		m_offlineMode = _offline;
+		updateDeviceLatency();
+	}
+
 	void Plugin::processMidiClock(const float _bpm, const float _ppqPos, const bool _isPlaying, const size_t _sampleCount)
 	{
 		m_midiClock.process(_bpm, _ppqPos, _isPlaying, _sampleCount);
@@ -228,7 +253,7 @@ namespace synthLib
 		if(m_blockSize <= 0 || m_hostSamplerate <= 0)
 			return;
 
-		const auto latency = static_cast<uint32_t>(std::ceil(static_cast<float>(m_blockSize * m_extraLatencyBlocks) * m_device->getSamplerate() * m_hostSamplerateInv));
+		const auto latency = static_cast<uint32_t>(std::ceil(static_cast<float>(m_blockSize * getEffectiveLatencyBlocks()) * m_device->getSamplerate() * m_hostSamplerateInv));
 		m_device->setExtraLatencySamples(latency);
 
 		m_deviceLatencyMidiToOutput = static_cast<uint32_t>(static_cast<float>(m_device->getInternalLatencyMidiToOutput()) * m_hostSamplerate / m_device->getSamplerate());
@@ -237,15 +262,14 @@ namespace synthLib
 
 	void Plugin::processMidiInEvents()
 	{
-		while (!m_midiInRingBuffer.empty())
+		// events are copied into arena memory and moved from there on, no heap allocations on the audio thread
+		m_midiInQueue.popAll(m_midiInQueueEvent, [this](SMidiEvent& _ev)
 		{
-			const auto ev = m_midiInRingBuffer.pop_front();
-
-			processMidiInEvent(ev);
-		}
+			processMidiInEvent(_ev);
+		});
 	}
 
-	void Plugin::processMidiInEvent(const SMidiEvent& _ev)
+	void Plugin::processMidiInEvent(SMidiEvent& _ev)
 	{
 		// sysex might be sent in multiple chunks. Happens if coming from hardware
 		if (!_ev.sysex.empty())
@@ -254,7 +278,7 @@ namespace synthLib
 
 			if (isComplete)
 			{
-				m_midiIn.push_back(_ev);
+				m_midiInBatch.add(std::move(_ev));
 				return;
 			}
 
@@ -273,13 +297,13 @@ namespace synthLib
 
 				if (isEnd)
 				{
-					m_midiIn.push_back(m_pendingSysexInput);
+					m_midiInBatch.add(std::move(m_pendingSysexInput));
 					m_pendingSysexInput.sysex.clear();
 				}
 			}
 		}
 
-		m_midiIn.push_back(_ev);
+		m_midiInBatch.add(std::move(_ev));
 	}
 
 	void Plugin::setBlockSize(const uint32_t _blockSize)
@@ -292,12 +316,12 @@ namespace synthLib
 	uint32_t Plugin::getLatencyMidiToOutput() const
 	{
 		std::lock_guard lock(m_lock);
-		return m_blockSize * m_extraLatencyBlocks + m_deviceLatencyMidiToOutput + m_resampler.getOutputLatency();
+		return m_blockSize * getEffectiveLatencyBlocks() + m_deviceLatencyMidiToOutput + m_resampler.getOutputLatency();
 	}
 
 	uint32_t Plugin::getLatencyInputToOutput() const
 	{
 		std::lock_guard lock(m_lock);
-		return m_blockSize * m_extraLatencyBlocks + m_deviceLatencyInputToOutput + m_resampler.getOutputLatency() + m_resampler.getInputLatency();
+		return m_blockSize * getEffectiveLatencyBlocks() + m_deviceLatencyInputToOutput + m_resampler.getOutputLatency() + m_resampler.getInputLatency();
 	}
 }
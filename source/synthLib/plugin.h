@@ -7,10 +7,12 @@
 #include "resamplerInOut.h"
 #include "buildconfig.h"
 
-#include "dsp56kBase/ringbuffer.h"
-
 #include "deviceTypes.h"
 #include "midiClock.h"
+#include "midiEventBatch.h"
+#include "midiEventQueue.h"
+#include "processTimings.h"
+#include "sysexArena.h"
 
 namespace synthLib
 {
@@ -23,7 +25,17 @@ namespace synthLib
 
 		Plugin(Device* _device, CallbackDeviceInvalid _callbackDeviceInvalid);
 
+		// thread-safe, lock-free, can be called from any thread
 		void addMidiEvent(const SMidiEvent& _ev);
+		void addMidiEvent(SMidiEvent&& _ev);
+
+		// number of MIDI events that did not fit into the MIDI input queue and had to be moved to the slow path / were dropped
+		uint64_t getMidiInOverflowCount() const { return m_midiInQueue.getOverflowCount(); }
+		uint64_t getMidiInDroppedCount() const { return m_midiInQueue.getDroppedCount(); }
+
+		// per block timing statistics of process(), can be read and reset from any thread
+		ProcessTimings::Stats getProcessTimings() const { return m_processTimings.getStats(); }
+		void resetProcessTimings() { m_processTimings.reset(); }
 
 		bool setPreferredDeviceSamplerate(float _samplerate);
 
@@ -50,17 +62,30 @@ namespace synthLib
 #endif
 		void insertMidiEvent(const SMidiEvent& _ev);
 
+		static constexpr uint32_t DefaultLatencyBlocks = 1;
+
 		bool setLatencyBlocks(uint32_t _latencyBlocks);
 		uint32_t getLatencyBlocks() const { return m_extraLatencyBlocks; }
 
+		// Offline mode is used for faster than realtime rendering. The extra latency blocks are only needed to
+		// absorb realtime jitter and are disabled while offline, the configured value is restored afterwards
+		void setOfflineMode(bool _offline);
+		bool isOfflineMode() const { return m_offlineMode; }
+
 	private:
 		void processMidiClock(float _bpm, float _ppqPos, bool _isPlaying, size_t _sampleCount);
 		float* getDummyBuffer(size_t _minimumSize);
 		void updateDeviceLatency();
+		uint32_t getEffectiveLatencyBlocks() const { return m_offlineMode ? 0 : m_extraLatencyBlocks; }
 		void processMidiInEvents();
-		void processMidiInEvent(const SMidiEvent& _ev);
+		void processMidiInEvent(SMidiEvent& _ev);
+
+		// needs to be declared before all members that may hold events allocated from it
+		SysexArena m_sysexArena;
 
-		dsp56k::RingBuffer<SMidiEvent, 1024, false> m_midiInRingBuffer;
+		MidiEventQueue m_midiInQueue;
+		SMidiEvent m_midiInQueueEvent;
+		MidiEventBatch m_midiInBatch;
 		std::vector<SMidiEvent> m_midiIn;
 		std::vector<SMidiEvent> m_midiOut;
 
@@ -68,7 +93,6 @@ namespace synthLib
 
 		ResamplerInOut m_resampler;
 		mutable std::recursive_mutex m_lock;
-		mutable std::mutex m_lockAddMidiEvent;
 
 		Device* m_device;
 
@@ -84,7 +108,10 @@ namespace synthLib
 
 		MidiClock m_midiClock;
 
-		uint32_t m_extraLatencyBlocks = 1;
+		ProcessTimings m_processTimings;
+
+		uint32_t m_extraLatencyBlocks = DefaultLatencyBlocks;
+		bool m_offlineMode = false;
 
 		float m_deviceSamplerate = 0.0f;
 		CallbackDeviceInvalid m_callbackDeviceInvalid;
@@ -0,0 +1,131 @@
+#include "prebootCache.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "bootScheduler.h"
+#include "device.h"
+
+#include "dsp56kBase/logging.h"
+
+namespace synthLib
+{
+	namespace
+	{
+		struct Key
+		{
+			std::string deviceType;
+			baseLib::MD5 romHash;
+			uint32_t customData = 0;
+			float preferredSamplerate = 0.0f;
+			float hostSamplerate = 0.0f;
+
+			bool operator == (const Key& _k) const
+			{
+				return deviceType == _k.deviceType && romHash == _k.romHash && customData == _k.customData &&
+					preferredSamplerate == _k.preferredSamplerate && hostSamplerate == _k.hostSamplerate;
+			}
+		};
+
+		Key createKey(const std::string& _deviceType, const DeviceCreateParams& _params)
+		{
+			Key k;
+			k.deviceType = _deviceType;
+			k.romHash = _params.romData.empty() ? _params.romHash : _params.romData.getHash();
+			k.customData = _params.customData;
+			k.preferredSamplerate = _params.preferredSamplerate;
+			k.hostSamplerate = _params.hostSamplerate;
+			return k;
+		}
+
+		struct Spare
+		{
+			Key key;
+			BootScheduler::DeviceFuture device;
+		};
+
+		std::mutex g_mutex;
+		Spare g_spare;
+		std::atomic<bool> g_enabled{false};
+
+		std::unique_ptr<Device> takeSpare(const Key& _key)
+		{
+			std::lock_guard lock(g_mutex);
+
+			if(!g_spare.device.valid() || !(g_spare.key == _key))
+				return {};
+
+			// never wait for a spare that is still booting, the calling thread may occupy the boot slot that it needs
+			if(!BootScheduler::isReady(g_spare.device))
+				return {};
+
+			try
+			{
+				return g_spare.device.get();
+			}
+			catch(const std::exception& e)
+			{
+				LOG("Spare device failed to boot: " << e.what());
+				return {};
+			}
+		}
+
+		void prepareSpare(const Key& _key, const PrebootCache::CreateFunc& _create)
+		{
+			std::lock_guard lock(g_mutex);
+
+			if(g_spare.device.valid() && g_spare.key == _key)
+				return;
+
+			g_spare.key = _key;
+			g_spare.device = BootScheduler::boot(_create, BootScheduler::Priority::Background);
+		}
+	}
+
+	Device* PrebootCache::create(const std::string& _deviceType, const DeviceCreateParams& _params, const CreateFunc& _create)
+	{
+		if(!isEnabled())
+			return _create();
+
+		const auto key = createKey(_deviceType, _params);
+
+		Device* device;
+
+		if(auto spare = takeSpare(key))
+		{
+			LOG("Using prebooted device of type " << _deviceType);
+			device = spare.release();
+		}
+		else
+		{
+			device = _create();
+		}
+
+		if(device && device->isValid())
+			prepareSpare(key, _create);
+
+		return device;
+	}
+
+	void PrebootCache::clear()
+	{
+		BootScheduler::DeviceFuture spare;
+		{
+			std::lock_guard lock(g_mutex);
+			std::swap(spare, g_spare.device);
+		}
+	}
+
+	void PrebootCache::setEnabled(const bool _enabled)
+	{
+		g_enabled = _enabled;
+
+		if(!_enabled)
+			clear();
+	}
+
+	bool PrebootCache::isEnabled()
+	{
+		return g_enabled;
+	}
+}
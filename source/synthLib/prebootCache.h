@@ -0,0 +1,39 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace synthLib
+{
+	class Device;
+	struct DeviceCreateParams;
+
+	// Keeps a booted spare device to make subsequent device creations instant. Opt-in, see setEnabled()
+	//
+	// Device creation includes the complete boot of the emulated hardware, which takes seconds and is repeated for
+	// every instance and every device swap (ROM change, reboot, fallback from a remote device). Whenever a device is
+	// created via this cache, a spare with identical creation parameters (device type, ROM, custom data, samplerate)
+	// is booted in the background via the BootScheduler and handed out on the next request with the same parameters.
+	//
+	// At most one spare is kept at a time to limit the memory usage, it costs the memory and the boot time of one
+	// additional device. Spares are booted with background priority, they never delay the boot of a device that is
+	// needed now. Spares that are not ready yet are never waited for, the device is created synchronously in this
+	// case. All functions are thread-safe
+	class PrebootCache
+	{
+	public:
+		using CreateFunc = std::function<Device*()>;
+
+		// _create needs to create a device that matches _params, it is called on the calling thread if there is no spare
+		// and on a boot thread to create the next spare. It may outlive the caller and should capture by value only
+		static Device* create(const std::string& _deviceType, const DeviceCreateParams& _params, const CreateFunc& _create);
+
+		// destroys the spare device, if any. Needs to be called before the library is unloaded
+		static void clear();
+
+		// if disabled, create() creates devices directly and no spare is kept. Disabled by default, a spare doubles
+		// the memory and the number of emulation threads of the first instance of a synth
+		static void setEnabled(bool _enabled);
+		static bool isEnabled();
+	};
+}
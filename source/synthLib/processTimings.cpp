@@ -0,0 +1,150 @@
+#include "processTimings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace synthLib
+{
+	namespace
+	{
+		// single writer, no read-modify-write needed
+		template<typename T> void store(std::atomic<T>& _a, const T _v)
+		{
+			_a.store(_v, std::memory_order_relaxed);
+		}
+
+		template<typename T> T load(const std::atomic<T>& _a)
+		{
+			return _a.load(std::memory_order_relaxed);
+		}
+
+		float toUs(const uint64_t _ns)
+		{
+			return static_cast<float>(static_cast<double>(_ns) * 0.001);
+		}
+	}
+
+	ProcessTimings::ProcessTimings()
+	{
+		doReset();
+	}
+
+	void ProcessTimings::addBlock(const StageTimes& _times, const Clock::duration _budget)
+	{
+		if(m_resetRequested.exchange(false, std::memory_order_acquire))
+			doReset();
+
+		for(size_t i=0; i<m_stages.size(); ++i)
+		{
+			auto& s = m_stages[i];
+
+			const auto ns = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(_times[i]).count()));
+
+			if(ns < load(s.minNs))	store(s.minNs, ns);
+			if(ns > load(s.maxNs))	store(s.maxNs, ns);
+
+			store(s.sumNs, load(s.sumNs) + ns);
+
+			auto& bucket = s.histogram[getBucket(ns)];
+			store(bucket, load(bucket) + 1);
+		}
+
+		const auto budgetNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(_budget).count());
+
+		store(m_budgetSumNs, load(m_budgetSumNs) + budgetNs);
+
+		if(_budget.count() > 0 && _times[static_cast<size_t>(Stage::Total)] > _budget)
+			store(m_overrunCount, load(m_overrunCount) + 1);
+
+		// block count last, readers use it to detect that there is any data
+		m_blockCount.store(load(m_blockCount) + 1, std::memory_order_release);
+	}
+
+	ProcessTimings::Stats ProcessTimings::getStats() const
+	{
+		Stats stats;
+
+		const auto blockCount = m_blockCount.load(std::memory_order_acquire);
+
+		if(!blockCount || m_resetRequested.load(std::memory_order_relaxed))
+			return stats;
+
+		stats.blockCount = blockCount;
+		stats.overrunCount = load(m_overrunCount);
+		stats.avgBudgetUs = toUs(load(m_budgetSumNs) / blockCount);
+
+		for(size_t i=0; i<m_stages.size(); ++i)
+		{
+			const auto& s = m_stages[i];
+			auto& dst = stats.stages[i];
+
+			dst.minUs = toUs(load(s.minNs));
+			dst.maxUs = toUs(load(s.maxNs));
+			dst.avgUs = toUs(load(s.sumNs) / blockCount);
+
+			// the audio thread may have added blocks meanwhile, use the histogram total as reference
+			uint64_t total = 0;
+			for (const auto& b : s.histogram)
+				total += load(b);
+
+			const auto threshold = (total * 99 + 99) / 100;
+
+			uint64_t count = 0;
+			for(uint32_t b=0; b<BucketCount; ++b)
+			{
+				count += load(s.histogram[b]);
+				if(count >= threshold)
+				{
+					dst.p99Us = std::clamp(getBucketUpperBoundUs(b), dst.minUs, dst.maxUs);
+					break;
+				}
+			}
+		}
+
+		return stats;
+	}
+
+	const char* ProcessTimings::getStageName(const Stage _stage)
+	{
+		switch (_stage)
+		{
+		case Stage::Total:		return "Total";
+		case Stage::Midi:		return "MIDI";
+		case Stage::Resampler:	return "Resampler";
+		case Stage::Device:		return "Device";
+		default:				return "";
+		}
+	}
+
+	void ProcessTimings::doReset()
+	{
+		for (auto& s : m_stages)
+		{
+			store(s.minNs, std::numeric_limits<uint64_t>::max());
+			store(s.maxNs, uint64_t(0));
+			store(s.sumNs, uint64_t(0));
+			for (auto& b : s.histogram)
+				store(b, 0u);
+		}
+
+		store(m_overrunCount, uint64_t(0));
+		store(m_budgetSumNs, uint64_t(0));
+		m_blockCount.store(0, std::memory_order_release);
+	}
+
+	uint32_t ProcessTimings::getBucket(const uint64_t _ns)
+	{
+		// bucket 0 covers everything up to 1 us
+		if(_ns <= 1000)
+			return 0;
+
+		const auto b = static_cast<uint32_t>(std::log2(static_cast<double>(_ns) * 0.001) * BucketsPerOctave) + 1;
+		return std::min(b, BucketCount - 1);
+	}
+
+	float ProcessTimings::getBucketUpperBoundUs(const uint32_t _bucket)
+	{
+		return std::exp2(static_cast<float>(_bucket) / static_cast<float>(BucketsPerOctave));
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace synthLib
+{
+	// Per block timing statistics of the audio thread
+	//
+	// Written by the audio thread only, can be read from any thread without locking. Values are collected since the last
+	// reset. Percentiles are derived from a histogram with logarithmic buckets, their resolution is about 9%
+	class ProcessTimings
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		enum class Stage : uint8_t
+		{
+			Total,		// everything that happens in Plugin::process
+			Midi,		// MIDI input queue, MIDI clock and event merging
+			Resampler,	// sample rate conversion and buffering, i.e. Total minus everything else
+			Device,		// Device::process, includes waiting for the DSP
+
+			Count
+		};
+
+		struct StageStats
+		{
+			float minUs = 0.0f;
+			float avgUs = 0.0f;
+			float p99Us = 0.0f;
+			float maxUs = 0.0f;
+		};
+
+		struct Stats
+		{
+			std::array<StageStats, static_cast<size_t>(Stage::Count)> stages;
+			uint64_t blockCount = 0;
+			uint64_t overrunCount = 0;	// blocks that took longer than the audio they produced
+			float avgBudgetUs = 0.0f;	// average duration of the audio produced per block
+
+			const StageStats& operator[](Stage _stage) const { return stages[static_cast<size_t>(_stage)]; }
+		};
+
+		using StageTimes = std::array<Clock::duration, static_cast<size_t>(Stage::Count)>;
+
+		ProcessTimings();
+
+		ProcessTimings(const ProcessTimings&) = delete;
+		ProcessTimings(ProcessTimings&&) = delete;
+		ProcessTimings& operator = (const ProcessTimings&) = delete;
+		ProcessTimings& operator = (ProcessTimings&&) = delete;
+
+		// audio thread only
+		void addBlock(const StageTimes& _times, Clock::duration _budget);
+
+		// thread-safe
+		Stats getStats() const;
+		void reset() { m_resetRequested.store(true, std::memory_order_release); }
+
+		static const char* getStageName(Stage _stage);
+
+	private:
+		static constexpr uint32_t BucketsPerOctave = 8;
+		static constexpr uint32_t BucketCount = 20 * BucketsPerOctave;	// 1 us to ~1 s
+
+		struct StageData
+		{
+			std::atomic<uint64_t> minNs;
+			std::atomic<uint64_t> maxNs;
+			std::atomic<uint64_t> sumNs;
+			std::array<std::atomic<uint32_t>, BucketCount> histogram;
+		};
+
+		void doReset();
+		static uint32_t getBucket(uint64_t _ns);
+		static float getBucketUpperBoundUs(uint32_t _bucket);
+
+		std::array<StageData, static_cast<size_t>(Stage::Count)> m_stages;
+
+		std::atomic<uint64_t> m_blockCount{0};
+		std::atomic<uint64_t> m_overrunCount{0};
+		std::atomic<uint64_t> m_budgetSumNs{0};
+
+		std::atomic<bool> m_resetRequested{false};
+	};
+}
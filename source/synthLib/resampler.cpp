@@ -1,6 +1,7 @@
 #include "resampler.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <utility>
 
@@ -61,23 +62,27 @@ uint32_t synthLib::Resampler::process(TAudioOutputs& _output, const uint32_t _nu
 
 uint32_t synthLib::Resampler::processResampleMame(const TAudioOutputs& _output, const uint32_t _numChannels, const uint32_t _numSamples, const TProcessFunc& _processFunc)
 {
-	if (m_mameResamplerOut.empty())
+	if (!m_mameResampler)
 		return 0;
 
-	const int64_t maxNeeded = m_mameResamplerOut[0]->maxSourceIndexNeeded(m_mameDestSample, _numSamples);
-	const int64_t currentEnd = m_mameSourceBaseSample + static_cast<int64_t>(m_mameTempOutput[0].size()) - 1;
+	const int64_t maxNeeded = m_mameResampler->maxSourceIndexNeeded(m_mameDestSample, _numSamples);
+	const int64_t currentEnd = m_mameSourceBaseSample + static_cast<int64_t>(m_mameHistory[0].size()) - 1;
 	const uint32_t requiredInput = (maxNeeded > currentEnd) ? static_cast<uint32_t>(maxNeeded - currentEnd) : 0u;
 
 	ensureMameInput(_numChannels, requiredInput, _processFunc);
 
+	std::array<const float*, std::tuple_size_v<TAudioOutputs>> sources{};
+
 	for (uint32_t i = 0; i < _numChannels; ++i)
 	{
+		sources[i] = m_mameHistory[i].data();
 		std::fill(_output[i], _output[i] + _numSamples, 0.0f);
-		m_mameResamplerOut[i]->apply(m_mameTempOutput[i], m_mameSourceBaseSample, _output[i], m_mameDestSample, _numSamples, 1.0f);
 	}
 
+	m_mameResampler->apply(sources.data(), _numChannels, m_mameHistory[0].size(), m_mameSourceBaseSample, _output.data(), m_mameDestSample, _numSamples, 1.0f);
+
 	m_mameDestSample += _numSamples;
-	trimMameHistory(_numChannels);
+	trimMameHistory();
 	return _numSamples;
 }
 
@@ -135,36 +140,29 @@ void synthLib::Resampler::ensureMameInput(const uint32_t _numChannels, const uin
 	if (_requiredInputSamples == 0)
 		return;
 
+	// let the device render directly into the history
 	TAudioOutputs tempBuffers;
 	tempBuffers.fill(nullptr);
-	m_mameInputTemp.resize(_numChannels);
 	for (uint32_t i = 0; i < _numChannels; ++i)
 	{
-		m_mameInputTemp[i].assign(_requiredInputSamples, 0.0f);
-		tempBuffers[i] = m_mameInputTemp[i].data();
+		float* dst = m_mameHistory[i].beginWrite(_requiredInputSamples);
+		std::fill(dst, dst + _requiredInputSamples, 0.0f);
+		tempBuffers[i] = dst;
 	}
 
 	_processFunc(tempBuffers, _requiredInputSamples);
 
 	for (uint32_t i = 0; i < _numChannels; ++i)
-	{
-		auto& dst = m_mameTempOutput[i];
-		dst.insert(dst.end(), m_mameInputTemp[i].begin(), m_mameInputTemp[i].end());
-	}
+		m_mameHistory[i].endWrite(_requiredInputSamples);
 }
 
-void synthLib::Resampler::trimMameHistory(const uint32_t _numChannels)
+void synthLib::Resampler::trimMameHistory()
 {
-	if (m_mameResamplerOut.empty() || m_mameTempOutput.empty() || m_mameTempOutput[0].empty())
+	if (!m_mameResampler || m_mameHistory.empty() || m_mameHistory[0].empty())
 		return;
 
-	int64_t minNeeded = m_mameResamplerOut[0]->minSourceIndexForOutput(m_mameDestSample);
-	uint32_t historyKeep = m_mameResamplerOut[0]->historySize();
-	for (uint32_t i = 1; i < _numChannels; ++i)
-	{
-		minNeeded = std::min(minNeeded, m_mameResamplerOut[i]->minSourceIndexForOutput(m_mameDestSample));
-		historyKeep = std::max(historyKeep, m_mameResamplerOut[i]->historySize());
-	}
+	const int64_t minNeeded = m_mameResampler->minSourceIndexForOutput(m_mameDestSample);
+	const uint32_t historyKeep = m_mameResampler->historySize();
 
 	int64_t safeBase = minNeeded - static_cast<int64_t>(historyKeep);
 	if (safeBase < 0)
@@ -174,12 +172,12 @@ void synthLib::Resampler::trimMameHistory(const uint32_t _numChannels)
 		return;
 
 	const int64_t drop64 = safeBase - m_mameSourceBaseSample;
-	const size_t drop = static_cast<size_t>(std::min<int64_t>(drop64, static_cast<int64_t>(m_mameTempOutput[0].size())));
+	const size_t drop = static_cast<size_t>(std::min<int64_t>(drop64, static_cast<int64_t>(m_mameHistory[0].size())));
 	if (drop == 0)
 		return;
 
-	for (uint32_t i = 0; i < _numChannels; ++i)
-		m_mameTempOutput[i].erase(m_mameTempOutput[i].begin(), m_mameTempOutput[i].begin() + static_cast<std::ptrdiff_t>(drop));
+	for (auto& history : m_mameHistory)
+		history.drop(drop);
 
 	m_mameSourceBaseSample += static_cast<int64_t>(drop);
 }
@@ -192,9 +190,8 @@ void synthLib::Resampler::destroyResamplers()
 			resample_close(resampler);
 	}
 	m_resamplerOut.clear();
-	m_mameResamplerOut.clear();
-	m_mameTempOutput.clear();
-	m_mameInputTemp.clear();
+	m_mameResampler.reset();
+	m_mameHistory.clear();
 	m_mameSourceBaseSample = 0;
 	m_mameDestSample = 0;
 }
@@ -208,21 +205,22 @@ void synthLib::Resampler::setChannelCount(uint32_t _numChannels)
 
 	m_resamplerOut.resize(_numChannels);
 	m_tempOutput.resize(_numChannels);
-	m_mameResamplerOut.resize(_numChannels);
-	m_mameTempOutput.resize(_numChannels);
+	m_mameHistory.resize(_numChannels);
 
 	for (auto& buf : m_tempOutput)
 		buf.clear();
-	for (auto& buf : m_mameTempOutput)
-		buf.clear();
 
 	const auto factor = static_cast<double>(m_factorOutToIn);
 
 	if (useMameResampler())
 	{
 		const auto mode = (m_mode == Mode::MameLofi) ? MameResamplerMode::Lofi : MameResamplerMode::Hq;
-		for (auto& resampler : m_mameResamplerOut)
-			resampler = MameResampler::create(mode, static_cast<uint32_t>(m_samplerateIn), static_cast<uint32_t>(m_samplerateOut));
+		m_mameResampler = MameResampler::create(mode, static_cast<uint32_t>(m_samplerateIn), static_cast<uint32_t>(m_samplerateOut));
+
+		// preallocate enough history for typical block sizes to prevent growing the buffers on the audio thread
+		const auto historySize = m_mameResampler->historySize();
+		for (auto& history : m_mameHistory)
+			history.reserve(historySize + 4096);
 	}
 	else
 	{
@@ -4,7 +4,6 @@
 
 #include <functional>
 #include <vector>
-#include <deque>
 #include <memory>
 
 #include <cstdint>
@@ -31,11 +30,14 @@ namespace synthLib
 		Resampler(const Resampler&) = delete;
 		~Resampler();
 
-		uint32_t process(AudioBuffer& _output, size_t _outputOffset, uint32_t _numChannels, uint32_t _numSamples, bool _allowLessOutput, const TProcessFunc& _processFunc)
+		// appends the resampled data to _output
+		uint32_t process(AudioBuffer& _output, uint32_t _numChannels, uint32_t _numSamples, bool _allowLessOutput, const TProcessFunc& _processFunc)
 		{
 			TAudioOutputs buffers;
-			_output.fillPointers(buffers, _outputOffset);
-			return process(buffers, _numChannels, _numSamples, _allowLessOutput, _processFunc);
+			_output.beginWrite(buffers, _numSamples);
+			const auto count = process(buffers, _numChannels, _numSamples, _allowLessOutput, _processFunc);
+			_output.endWrite(count);
+			return count;
 		}
 
 		uint32_t process(TAudioOutputs& _output, uint32_t _numChannels, uint32_t _numSamples, bool _allowLessOutput, const TProcessFunc& _processFunc);
@@ -48,7 +50,7 @@ namespace synthLib
 		uint32_t processResample(const TAudioOutputs& _output, uint32_t _numChannels, uint32_t _numSamples, const TProcessFunc& _processFunc);
 		uint32_t processResampleMame(const TAudioOutputs& _output, uint32_t _numChannels, uint32_t _numSamples, const TProcessFunc& _processFunc);
 		void ensureMameInput(uint32_t _numChannels, uint32_t _requiredInputSamples, const TProcessFunc& _processFunc);
-		void trimMameHistory(uint32_t _numChannels);
+		void trimMameHistory();
 		void destroyResamplers();
 		void setChannelCount(uint32_t _numChannels);
 		bool useMameResampler() const { return m_mode != Mode::Legacy; }
@@ -62,9 +64,8 @@ namespace synthLib
 		double m_inputLen = 0.0;
 
 		std::vector<void*> m_resamplerOut;
-		std::vector<std::unique_ptr<MameResampler>> m_mameResamplerOut;
-		std::vector<std::deque<float>> m_mameTempOutput;
-		std::vector<std::vector<float>> m_mameInputTemp;
+		std::unique_ptr<MameResampler> m_mameResampler;	// one for all channels, they share timing and coefficients
+		std::vector<MameResamplerHistory> m_mameHistory;
 		int64_t m_mameSourceBaseSample = 0;
 		uint64_t m_mameDestSample = 0;
 
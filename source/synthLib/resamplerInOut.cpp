@@ -17,6 +17,10 @@ namespace synthLib
 	, m_scaledInput(_channelCountIn)
 	, m_input(_channelCountIn)
 	{
+		constexpr size_t midiReserve = 1024;
+
+		m_midiIn.reserve(midiReserve);
+		m_midiOut.reserve(midiReserve);
 	}
 
 	void ResamplerInOut::setResamplerMode(const Resampler::Mode _mode)
@@ -65,7 +69,7 @@ namespace synthLib
 		m_out.reset(new Resampler(m_samplerateDevice, m_samplerateHost, m_mode));
 		m_in.reset(new Resampler(m_samplerateHost, m_samplerateDevice, m_mode));
 
-		m_scaledInputSize = 0;
+		m_scaledInput.clear();
 		m_inputLatency = 0;
 		m_outputLatency = 0;
 
@@ -85,50 +89,24 @@ namespace synthLib
 			outs[i] = i >= data.size() ? nullptr : &data[i][0];
 
 		TMidiVec midiIn, midiOut;
-		process(ins, outs, TMidiVec(), midiOut, static_cast<uint32_t>(data[0].size()), [&](const TAudioInputs&, const TAudioOutputs&, size_t, const TMidiVec&, TMidiVec&)
+		process(ins, outs, midiIn, midiOut, static_cast<uint32_t>(data[0].size()), [&](const TAudioInputs&, const TAudioOutputs&, size_t, const TMidiVec&, TMidiVec&)
 		{
 		});
 	}
 
-	void ResamplerInOut::scaleMidiEvents(TMidiVec& _dst, const TMidiVec& _src, float _scale)
+	void ResamplerInOut::scaleMidiEvents(TMidiVec& _events, const float _scale)
 	{
-		_dst.clear();
-		_dst.reserve(_src.size());
-
-		for(size_t i=0; i<_src.size(); ++i)
-		{
-			_dst.push_back(_src[i]);
-			_dst[i].offset = floor_int(static_cast<float>(_src[i].offset) * _scale);
-		}
+		for(auto& e : _events)
+			e.offset = floor_int(static_cast<float>(e.offset) * _scale);
 	}
 
-	void ResamplerInOut::clampMidiEvents(TMidiVec& _dst, const TMidiVec& _src, uint32_t _offsetMin, uint32_t _offsetMax)
+	void ResamplerInOut::clampMidiEvents(TMidiVec& _events, const uint32_t _offsetMin, const uint32_t _offsetMax)
 	{
-		_dst.clear();
-		_dst.reserve(_src.size());
-
-		for(size_t i=0; i<_src.size(); ++i)
-		{
-			_dst.push_back(_src[i]);
-			_dst[i].offset = clamp(_dst[i].offset, _offsetMin, _offsetMax);
-		}
-	}
-
-	void ResamplerInOut::extractMidiEvents(TMidiVec& _dst, const TMidiVec& _src, uint32_t _offsetMin, uint32_t _offsetMax)
-	{
-		_dst.clear();
-		_dst.reserve(_src.size());
-
-		for(size_t i=0; i<_src.size(); ++i)
-		{
-			const auto& m = _src[i];
-			if(m.offset < static_cast<int>(_offsetMin) || m.offset > static_cast<int>(_offsetMax))
-				continue;
-			_dst.push_back(m);
-		}
+		for(auto& e : _events)
+			e.offset = clamp(e.offset, _offsetMin, _offsetMax);
 	}
 
-	void ResamplerInOut::process(const TAudioInputs& _inputs, TAudioOutputs& _outputs, const TMidiVec& _midiIn, TMidiVec& _midiOut, const uint32_t _numSamples, const TProcessFunc& _processFunc)
+	void ResamplerInOut::process(const TAudioInputs& _inputs, TAudioOutputs& _outputs, TMidiVec& _midiIn, TMidiVec& _midiOut, const uint32_t _numSamples, const TProcessFunc& _processFunc)
 	{
 		if(!m_in || !m_out)
 			return;
@@ -136,15 +114,28 @@ namespace synthLib
 		if(m_samplerateDevice == m_samplerateHost)
 		{
 			_processFunc(_inputs, _outputs, _numSamples, _midiIn, _midiOut);
+			_midiIn.clear();
 			return;
 		}
 
 		const auto devDivHost = m_samplerateDevice / m_samplerateHost;
 		const auto hostDivDev = m_samplerateHost / m_samplerateDevice;
 
-		m_scaledInput.ensureSize(static_cast<uint32_t>(static_cast<float>(_numSamples) * devDivHost * 2.0f));
+		m_scaledInput.reserve(static_cast<uint32_t>(static_cast<float>(_numSamples) * devDivHost * 2.0f));
 
-		scaleMidiEvents(m_midiIn, _midiIn, devDivHost);
+		// rescale in place and take over the events. Events that have not been processed yet are kept
+		scaleMidiEvents(_midiIn, devDivHost);
+
+		if(m_midiIn.empty())
+		{
+			std::swap(m_midiIn, _midiIn);
+		}
+		else
+		{
+			for(auto& e : _midiIn)
+				m_midiIn.push_back(std::move(e));
+			_midiIn.clear();
+		}
 
 		m_input.append(_inputs, _numSamples);
 
@@ -166,7 +157,7 @@ namespace synthLib
 			if(count)
 			{
 				for(size_t c=0; c<m_channelCountIn; ++c)
-					memcpy(_data[c], &m_input.getChannel(c)[0], sizeof(float) * count);
+					memcpy(_data[c], m_input.getChannel(c), sizeof(float) * count);
 
 				m_input.remove(count);
 			}
@@ -181,21 +172,19 @@ namespace synthLib
 		auto feedOutput = [&](const TAudioOutputs& _outs, const uint32_t _numProcessedSamples)
 		{
 			if(m_channelCountIn)
-				m_scaledInputSize += m_in->process(m_scaledInput, m_scaledInputSize, m_channelCountIn, _numProcessedSamples, false, feedInput);
+				m_in->process(m_scaledInput, m_channelCountIn, _numProcessedSamples, false, feedInput);
 
-			clampMidiEvents(m_processedMidiIn, m_midiIn, 0, _numProcessedSamples-1);
-			m_midiIn.clear();
+			clampMidiEvents(m_midiIn, 0, _numProcessedSamples-1);
 
 			TAudioInputs inputs;
 
 			if(m_channelCountIn)
 			{
-				if(_numProcessedSamples > m_scaledInputSize)
+				if(_numProcessedSamples > m_scaledInput.size())
 				{
 					// resampler prewarming, wants more data than we have
-					const auto diff = _numProcessedSamples - m_scaledInputSize;
+					const auto diff = _numProcessedSamples - m_scaledInput.size();
 					m_scaledInput.insertZeroes(diff);
-					m_scaledInputSize += diff;
 					m_outputLatency += static_cast<uint32_t>(diff);
 					LOG("Resampler output latency " << m_outputLatency << " samples");
 				}
@@ -206,18 +195,17 @@ namespace synthLib
 				inputs.fill(nullptr);
 			}
 
-			_processFunc(inputs, _outs, _numProcessedSamples, m_processedMidiIn, m_midiOut);
+			_processFunc(inputs, _outs, _numProcessedSamples, m_midiIn, m_midiOut);
+			m_midiIn.clear();
 
 			if(m_channelCountIn)
-			{
 				m_scaledInput.remove(_numProcessedSamples);
-				m_scaledInputSize -= _numProcessedSamples;
-			}
 		};
 
 		const auto outputSize = m_out->process(_outputs, m_channelCountOut, _numSamples, false, feedOutput);
 
-		scaleMidiEvents(_midiOut, m_midiOut, hostDivDev);
+		std::swap(_midiOut, m_midiOut);
 		m_midiOut.clear();
+		scaleMidiEvents(_midiOut, hostDivDev);
 	}
 }
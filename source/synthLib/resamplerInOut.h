@@ -21,16 +21,16 @@ namespace synthLib
 		void setHostSamplerate(float _samplerate);
 		void setSamplerates(float _hostSamplerate, float _deviceSamplerate);
 
-		void process(const TAudioInputs& _inputs, TAudioOutputs& _outputs, const TMidiVec& _midiIn, TMidiVec& _midiOut, uint32_t _numSamples, const TProcessFunc& _processFunc);
+		// _midiIn is consumed, events are taken over without copying and the vector is empty afterwards
+		void process(const TAudioInputs& _inputs, TAudioOutputs& _outputs, TMidiVec& _midiIn, TMidiVec& _midiOut, uint32_t _numSamples, const TProcessFunc& _processFunc);
 
 		uint32_t getOutputLatency() const { return m_outputLatency; }
 		uint32_t getInputLatency() const { return m_inputLatency; }
 
 	private:
 		void recreate();
-		static void scaleMidiEvents(TMidiVec& _dst, const TMidiVec& _src, float _scale);
-		static void clampMidiEvents(TMidiVec& _dst, const TMidiVec& _src, uint32_t _offsetMin, uint32_t _offsetMax);
-		static void extractMidiEvents(TMidiVec& _dst, const TMidiVec& _src, uint32_t _offsetMin, uint32_t _offsetMax);
+		static void scaleMidiEvents(TMidiVec& _events, float _scale);
+		static void clampMidiEvents(TMidiVec& _events, uint32_t _offsetMin, uint32_t _offsetMax);
 
 		const uint32_t m_channelCountIn;
 		const uint32_t m_channelCountOut;
@@ -45,10 +45,6 @@ namespace synthLib
 		AudioBuffer m_scaledInput;
 		AudioBuffer m_input;
 
-		size_t m_scaledInputSize = 0;
-
-		TMidiVec m_processedMidiIn;
-
 		TMidiVec m_midiIn;
 		TMidiVec m_midiOut;
 
@@ -0,0 +1,106 @@
+#include "romCache.h"
+
+#include <map>
+#include <mutex>
+
+#include "baseLib/filesystem.h"
+
+namespace synthLib
+{
+	namespace
+	{
+		std::mutex g_mutex;
+		std::map<baseLib::MD5, std::weak_ptr<const void>> g_images;
+
+		const RomImage::Data g_emptyData;
+		const baseLib::MD5 g_emptyHash;
+
+		void purgeExpired()
+		{
+			for(auto it = g_images.begin(); it != g_images.end();)
+			{
+				if(it->second.expired())
+					it = g_images.erase(it);
+				else
+					++it;
+			}
+		}
+	}
+
+	RomImage::RomImage(Data _data) : RomImage(RomCache::get(std::move(_data)))
+	{
+	}
+
+	const RomImage::Data& RomImage::get() const
+	{
+		return m_entry ? m_entry->data : g_emptyData;
+	}
+
+	const baseLib::MD5& RomImage::getHash() const
+	{
+		return m_entry ? m_entry->hash : g_emptyHash;
+	}
+
+	RomImage RomCache::get(RomImage::Data _data)
+	{
+		if(_data.empty())
+			return {};
+
+		// hash outside of the lock, this is the expensive part
+		baseLib::MD5 hash(_data);
+
+		std::scoped_lock lock(g_mutex);
+
+		auto& ref = g_images[hash];
+
+		if(auto existing = std::static_pointer_cast<const RomImage::Entry>(ref.lock()))
+			return RomImage(std::move(existing));
+
+		purgeExpired();
+
+		auto entry = std::make_shared<const RomImage::Entry>(RomImage::Entry{hash, std::move(_data)});
+		g_images[hash] = entry;
+
+		return RomImage(std::move(entry));
+	}
+
+	RomImage RomCache::find(const baseLib::MD5& _hash)
+	{
+		std::scoped_lock lock(g_mutex);
+
+		const auto it = g_images.find(_hash);
+		if(it == g_images.end())
+			return {};
+
+		return RomImage(std::static_pointer_cast<const RomImage::Entry>(it->second.lock()));
+	}
+
+	RomImage RomCache::loadFile(const std::string& _filename)
+	{
+		RomImage::Data data;
+		if(!baseLib::filesystem::readFile(data, _filename))
+			return {};
+		return get(std::move(data));
+	}
+
+	size_t RomCache::getImageCount()
+	{
+		std::scoped_lock lock(g_mutex);
+		purgeExpired();
+		return g_images.size();
+	}
+
+	size_t RomCache::getTotalSize()
+	{
+		std::scoped_lock lock(g_mutex);
+
+		size_t size = 0;
+
+		for (const auto& [hash, ref] : g_images)
+		{
+			if(const auto entry = std::static_pointer_cast<const RomImage::Entry>(ref.lock()))
+				size += entry->data.size();
+		}
+		return size;
+	}
+}
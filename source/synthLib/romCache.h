@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "baseLib/md5.h"
+
+namespace synthLib
+{
+	// Immutable ROM image, shared by all users of identical ROM data
+	//
+	// Copying a RomImage is cheap, it only references the data. Images are created via the RomCache, which
+	// deduplicates them by their content hash, so all device instances that use the same ROM share a single copy
+	class RomImage
+	{
+	public:
+		using Data = std::vector<uint8_t>;
+
+		RomImage() = default;
+
+		// not explicit on purpose, allows to assign raw ROM data where a RomImage is expected
+		RomImage(Data _data);
+
+		bool empty() const { return !m_entry || m_entry->data.empty(); }
+		size_t size() const { return m_entry ? m_entry->data.size() : 0; }
+		const uint8_t* data() const { return get().data(); }
+
+		auto begin() const { return get().begin(); }
+		auto end() const { return get().end(); }
+
+		const uint8_t& operator[](const size_t _index) const { return get()[_index]; }
+
+		const Data& get() const;
+		operator const Data&() const { return get(); }
+
+		// hash of the data, calculated once when the image is created
+		const baseLib::MD5& getHash() const;
+
+		void clear() { m_entry.reset(); }
+
+		bool operator == (const RomImage& _other) const { return m_entry == _other.m_entry; }
+		bool operator != (const RomImage& _other) const { return m_entry != _other.m_entry; }
+
+	private:
+		friend class RomCache;
+
+		struct Entry
+		{
+			baseLib::MD5 hash;
+			Data data;
+		};
+
+		explicit RomImage(std::shared_ptr<const Entry> _entry) : m_entry(std::move(_entry)) {}
+
+		std::shared_ptr<const Entry> m_entry;
+	};
+
+	// Process-wide cache of ROM images, keyed by content hash
+	//
+	// The cache only holds weak references, an image is released as soon as the last device or ROM object using
+	// it is destroyed. All functions are thread-safe
+	class RomCache
+	{
+	public:
+		// returns the existing image if the same data is already in use, creates a new one otherwise
+		static RomImage get(RomImage::Data _data);
+
+		// returns an image that is currently in use or an empty image if there is none with the given hash
+		static RomImage find(const baseLib::MD5& _hash);
+
+		static RomImage loadFile(const std::string& _filename);
+
+		static size_t getImageCount();
+		static size_t getTotalSize();
+	};
+}
@@ -0,0 +1,57 @@
+#include "sysexArena.h"
+
+#include <vector>
+
+namespace synthLib
+{
+#if SYNTHLIB_HAS_PMR
+	struct SysexArena::Impl
+	{
+		explicit Impl(const size_t _size)
+		: buffer(_size)
+		, monotonic(buffer.data(), buffer.size())
+		, pool(createPoolOptions(), &monotonic)
+		{
+		}
+
+		static std::pmr::pool_options createPoolOptions()
+		{
+			std::pmr::pool_options options;
+			options.max_blocks_per_chunk = 16;
+			options.largest_required_pool_block = 256 * 1024;	// larger messages are passed through to the monotonic buffer, i.e. not recycled
+			return options;
+		}
+
+		std::vector<uint8_t> buffer;
+		std::pmr::monotonic_buffer_resource monotonic;
+		std::pmr::unsynchronized_pool_resource pool;
+	};
+#else
+	struct SysexArena::Impl
+	{
+		explicit Impl(size_t) {}
+	};
+#endif
+
+	SysexArena::SysexArena(const size_t _size) : m_impl(std::make_unique<Impl>(_size))
+	{
+	}
+
+	SysexArena::~SysexArena() = default;
+
+	SMidiEvent SysexArena::createEvent(const MidiEventSource _source) const
+	{
+#if SYNTHLIB_HAS_PMR
+		return SMidiEvent(getResource(), _source);
+#else
+		return SMidiEvent(_source);
+#endif
+	}
+
+#if SYNTHLIB_HAS_PMR
+	std::pmr::memory_resource* SysexArena::getResource() const
+	{
+		return &m_impl->pool;
+	}
+#endif
+}
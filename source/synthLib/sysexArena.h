@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "midiTypes.h"
+
+namespace synthLib
+{
+	// Preallocated memory for sysex payloads that are created and destroyed on the audio thread.
+	// Memory is handed out by a pool that recycles freed blocks, so once warmed up, processing sysex does not cause any
+	// heap allocations. If the preallocated memory is exhausted, the arena falls back to the default heap.
+	// Not thread-safe, events using the arena must not be destroyed on a different thread
+	class SysexArena
+	{
+	public:
+		explicit SysexArena(size_t _size = 1024 * 1024);
+		~SysexArena();
+
+		SysexArena(const SysexArena&) = delete;
+		SysexArena(SysexArena&&) = delete;
+		SysexArena& operator = (const SysexArena&) = delete;
+		SysexArena& operator = (SysexArena&&) = delete;
+
+		// creates an (empty) event whose sysex payload is allocated from the arena
+		SMidiEvent createEvent(MidiEventSource _source = MidiEventSource::Unknown) const;
+
+#if SYNTHLIB_HAS_PMR
+		std::pmr::memory_resource* getResource() const;
+#endif
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> m_impl;
+	};
+}
@@ -0,0 +1,117 @@
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "synthLibTest.h"
+
+#include "synthLib/dac.h"
+
+namespace
+{
+	bool sameBits(const float _a, const float _b)
+	{
+		return std::memcmp(&_a, &_b, sizeof(float)) == 0;
+	}
+
+	std::vector<uint32_t> createInput(const size_t _count, uint32_t _seed)
+	{
+		std::vector<uint32_t> input(_count);
+
+		// include full scale values and values with all lower bits set, these are the interesting ones for rounding
+		for (size_t i=0; i<_count; ++i)
+		{
+			switch (i & 7)
+			{
+			case 0:		input[i] = 0x7fffff; break;
+			case 1:		input[i] = 0x800000; break;
+			case 2:		input[i] = 0xffffff; break;
+			default:	input[i] = synthLib::dacHelper::lcg(_seed) >> 8; break;
+			}
+		}
+		return input;
+	}
+
+	void testDacBlock(const uint32_t _outputBits, const uint32_t _noiseBits)
+	{
+		// odd sizes to cover the scalar tail of the block function
+		for (const size_t count : {0, 1, 3, 4, 5, 7, 8, 16, 33, 127, 256})
+		{
+			synthLib::Dac scalar;
+			synthLib::Dac block;
+
+			TEST_ASSERT(scalar.configure(_outputBits, _noiseBits));
+			TEST_ASSERT(block.configure(_outputBits, _noiseBits));
+
+			const auto input = createInput(count, static_cast<uint32_t>(count * 31 + _outputBits));
+
+			std::vector<float> outScalar(count);
+			std::vector<float> outBlock(count);
+
+			// run twice to verify that the dither generator state left behind by the block function is correct
+			for (int pass=0; pass<2; ++pass)
+			{
+				for (size_t i=0; i<count; ++i)
+					outScalar[i] = scalar.processSample(input[i]);
+
+				block.processBlock(outBlock.data(), input.data(), count);
+
+				for (size_t i=0; i<count; ++i)
+					TEST_ASSERT(sameBits(outScalar[i], outBlock[i]));
+			}
+
+			TEST_ASSERT(sameBits(scalar.processSample(0x123456), block.processSample(0x123456)));
+		}
+	}
+
+	void testDacMultiChannel()
+	{
+		constexpr size_t channels = 3;
+		constexpr size_t count = 21;
+
+		synthLib::Dac scalar;
+		synthLib::Dac block;
+
+		TEST_ASSERT(scalar.configure(16, 3));
+		TEST_ASSERT(block.configure(16, 3));
+
+		std::vector<std::vector<uint32_t>> inputs;
+		std::vector<std::vector<float>> outputs;
+
+		std::vector<const uint32_t*> ins;
+		std::vector<float*> outs;
+
+		for (size_t c=0; c<channels; ++c)
+		{
+			inputs.push_back(createInput(count, static_cast<uint32_t>(c)));
+			outputs.emplace_back(count);
+		}
+
+		for (size_t c=0; c<channels; ++c)
+		{
+			ins.push_back(inputs[c].data());
+			outs.push_back(outputs[c].data());
+		}
+
+		block.processBlock(outs.data(), ins.data(), channels, count);
+
+		// the dither generator continues from one channel to the next
+		for (size_t c=0; c<channels; ++c)
+		{
+			for (size_t i=0; i<count; ++i)
+				TEST_ASSERT(sameBits(scalar.processSample(inputs[c][i]), outputs[c][i]));
+		}
+	}
+}
+
+void testDac()
+{
+	std::cout << "Testing Dac block processing..." << std::endl;
+
+	for (const uint32_t outputBits : {8, 12, 16, 18, 24})
+	{
+		for (uint32_t noiseBits=0; noiseBits<8; ++noiseBits)
+			testDacBlock(outputBits, noiseBits);
+	}
+
+	testDacMultiChannel();
+}
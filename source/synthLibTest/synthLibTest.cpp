@@ -0,0 +1,6 @@
+#include "synthLibTest.h"
+
+int main()
+{
+	return baseLib::runUnitTests("synthLib", testDac);
+}
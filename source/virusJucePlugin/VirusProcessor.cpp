@@ -10,6 +10,7 @@
 
 #include "synthLib/deviceException.h"
 #include "synthLib/lv2PresetExport.h"
+#include "synthLib/prebootCache.h"
 
 namespace virus
 {
@@ -79,17 +80,23 @@ namespace virus
 
 		m_clockTempoParam = getController().getParameterIndexByName(virus::g_paramClockTempo);
 
-		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(getPlugin().getLatencyBlocks()));
+		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(synthLib::Plugin::DefaultLatencyBlocks));
 		Processor::setLatencyBlocks(latencyBlocks);
 
 		zynthianExportLv2Presets();
 	}
 
-	synthLib::Device* VirusProcessor::createDevice()
+	pluginLib::Processor::DeviceFactory VirusProcessor::getDeviceFactory()
 	{
 		synthLib::DeviceCreateParams p;
 		getRemoteDeviceParams(p);
-		return new virusLib::Device(p, true);
+		return [p]() -> synthLib::Device*
+		{
+			return synthLib::PrebootCache::create("virusLib::Device", p, [p]() -> synthLib::Device*
+			{
+				return new virusLib::Device(p, true);
+			});
+		};
 	}
 
 	void VirusProcessor::getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const
@@ -112,8 +119,9 @@ namespace virus
 
 	pluginLib::Controller* VirusProcessor::createController()
 	{
-		// force creation of device as the controller decides how to initialize based on the used ROM
-		getPlugin();
+		// the controller decides how to initialize based on the selected ROM, which is known before the device has
+		// been booted. Its requests are kept until the device is ready
+		beginDeviceBoot();
 
 		return new virus::Controller(*this, m_defaultModel);
 	}
@@ -57,7 +57,7 @@ namespace virus
 	    // _____________
 		//
 	private:
-	    synthLib::Device* createDevice() override;
+	    DeviceFactory getDeviceFactory() override;
 		void getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const override;
 
 	    pluginLib::Controller* createController() override;
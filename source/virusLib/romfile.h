@@ -8,6 +8,8 @@
 
 #include "baseLib/md5.h"
 
+#include "synthLib/romCache.h"
+
 #include "deviceModel.h"
 
 namespace dsp56k
@@ -40,7 +42,7 @@ public:
 
 	using TPreset = std::array<uint8_t, 512>;
 
-	explicit ROMFile(std::vector<uint8_t> _data, std::string _name, DeviceModel _model = DeviceModel::ABC);
+	explicit ROMFile(synthLib::RomImage _data, std::string _name, DeviceModel _model = DeviceModel::ABC);
 
 	static ROMFile invalid();
 
@@ -124,7 +126,7 @@ public:
 
 	std::string getFilename() const { return isValid() ? m_romFileName : std::string(); }
 
-	const auto& getHash() const { return m_romDataHash; }
+	const auto& getHash() const { return m_romFileData.getHash(); }
 
 	const auto& getRomFileData() const { return m_romFileData; }
 
@@ -145,8 +147,7 @@ private:
 	std::vector<uint8_t> m_demoData;
 
 	std::string m_romFileName;
-	std::vector<uint8_t> m_romFileData;
-	baseLib::MD5 m_romDataHash;
+	synthLib::RomImage m_romFileData;
 };
 
 }
@@ -0,0 +1,108 @@
+#include "wAdaptiveWait.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#	include <immintrin.h>
+#	define W_PAUSE() _mm_pause()
+#elif defined(_M_ARM64)
+#	include <intrin.h>
+#	define W_PAUSE() __yield()
+#elif defined(__aarch64__) || defined(__arm__)
+#	define W_PAUSE() __asm__ __volatile__("yield")
+#else
+#	define W_PAUSE() std::this_thread::yield()
+#endif
+
+namespace wLib
+{
+	namespace
+	{
+		uint64_t toNs(const AdaptiveWait::Clock::duration _d)
+		{
+			return static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(_d).count()));
+		}
+
+		template<typename T> void add(std::atomic<T>& _a, const T _v)
+		{
+			// single writer
+			_a.store(_a.load(std::memory_order_relaxed) + _v, std::memory_order_relaxed);
+		}
+	}
+
+	AdaptiveWait::AdaptiveWait()
+	{
+		setConfig(Config());
+
+		m_avgWaitNs = Config().maxSpinNs >> 2;
+		m_spinBudgetNs = m_avgWaitNs << 1;
+		m_spinBudgetNsShared = m_spinBudgetNs;
+	}
+
+	void AdaptiveWait::setConfig(const Config& _config)
+	{
+		m_config.minSpinNs = _config.minSpinNs;
+		m_config.maxSpinNs = std::max(_config.minSpinNs, _config.maxSpinNs);
+		m_config.maxParkUs = std::max(1u, _config.maxParkUs);
+	}
+
+	AdaptiveWait::Config AdaptiveWait::getConfig() const
+	{
+		Config c;
+		c.minSpinNs = m_config.minSpinNs;
+		c.maxSpinNs = m_config.maxSpinNs;
+		c.maxParkUs = m_config.maxParkUs;
+		return c;
+	}
+
+	AdaptiveWait::Stats AdaptiveWait::getStats() const
+	{
+		Stats s;
+		s.waitCount = m_waitCount.load(std::memory_order_relaxed);
+		s.spinHitCount = m_spinHitCount.load(std::memory_order_relaxed);
+		s.parkCount = m_parkCount.load(std::memory_order_relaxed);
+		s.spinNs = m_spinNs.load(std::memory_order_relaxed);
+		s.parkNs = m_parkNs.load(std::memory_order_relaxed);
+		s.spinBudgetNs = m_spinBudgetNsShared.load(std::memory_order_relaxed);
+		return s;
+	}
+
+	void AdaptiveWait::pause()
+	{
+		// a couple of pause instructions between two checks of the condition to reduce the pressure on the cache line
+		// that the other thread writes to, and to give the sibling hyper thread the execution resources
+		for(uint32_t i=0; i<8; ++i)
+			W_PAUSE();
+	}
+
+	void AdaptiveWait::onSpinDone(const Clock::duration _duration, const bool _success)
+	{
+		add(m_waitCount, uint64_t(1));
+		add(m_spinNs, toNs(_duration));
+		if(_success)
+			add(m_spinHitCount, uint64_t(1));
+	}
+
+	void AdaptiveWait::onParkDone(const Clock::duration _duration)
+	{
+		add(m_parkCount, uint64_t(1));
+		add(m_parkNs, toNs(_duration));
+	}
+
+	void AdaptiveWait::adaptBudget(const Clock::duration _waitDuration)
+	{
+		const auto minSpin = m_config.minSpinNs.load(std::memory_order_relaxed);
+		const auto maxSpin = m_config.maxSpinNs.load(std::memory_order_relaxed);
+
+		// Waits that take longer than the maximum spin time would not have benefited from spinning at all, they pull
+		// the budget down. Everything else moves the budget towards twice the average wait time
+		const auto ns = toNs(_waitDuration);
+		const auto sample = ns > maxSpin ? 0 : static_cast<int64_t>(ns);
+
+		m_avgWaitNs = static_cast<uint32_t>(static_cast<int64_t>(m_avgWaitNs) + (sample - static_cast<int64_t>(m_avgWaitNs)) / 8);
+		m_spinBudgetNs = std::clamp(m_avgWaitNs << 1, minSpin, maxSpin);
+
+		m_spinBudgetNsShared.store(m_spinBudgetNs, std::memory_order_relaxed);
+	}
+}
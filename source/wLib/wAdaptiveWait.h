@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace wLib
+{
+	// Waits for a condition that is changed by another thread, first by spinning, then by parking the thread
+	//
+	// The spin phase uses CPU pause instructions and is bounded by a budget that adapts to the duration of recent
+	// waits: short waits are caught while spinning without any wake up latency, long waits park the thread so that
+	// it does not burn CPU. Parked threads are woken by notify(), which is cheap if nobody is parked. A parked thread
+	// re-checks the condition after maxParkTime at the latest, so a missing notification delays but never blocks it.
+	// sleep() waits without a timeout for conditions that are guaranteed to be followed by notify() on every change
+	//
+	// There is one waiting thread, notify() can be called from any thread
+	class AdaptiveWait
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Config
+		{
+			uint32_t minSpinNs = 1000;
+			uint32_t maxSpinNs = 50000;
+			uint32_t maxParkUs = 1000;
+		};
+
+		struct Stats
+		{
+			uint64_t waitCount = 0;		// number of waits that were not satisfied immediately
+			uint64_t spinHitCount = 0;	// waits that were satisfied while spinning
+			uint64_t parkCount = 0;		// number of times the thread has been parked
+			uint64_t spinNs = 0;		// total time spent spinning
+			uint64_t parkNs = 0;		// total time spent parked
+			uint32_t spinBudgetNs = 0;	// current spin budget
+		};
+
+		AdaptiveWait();
+
+		AdaptiveWait(const AdaptiveWait&) = delete;
+		AdaptiveWait(AdaptiveWait&&) = delete;
+		AdaptiveWait& operator = (const AdaptiveWait&) = delete;
+		AdaptiveWait& operator = (AdaptiveWait&&) = delete;
+
+		// spins for the current budget, returns true if the condition became true
+		template<typename TPred> bool spin(const TPred& _ready)
+		{
+			if(_ready())
+				return true;
+
+			const auto budget = std::chrono::nanoseconds(m_spinBudgetNs);
+			const auto start = Clock::now();
+
+			auto now = start;
+			bool ready = false;
+
+			while(now - start < budget)
+			{
+				pause();
+
+				if(_ready())
+				{
+					ready = true;
+					break;
+				}
+
+				now = Clock::now();
+			}
+
+			now = Clock::now();
+			onSpinDone(now - start, ready);
+			return ready;
+		}
+
+		// parks the thread until it is notified or the maximum park time elapsed, unless the condition is true already
+		template<typename TPred> void park(const TPred& _ready)
+		{
+			// announce the waiter before checking the condition. Pairs with the fence in notify(): either notify()
+			// sees the waiter or the waiter sees the new state of the condition
+			m_parked.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const auto start = Clock::now();
+			{
+				std::unique_lock lock(m_mutex);
+				if(!_ready())
+					m_cv.wait_for(lock, std::chrono::microseconds(m_config.maxParkUs.load(std::memory_order_relaxed)));
+			}
+			onParkDone(Clock::now() - start);
+
+			m_parked.fetch_sub(1);
+		}
+
+		// parks the thread until the condition is true, without timeout. Every change of the condition has to be
+		// followed by a call to notify()
+		template<typename TPred> void sleep(const TPred& _ready)
+		{
+			m_parked.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const auto start = Clock::now();
+			{
+				std::unique_lock lock(m_mutex);
+				m_cv.wait(lock, _ready);
+			}
+			onParkDone(Clock::now() - start);
+
+			m_parked.fetch_sub(1);
+		}
+
+		// waits until the condition is true, spins first and parks if the spin budget is exhausted
+		template<typename TPred> void wait(const TPred& _ready)
+		{
+			if(_ready())
+				return;
+
+			const auto start = Clock::now();
+
+			if(!spin(_ready))
+			{
+				do
+				{
+					park(_ready);
+				}
+				while(!_ready());
+			}
+
+			adaptBudget(Clock::now() - start);
+		}
+
+		// wakes a parked thread, cheap if no thread is parked. The state that the condition depends on has to be
+		// stored in atomics and to be written before calling this
+		void notify()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if(m_parked.load() == 0)
+				return;
+
+			// lock to prevent that the notification gets lost if the waiter is between its check and the wait
+			{
+				std::lock_guard lock(m_mutex);
+			}
+			m_cv.notify_all();
+		}
+
+		// thread-safe
+		void setConfig(const Config& _config);
+		Config getConfig() const;
+		Stats getStats() const;
+
+	private:
+		static void pause();
+
+		void onSpinDone(Clock::duration _duration, bool _success);
+		void onParkDone(Clock::duration _duration);
+		void adaptBudget(Clock::duration _waitDuration);
+
+		struct AtomicConfig
+		{
+			std::atomic<uint32_t> minSpinNs;
+			std::atomic<uint32_t> maxSpinNs;
+			std::atomic<uint32_t> maxParkUs;
+		};
+
+		AtomicConfig m_config;
+
+		uint32_t m_spinBudgetNs;
+		uint32_t m_avgWaitNs;
+
+		std::atomic<uint32_t> m_parked{0};
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+
+		// written by the waiting thread only
+		std::atomic<uint64_t> m_waitCount{0};
+		std::atomic<uint64_t> m_spinHitCount{0};
+		std::atomic<uint64_t> m_parkCount{0};
+		std::atomic<uint64_t> m_spinNs{0};
+		std::atomic<uint64_t> m_parkNs{0};
+		std::atomic<uint32_t> m_spinBudgetNsShared{0};
+	};
+}
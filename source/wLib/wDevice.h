@@ -1,7 +1,10 @@
 #pragma once
 
+#include <typeinfo>
+
 #include "synthLib/device.h"
 #include "synthLib/midiBufferParser.h"
+#include "synthLib/prebootCache.h"
 
 namespace dsp56k
 {
@@ -14,6 +17,16 @@ namespace wLib
 	{
 	public:
 		explicit Device(const synthLib::DeviceCreateParams& _params);
+
+		// creates a device of type T, a spare device that has been booted in advance is used if available
+		template<typename T> static synthLib::Device* createPrebooted(const synthLib::DeviceCreateParams& _params)
+		{
+			return synthLib::PrebootCache::create(typeid(T).name(), _params, [_params]() -> synthLib::Device*
+			{
+				return new T(_params);
+			});
+		}
+
 		bool setDspClockPercent(uint32_t _percent) override;
 		uint32_t getDspClockPercent() const override;
 		uint64_t getDspClockHz() const override;
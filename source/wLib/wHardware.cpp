@@ -12,9 +12,11 @@ namespace wLib
 {
 	constexpr uint32_t g_syncEsaiFrameRate = 8;
 	constexpr uint32_t g_syncHaltDspEsaiThreshold = 16;
+	constexpr uint32_t g_lockstepPreEsaiUcInterval = 256;	// lockstep mode: UC instructions per DSP slice until ESAI is running
 
 	static_assert((g_syncEsaiFrameRate & (g_syncEsaiFrameRate - 1)) == 0, "esai frame sync rate must be power of two");
 	static_assert(g_syncHaltDspEsaiThreshold >= g_syncEsaiFrameRate * 2, "esai DSP halt threshold must be greater than two times the sync rate");
+	static_assert((g_lockstepPreEsaiUcInterval & (g_lockstepPreEsaiUcInterval - 1)) == 0, "lockstep UC interval must be power of two");
 
 	Hardware::Hardware(const double& _samplerate) : m_samplerateInv(1.0 / _samplerate)
 	{
@@ -43,28 +45,54 @@ namespace wLib
 
 	void Hardware::ucYieldLoop(const std::function<bool()>& _continue)
 	{
+		if(m_lockstepEnabled)
+		{
+			// nobody else executes the DSPs, do it ourselves until the condition is met
+			lockstepExecUntil([&]
+			{
+				return !_continue() || m_terminateUcThread;
+			});
+			return;
+		}
+
 		const auto dspHalted = m_haltDSP;
 
 		resumeDSP();
 
-		while(_continue() && !m_terminateUcThread)
+		const auto done = [&]
 		{
-			// Spin while the audio thread is actively processing a buffer -
-			// latency here is critical because the audio callback is blocked
-			// on DSP output and any UC sleep delays DSP progress.
-			// Also spin pre-boot (m_esaiFrameIndex == 0), when nothing will
-			// ever notify m_processAudioCv.
-			if(m_processAudio.load(std::memory_order_acquire) || m_esaiFrameIndex == 0)
+			return !_continue() || m_terminateUcThread;
+		};
+
+		while(!done())
+		{
+			if(m_esaiFrameIndex == 0)
 			{
+				// Pre-boot, nothing will ever notify us, keep polling
 				std::this_thread::yield();
 			}
+			else if(m_processAudio.load(std::memory_order_acquire))
+			{
+				// The audio thread is actively processing a buffer - latency
+				// here is critical because the audio callback is blocked on
+				// DSP output and any UC sleep delays DSP progress. Spin for
+				// as long as waits usually take, then park until the next
+				// ESAI frame.
+				m_ucYieldWait.wait(done);
+			}
 			else
 			{
 				// Idle between audio buffers: the DSP is blocked on its
 				// output ring being full, so the UC's wait condition can't
-				// resolve until audio processing resumes. Sleep until then.
-				std::unique_lock uLock(m_processAudioMutex);
-				m_processAudioCv.wait(uLock);
+				// resolve until audio processing resumes. Sleep until then,
+				// without a timeout. Both the next ESAI frame and the start
+				// of audio processing notify us.
+				const uint32_t esaiFrameIndex = m_esaiFrameIndex;
+
+				m_ucYieldWait.sleep([&]
+				{
+					return done() || m_processAudio.load(std::memory_order_acquire) || m_esaiFrameIndex != esaiFrameIndex;
+				});
 			}
 		}
 
@@ -72,21 +100,59 @@ namespace wLib
 			haltDSP();
 	}
 
+	void Hardware::ucYieldToDSP()
+	{
+		if(m_lockstepEnabled)
+			m_lockstep.execSlice();
+		else
+			std::this_thread::yield();
+	}
+
 	void Hardware::requestUcTermination()
 	{
 		m_terminateUcThread = true;
-		m_processAudioCv.notify_all();
+		m_ucYieldWait.notify();
 	}
 
 	void Hardware::beginProcessAudio()
 	{
 		m_processAudio.store(true, std::memory_order_release);
-		m_processAudioCv.notify_all();
+		m_ucYieldWait.notify();
 	}
 
 	void Hardware::endProcessAudio()
 	{
 		m_processAudio.store(false, std::memory_order_release);
+
+		// audio output has been consumed, a DSP may be able to run again
+		notifyLockstep();
+	}
+
+	void Hardware::notifyLockstep()
+	{
+		if(m_lockstepEnabled)
+			m_ucYieldWait.notify();
+	}
+
+	void Hardware::lockstepExecUntil(const std::function<bool()>& _done)
+	{
+		while(!_done())
+		{
+			if(m_lockstep.execSlice())
+				continue;
+
+			// all DSPs are blocked on their audio interfaces, wait for the audio thread to write input or to read output
+			m_ucYieldWait.park([&]
+			{
+				return _done() || m_lockstep.canExec();
+			});
+		}
+	}
+
+	void Hardware::setWaitConfig(const AdaptiveWait::Config& _config)
+	{
+		m_ucYieldWait.setConfig(_config);
+		m_esaiFrameWait.setConfig(_config);
 	}
 
 	void Hardware::sendMidi(const synthLib::SMidiEvent& _ev)
@@ -106,9 +172,9 @@ namespace wLib
 		processMidiInput();
 
 		if((m_esaiFrameIndex & (g_syncEsaiFrameRate-1)) == 0)
-			m_esaiFrameAddedCv.notify_one();
+			m_esaiFrameWait.notify();
 
-		m_processAudioCv.notify_all();
+		m_ucYieldWait.notify();
 
 		m_requestedFramesAvailableMutex.lock();
 
@@ -133,16 +199,30 @@ namespace wLib
 
 		// we can only use ESAI to clock the uc once it has been enabled
 		if(m_esaiFrameIndex <= 0)
+		{
+			// without a clock, lockstep mode interleaves UC and DSPs at a fixed rate
+			if(m_lockstepEnabled && (++m_lockstepUcCounter & (g_lockstepPreEsaiUcInterval-1)) == 0)
+				m_lockstep.execSlice();
 			return;
+		}
 
 		if(m_esaiFrameIndex == m_lastEsaiFrameIndex)
 		{
-			resumeDSP();
-			std::unique_lock uLock(m_esaiFrameAddedMutex);
-			m_esaiFrameAddedCv.wait(uLock, [this]{return m_esaiFrameIndex > m_lastEsaiFrameIndex;});
+			if(m_lockstepEnabled)
+			{
+				lockstepExecUntil([this]
+				{
+					return m_esaiFrameIndex > m_lastEsaiFrameIndex || m_terminateUcThread;
+				});
+			}
+			else
+			{
+				resumeDSP();
+				m_esaiFrameWait.wait([this]{return m_esaiFrameIndex > m_lastEsaiFrameIndex;});
+			}
 		}
 
-		const auto esaiFrameIndex = m_esaiFrameIndex;
+		const uint32_t esaiFrameIndex = m_esaiFrameIndex;
 
 		const auto ucClock = getUc().getSim().getSystemClockHz();
 
@@ -162,13 +242,13 @@ namespace wLib
 		// and consume them
 		m_remainingUcCyclesD -= static_cast<double>(m_remainingUcCycles);
 
-		if(esaiDelta > g_syncHaltDspEsaiThreshold)
-		{
-			haltDSP();
-		}
-		else
+		// in lockstep mode, the DSPs never run ahead of the UC
+		if(!m_lockstepEnabled)
 		{
-			resumeDSP();
+			if(esaiDelta > g_syncHaltDspEsaiThreshold)
+				haltDSP();
+			else
+				resumeDSP();
 		}
 
 		m_lastEsaiFrameIndex = esaiFrameIndex;
@@ -185,8 +265,14 @@ namespace wLib
 			if(e.offset > m_midiOffsetCounter)
 				break;
 
-			getMidi().write(e);
+			// the SCI ring is full, retry later
+			if(!getMidi().write(e))
+				break;
+
 			m_midiIn.pop_front();
 		}
+
+		// forward the MIDI data of this frame to the QSM, sysex is paced and may take longer
+		getMidi().process(1);
 	}
 }
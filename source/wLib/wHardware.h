@@ -4,9 +4,13 @@
 #include <cstdint>
 #include <functional>
 
+#include "wAdaptiveWait.h"
+
 #include "dsp56kBase/ringbuffer.h"
 #include "dsp56kEmu/types.h"
 
+#include "hardwareLib/lockstep.h"
+
 #include "synthLib/midiTypes.h"
 
 namespace hwLib
@@ -40,6 +44,9 @@ namespace wLib
 
 		void ucYieldLoop(const std::function<bool()>& _continue);
 
+		// Lets the DSPs run for a short time without waiting for a condition. Used while the UC polls the DSPs
+		void ucYieldToDSP();
+
 		// Request that any active ucYieldLoop exits immediately.
 		// Used during shutdown so the UC thread can check m_destroy.
 		void requestUcTermination();
@@ -49,6 +56,17 @@ namespace wLib
 
 		uint32_t getEsaiFrameIndex() const { return m_esaiFrameIndex; }
 
+		// tuning and statistics of the UC waiting for the DSP (ucYieldLoop) and for ESAI frames (syncUcToDSP)
+		void setWaitConfig(const AdaptiveWait::Config& _config);
+		AdaptiveWait::Stats getUcYieldWaitStats() const { return m_ucYieldWait.getStats(); }
+		AdaptiveWait::Stats getEsaiFrameWaitStats() const { return m_esaiFrameWait.getStats(); }
+
+		// Lockstep mode: the DSPs do not get threads of their own but are executed by the UC thread in time slices,
+		// interleaved with the UC. Needs to be set before the UC thread is started
+		void setLockstep(bool _lockstep) { m_lockstepEnabled = _lockstep; }
+		bool isLockstep() const { return m_lockstepEnabled; }
+		hwLib::Lockstep& getLockstep() { return m_lockstep; }
+
 	protected:
 		void onEsaiCallback(dsp56k::Audio& _audio);
 		void syncUcToDSP();
@@ -61,9 +79,13 @@ namespace wLib
 		void beginProcessAudio();
 		void endProcessAudio();
 
+		// Lockstep mode: wakes the UC thread if it waits for audio input or for space in the audio output.
+		// Needs to be called after audio input has been written to a DSP
+		void notifyLockstep();
+
 		// timing
 		const double m_samplerateInv;
-		uint32_t m_esaiFrameIndex = 0;
+		std::atomic<uint32_t> m_esaiFrameIndex{0};	// polled by the UC thread while waiting, incremented by the DSP thread
 		uint32_t m_lastEsaiFrameIndex = 0;
 		int64_t m_remainingUcCycles = 0;
 		double m_remainingUcCyclesD = 0;
@@ -74,8 +96,7 @@ namespace wLib
 		std::vector<dsp56k::TWord> m_dummyInput;
 		std::vector<dsp56k::TWord> m_dummyOutput;
 
-		std::mutex m_esaiFrameAddedMutex;
-		dsp56k::ConditionVariable m_esaiFrameAddedCv;
+		AdaptiveWait m_esaiFrameWait;
 
 		std::mutex m_requestedFramesAvailableMutex;
 		dsp56k::ConditionVariable m_requestedFramesAvailableCv;
@@ -85,15 +106,20 @@ namespace wLib
 		dsp56k::ConditionVariable m_haltDSPcv;
 		std::mutex m_haltDSPmutex;
 
-		// Paired with m_processAudioCv/Mutex.  The audio callback flips this
-		// to true for the duration of a buffer; ucYieldLoop uses it to decide
-		// between spinning (audio active → low latency) and sleeping on the
-		// CV (audio idle → save CPU).
+		// The audio callback flips this to true for the duration of a buffer;
+		// ucYieldLoop uses it to decide between spinning first (audio active →
+		// low latency) and parking right away (audio idle → save CPU).
 		std::atomic<bool> m_processAudio{false};
-		std::mutex m_processAudioMutex;
-		dsp56k::ConditionVariable m_processAudioCv;
+		AdaptiveWait m_ucYieldWait;
 
 		bool m_bootCompleted = false;
-		bool m_terminateUcThread = false;
+		std::atomic<bool> m_terminateUcThread{false};
+
+		hwLib::Lockstep m_lockstep;
+		bool m_lockstepEnabled = false;
+		uint32_t m_lockstepUcCounter = 0;
+
+	private:
+		void lockstepExecUntil(const std::function<bool()>& _done);
 	};
 }
@@ -15,21 +15,24 @@ namespace wLib
 		if(_filename.empty())
 			return false;
 
-		if(!baseLib::filesystem::readFile(m_buffer, _filename))
+		std::vector<uint8_t> buffer;
+
+		if(!baseLib::filesystem::readFile(buffer, _filename))
 			return false;
 
-		if(m_buffer.size() != _expectedSize)
+		if(buffer.size() != _expectedSize)
 		{
-			m_buffer.clear();
+			buffer.clear();
 
-			loadFromMidi(m_buffer, _filename);
+			loadFromMidi(buffer, _filename);
 
-			if (!m_buffer.empty() && m_buffer.size() < _expectedSize)
-				m_buffer.resize(_expectedSize, 0xff);
+			if (!buffer.empty() && buffer.size() < _expectedSize)
+				buffer.resize(_expectedSize, 0xff);
 		}
 
-		if(m_buffer.size() != _expectedSize)
+		if(buffer.size() != _expectedSize)
 			return false;
+		m_buffer = synthLib::RomCache::get(std::move(buffer));
 		m_filename = _filename;
 		return true;
 	}
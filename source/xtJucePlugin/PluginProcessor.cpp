@@ -39,8 +39,9 @@ namespace xtJucePlugin
 #endif
 		, getOptions(), pluginLib::initProcessorProperties())
 	{
+		beginDeviceBoot();
 		getController();
-		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(getPlugin().getLatencyBlocks()));
+		const auto latencyBlocks = getConfig().getIntValue("latencyBlocks", static_cast<int>(synthLib::Plugin::DefaultLatencyBlocks));
 		Processor::setLatencyBlocks(latencyBlocks);
 	}
 
@@ -54,11 +55,14 @@ namespace xtJucePlugin
 		return new PluginEditorState(*this);
 	}
 
-	synthLib::Device* AudioPluginAudioProcessor::createDevice()
+	pluginLib::Processor::DeviceFactory AudioPluginAudioProcessor::getDeviceFactory()
 	{
 		synthLib::DeviceCreateParams p;
 		getRemoteDeviceParams(p);
-		return new xt::Device(p);
+		return [p]() -> synthLib::Device*
+		{
+			return wLib::Device::createPrebooted<xt::Device>(p);
+		};
 	}
 
 	void AudioPluginAudioProcessor::getRemoteDeviceParams(synthLib::DeviceCreateParams& _params) const
@@ -10,7 +10,7 @@
 
 namespace xt
 {
-	Xt::Xt(const std::vector<uint8_t>& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/)
+	Xt::Xt(const synthLib::RomImage& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/, const bool _lockstep/* = false*/)
 	{
 		m_hw.reset(new Hardware(_romData, _romName, _voiceExpansion));
 
@@ -19,6 +19,8 @@ namespace xt
 
 		m_midiOutBuffer.reserve(1024);
 
+		m_hw->setLockstep(_lockstep);
+
 		m_ucThread.reset(new std::thread([&]()
 		{
 			dsp56k::ThreadTools::setCurrentThreadPriority(dsp56k::ThreadPriority::Highest);
@@ -51,6 +53,9 @@ namespace xt
 
 		m_destroy = true;
 
+		// Break any active ucYieldLoop so the UC thread can check m_destroy
+		m_hw->requestUcTermination();
+
 		// DSP needs to run to let the uc thread wake up
 		const auto& esai = m_hw->getDSP(m_hw->getMainDspIdx()).getPeriph().getEssi0();
 		while(m_destroy)
@@ -92,10 +97,7 @@ namespace xt
 		const auto& dspOuts = m_hw->getAudioOutputs();
 
 		for(size_t c=0; c<dspOuts.size(); ++c)
-		{
-			for(uint32_t i=0; i<_frames; ++i)
-				_outputs[c][i] = dsp56k::dsp2sample<float>(dspOuts[c][i]);
-		}
+			m_dac.processBlock(_outputs[c], dspOuts[c].data(), _frames);
 	}
 
 	void Xt::process(uint32_t _frames, uint32_t _latency)
@@ -11,6 +11,9 @@
 #include "xtLeds.h"
 #include "xtTypes.h"
 
+#include "synthLib/dac.h"
+#include "synthLib/romCache.h"
+
 namespace synthLib
 {
 	struct SMidiEvent;
@@ -30,7 +33,8 @@ namespace xt
 			Lcd			= 0x02,
 		};
 
-		Xt(const std::vector<uint8_t>& _romData, const std::string& _romName, bool _voiceExpansion = false);
+		// _lockstep: the DSPs are executed by the microcontroller thread instead of running on threads of their own
+		Xt(const synthLib::RomImage& _romData, const std::string& _romName, bool _voiceExpansion = false, bool _lockstep = false);
 		~Xt();
 
 		bool isValid() const;
@@ -70,5 +74,7 @@ namespace xt
 		std::unique_ptr<std::thread> m_ucThread;
 		bool m_destroy = false;
 		std::atomic<uint32_t> m_dirtyFlags = 0;
+
+		synthLib::Dac m_dac;
 	};
 }
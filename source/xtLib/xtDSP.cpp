@@ -134,6 +134,13 @@ namespace xt
 			hdiTransferUCtoDSP(_word);
 		});
 
+		// in lockstep mode, the UC thread executes the DSP
+		if(m_hardware.isLockstep())
+		{
+			m_lockstepRunning = true;
+			return;
+		}
+
 #if DSP56300_DEBUGGER
 		m_thread.reset(new dsp56k::DSPThread(dsp(), m_name.c_str(), std::make_shared<dsp56kDebugger::Debugger>(m_dsp)));
 #else
@@ -143,6 +150,27 @@ namespace xt
 		m_thread->setLogToStdout(false);
 	}
 
+	bool DSP::canExecLockstep()
+	{
+		if(!m_lockstepRunning)
+			return false;
+
+		// until the first ESSI frame has been produced, the firmware is still initializing, see mqLib::MqDsp
+		if(m_hardware.getEsaiFrameIndex() == 0)
+			return true;
+
+		const auto canExec = [](auto& _essi)
+		{
+			if(_essi.hasEnabledReceivers() && _essi.getAudioInputs().empty())
+				return false;
+			if(_essi.hasEnabledTransmitters() && _essi.getAudioOutputs().full())
+				return false;
+			return true;
+		};
+
+		return canExec(m_periphX.getEssi0()) && canExec(m_periphX.getEssi1());
+	}
+
 	void DSP::onUCRxEmpty(bool _needMoreData)
 	{
 		hdi08().injectTXInterrupt();
@@ -53,6 +53,9 @@ namespace xt
 		bool haveSentTXToDSP() const { return m_haveSentTXtoDSP; }
 		void onDspBooted();
 
+		// lockstep mode: true if the DSP has booted and can process an audio frame without blocking
+		bool canExecLockstep();
+
 	private:
 		void onUCRxEmpty(bool _needMoreData);
 		void hdiTransferUCtoDSP(dsp56k::TWord _word);
@@ -74,6 +77,7 @@ namespace xt
 		uint32_t m_hdiHF01 = 0;	// uc => DSP
 
 		std::unique_ptr<dsp56k::DSPThread> m_thread;
+		bool m_lockstepRunning = false;
 		dsp56k::DspBoot m_boot;
 	};
 }
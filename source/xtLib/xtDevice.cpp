@@ -11,7 +11,7 @@ namespace xt
 {
 	Device::Device(const synthLib::DeviceCreateParams& _params)
 		: wLib::Device(_params)
-		, m_xt(_params.romData, _params.romName, (_params.customData & 1) != 0)
+		, m_xt(_params.romData, _params.romName, (_params.customData & 1) != 0, (_params.customData & 2) != 0)
 		, m_wavePreview(m_xt), m_state(m_xt, m_wavePreview), m_sysexRemote(m_xt)
 	{
 		while(!m_xt.isBootCompleted())
@@ -9,14 +9,14 @@
 
 namespace xt
 {
-	Rom initializeRom(const std::vector<uint8_t>& _romData, const std::string& _romName)
+	Rom initializeRom(const synthLib::RomImage& _romData, const std::string& _romName)
 	{
 		if(_romData.empty())
 			return RomLoader::findROM();
 		return Rom{_romName, _romData};
 	}
 
-	Hardware::Hardware(const std::vector<uint8_t>& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/)
+	Hardware::Hardware(const synthLib::RomImage& _romData, const std::string& _romName, const bool _voiceExpansion/* = false*/)
 		: wLib::Hardware(40000)
 		, m_rom(initializeRom(_romData, _romName))
 		, m_useVoiceExpansion(_voiceExpansion)
@@ -35,11 +35,19 @@ namespace xt
 			m_dsps.push_back(std::make_unique<DSP>(*this, m_uc.getHdi08B().getHdi08(), 0, true));
 			m_dsps.push_back(std::make_unique<DSP>(*this, m_uc.getHdi08C().getHdi08(), 1, true));
 			m_dsps.push_back(std::make_unique<DSP>(*this, m_uc.getHdi08A().getHdi08(), 2, true));
+
+			setupVoiceExpansionRouting();
 		}
 		else
 		{
 			m_dsps.push_back(std::make_unique<DSP>(*this, m_uc.getHdi08A().getHdi08(), 0));
 		}
+
+		for (auto& dsp : m_dsps)
+		{
+			auto* d = dsp.get();
+			m_lockstep.addUnit([d] { d->dsp().exec(); }, [d] { return d->canExecLockstep(); });
+		}
 	}
 
 	Hardware::~Hardware()
@@ -97,63 +105,23 @@ namespace xt
 		}
 
 		const auto mainDspIdx = getMainDspIdx();
-
-		// During boot, set empty callbacks on all ESSI interfaces to prevent DSP threads from blocking
-		for (uint32_t i = 0; i < 3; ++i)
-		{
-			m_dsps[i]->getPeriph().getEssi0().setCallback([](dsp56k::Audio*) {});
-			m_dsps[i]->getPeriph().getEssi1().setCallback([](dsp56k::Audio*) {});
-		}
-
-		// Boot pump loop: DSPs sync via ESSI1 ring (DSP2 TX→DSP0 RX→DSP0 TX→DSP1 RX→DSP1 TX→DSP2 RX).
-		// DSP2 (exp3, idx 2) sends magic $535400 on ESSI1 TX, DSP0/DSP1 echo it forward.
-		// We must route ESSI1 data between DSPs for the sync handshake to complete.
 		auto& mainEssi0 = m_dsps[mainDspIdx]->getPeriph().getEssi0();
 
-		// ESSI1 ring connections: [from].TX → [to].RX
-		constexpr uint32_t essi1From[] = {2, 0, 1};  // TX source DSP index
-		constexpr uint32_t essi1To[]   = {0, 1, 2};  // RX destination DSP index
-
-		while (mainEssi0.getAudioOutputs().empty())
+		// Boot is complete once the main DSP outputs audio. ESSI data is routed by
+		// the callbacks installed in the constructor, they notify us when the main
+		// DSP produced its first frame, there is nothing to do for us in the meantime
 		{
-			// Route ESSI1 data around the ring
-			for (int leg = 0; leg < 3; ++leg)
-			{
-				auto& txOut = m_dsps[essi1From[leg]]->getPeriph().getEssi1().getAudioOutputs();
-				auto& rxIn  = m_dsps[essi1To[leg]]->getPeriph().getEssi1().getAudioInputs();
+			std::unique_lock lock(m_veBootMutex);
 
-				while (!txOut.empty() && !rxIn.full())
-				{
-					dsp56k::Audio::RxFrame rx;
-					txToRx(txOut.pop_front(), rx);
-					rxIn.push_back(std::move(rx));
-				}
-			}
-
-			// Feed ESSI0 inputs (DSP0 uses ESSI0 RX for external audio, feed silence)
-			for (uint32_t i = 0; i < 3; ++i)
-			{
-				auto& in0 = m_dsps[i]->getPeriph().getEssi0().getAudioInputs();
-				if (in0.empty())
-					in0.push_back({});
-			}
-
-			// Drain ESSI0 outputs from non-main DSPs to prevent overflow
-			for (uint32_t i = 0; i < 3; ++i)
-			{
-				if (i != mainDspIdx)
-				{
-					auto& out0 = m_dsps[i]->getPeriph().getEssi0().getAudioOutputs();
-					while (out0.size() > 32)
-						out0.pop_front();
-				}
-			}
-
-			std::this_thread::yield();
+			while (!m_veBootCv.wait_for(lock, std::chrono::seconds(5), [&] { return !mainEssi0.getAudioOutputs().empty(); }))
+				LOG("Voice Expansion boot still in progress, main DSP index " << mainDspIdx);
 		}
 
 		LOG("Voice Expansion boot completed, main DSP index " << mainDspIdx);
 
+		// From now on, the ESSI1 routing callbacks keep frames that do not fit and the ESSI0 boot callbacks do nothing
+		m_voiceExpansionReady = true;
+
 		// Prime each DSP with minimal input to prevent blocking, then drain outputs
 		for (auto& dsp : m_dsps)
 		{
@@ -171,26 +139,80 @@ namespace xt
 			m_bootCompleted = true;
 			onEsaiCallback(mainEssi0);
 		});
+	}
+
+	void Hardware::setupVoiceExpansionRouting()
+	{
+		const auto mainDspIdx = getMainDspIdx();
 
-		// Real-time ESSI1 ring routing via TX callbacks.
+		// DSPs sync via ESSI1 ring (DSP2 TX→DSP0 RX→DSP0 TX→DSP1 RX→DSP1 TX→DSP2 RX).
+		// DSP2 (exp3, idx 2) sends magic $535400 on ESSI1 TX, DSP0/DSP1 echo it forward.
+		// ESSI1 data is routed around the ring via TX callbacks from the very first frame
+		// on, the sync handshake during boot depends on it.
+		//
+		// During boot, DSPs start one after another. A frame for a DSP that does not
+		// consume its input yet is dropped, otherwise the TX ring of the sender fills
+		// up and the sender blocks.
 		constexpr uint32_t essi1RxDst[] = {1, 2, 0};  // DSP[i] TX routes to DSP[essi1RxDst[i]] RX
 		for (uint32_t i = 0; i < getDspCount(); ++i)
 		{
 			auto& srcEssi1 = m_dsps[i]->getPeriph().getEssi1();
 			auto& dstEssi1 = m_dsps[essi1RxDst[i]]->getPeriph().getEssi1();
 
-			srcEssi1.setCallback([&srcEssi1, &dstEssi1](dsp56k::Audio*)
+			srcEssi1.setCallback([this, &srcEssi1, &dstEssi1](dsp56k::Audio*)
 			{
 				auto& txOut = srcEssi1.getAudioOutputs();
 				auto& rxIn = dstEssi1.getAudioInputs();
-				while (!txOut.empty() && !rxIn.full())
+				while (!txOut.empty())
 				{
+					if (rxIn.full())
+					{
+						if (m_voiceExpansionReady)
+							break;
+						txOut.pop_front();
+						continue;
+					}
+
 					dsp56k::Audio::RxFrame rx;
 					txToRx(txOut.pop_front(), rx);
 					rxIn.push_back(std::move(rx));
 				}
 			});
 		}
+
+		// During boot, feed silence to the ESSI0 inputs (DSP0 uses ESSI0 RX for external
+		// audio) and drain ESSI0 outputs of non-main DSPs to prevent overflow. The main
+		// DSP notifies us once it outputs audio, which completes the boot
+		for (uint32_t i = 0; i < getDspCount(); ++i)
+		{
+			auto& essi0 = m_dsps[i]->getPeriph().getEssi0();
+			const bool isMain = i == mainDspIdx;
+
+			essi0.setCallback([this, &essi0, isMain](dsp56k::Audio*)
+			{
+				if (m_voiceExpansionReady)
+					return;
+
+				auto& in0 = essi0.getAudioInputs();
+				while (in0.size() < 2)
+					in0.push_back({});
+
+				auto& out0 = essi0.getAudioOutputs();
+
+				if (!isMain)
+				{
+					while (out0.size() > 32)
+						out0.pop_front();
+				}
+				else if (!out0.empty())
+				{
+					{
+						std::lock_guard lock(m_veBootMutex);
+					}
+					m_veBootCv.notify_all();
+				}
+			});
+		}
 	}
 
 	void Hardware::setupEsaiListener()
@@ -240,8 +262,6 @@ namespace xt
 		if(m_esaiFrameIndex == 0)
 			return;
 
-		m_midi.process(_frames);
-
 		beginProcessAudio();
 
 		// DSP3 (index 1) outputs final audio on ESSI0, single DSP uses index 0
@@ -329,6 +349,8 @@ namespace xt
 				essiMain.processAudioInputInterleaved(inputs, processCount, _latency);
 			}
 
+			notifyLockstep();
+
 			const auto requiredSize = processCount > 8 ? processCount - 8 : 0;
 
 			if(essiMain.getAudioOutputs().size() < requiredSize)
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "xtBuildconfig.h"
@@ -22,7 +25,7 @@ namespace xt
 	class Hardware : public wLib::Hardware
 	{
 	public:
-		explicit Hardware(const std::vector<uint8_t>& _romData, const std::string& _romName, bool _voiceExpansion = false);
+		explicit Hardware(const synthLib::RomImage& _romData, const std::string& _romName, bool _voiceExpansion = false);
 		~Hardware() override;
 
 		void process();
@@ -68,6 +71,7 @@ namespace xt
 
 	private:
 		void setupEsaiListener();
+		void setupVoiceExpansionRouting();
 		void processUcCycle();
 
 		const Rom m_rom;
@@ -78,5 +82,9 @@ namespace xt
 		TAudioOutputs m_audioOutputs;
 		std::vector<std::unique_ptr<DSP>> m_dsps;
 		SciMidi m_midi;
+
+		std::atomic<bool> m_voiceExpansionReady{false};
+		std::mutex m_veBootMutex;
+		std::condition_variable m_veBootCv;
 	};
 }
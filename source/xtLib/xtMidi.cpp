@@ -8,12 +8,12 @@ namespace xt
 	{
 	}
 
-	void SciMidi::write(const synthLib::SMidiEvent& _e)
+	bool SciMidi::write(const synthLib::SMidiEvent& _e)
 	{
 		if (m_romWaves.receiveSysEx(m_results, _e.sysex))
-			return;
+			return true;
 
-		hwLib::SciMidi::write(_e);
+		return hwLib::SciMidi::write(_e);
 	}
 
 	void SciMidi::read(std::vector<uint8_t>& _result)
@@ -12,7 +12,7 @@ namespace xt
 	public:
 		SciMidi(XtUc& _uc);
 
-		void write(const synthLib::SMidiEvent& _e) override;
+		bool write(const synthLib::SMidiEvent& _e) override;
 		void read(std::vector<uint8_t>& _result) override;
 
 	private: